@@ -0,0 +1,73 @@
+#include <vector>
+#include "arena.h"
+#include "bench.h"
+#include "random.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const BoardSize kboard = {1024, 1024};
+static const long long kbatch_snake_ticks = 200000; // Snake ticks per batch, split between however many snakes there are
+static const int kwarm_up_ticks = 200; // Ticks played before measuring so the snakes have grown and are spread out
+static const int krandom_turn_odds = 16; // A bot turns at random once every this many ticks on average
+
+// Turns a bot aside when the square ahead is off the board or taken, and now and then at random
+static void steer(Arena& arena, int snake, Random& random) {
+	static const int kdx[4] = {0, 0, 1, -1};
+	static const int kdy[4] = {-1, 1, 0, 0};
+	const OccupancyGrid& occupancy = arena.getOccupancy();
+	Cell head = arena.getHead(snake);
+	int direction = arena.getDirection(snake);
+	Cell ahead = Cell{head.x + kdx[direction], head.y + kdy[direction]};
+	bool blocked = !occupancy.inBounds(ahead) || occupancy.count(ahead) > 0;
+	if (!blocked && random.below(krandom_turn_odds) != 0) {
+		return;
+	}
+
+	// The two directions on the other axis, UP and DOWN are 0 and 1
+	int first = direction < 2 ? 2 : 0;
+	int side = first + random.below(2);
+	for (int i = 0; i < 2; i++, side = first + (side - first + 1) % 2) {
+		Cell next = Cell{head.x + kdx[side], head.y + kdy[side]};
+		if (occupancy.inBounds(next) && occupancy.count(next) == 0) {
+			arena.queueTurn(snake, static_cast<SnakeDirection>(side));
+			return;
+		}
+	}
+}
+
+// Steers every living bot and respawns the dead ones so the number of snakes stays the same
+static void play(Arena& arena, Random& random) {
+	for (int snake = 0; snake < arena.getSnakeCount(); snake++) {
+		if (arena.isAlive(snake)) {
+			steer(arena, snake, random);
+		} else {
+			arena.respawn(snake);
+		}
+	}
+	arena.tick();
+}
+
+// n bot snakes share a 1024x1024 board with as many food items. One operation is one snake advancing one tick,
+// so n * ns_per_op is the time a whole tick of the arena takes, bots included
+void registerArenaBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sizes = decades(10000);
+
+	benchmarks.push_back(Benchmark{"arena/tick", sizes, [](long long n, Stopwatch& stopwatch) {
+		Arena arena(kboard, static_cast<int>(n), static_cast<int>(n), 1);
+		Random random(2);
+		for (int i = 0; i < kwarm_up_ticks; i++) {
+			play(arena, random);
+		}
+		long long ticks = kbatch_snake_ticks / n + 1;
+		stopwatch.start();
+		for (long long t = 0; t < ticks; t++) {
+			play(arena, random);
+		}
+		stopwatch.stop();
+		return ticks * n;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
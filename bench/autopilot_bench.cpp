@@ -0,0 +1,113 @@
+#include <map>
+#include <memory>
+#include <vector>
+#include "autopilot.h"
+#include "bench.h"
+#include "flat_state.h"
+#include "simulation.h"
+#include "snake.h"
+#include "SnakeFood.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const int ksquare_pixels = 20; // Pixel size the saved games claim their squares had, only used to fill the header
+static const long long kbatch_squares = 1 << 22; // Board squares per batch, split into plans so big boards get fewer
+static const int klength_board_side = 256; // Board the plan_length benchmark grows its snakes on
+
+// Steers the snake back and forth across a board columns wide, moving down a row at each edge
+static void steer(Snake& snake, int columns) {
+	int x = snake.getHeadCell().x;
+	SnakeDirection direction = snake.getDirection();
+	if ((direction == RIGHT && x == columns - 1) || (direction == LEFT && x == 0)) {
+		snake.setDirection(DOWN);
+	} else if (direction == DOWN) {
+		snake.setDirection(x == 0 ? RIGHT : LEFT);
+	}
+}
+
+/*
+A game on a side x side board whose snake is length segments long, zigzagged across the board so the food is
+usually on the far side of the body. Simulation only plays on boards 50 squares wide, so the game is put together
+from a grown snake and food through a flat save. Games are kept for later batches of the same size
+*/
+static const Simulation& gameOf(int side, long long length) {
+	static std::map<std::pair<int, long long>, std::unique_ptr<Simulation>> games;
+	std::unique_ptr<Simulation>& game = games[std::make_pair(side, length)];
+	if (!game) {
+		BoardSize board = {side, side};
+		Snake snake(board);
+		for (long long i = 1; i < length; i++) {
+			steer(snake, side);
+			snake.eatFood(Color(static_cast<unsigned char>(i), 0, 0));
+			snake.update();
+		}
+		SnakeFood food(snake.getOccupancy(), 1);
+
+		FlatWriter out;
+		out.header().board_width = side * ksquare_pixels;
+		out.header().board_height = side * ksquare_pixels;
+		out.header().seed = static_cast<uint32_t>(side);
+		snake.writeFlat(out);
+		food.writeFlat(out);
+		std::vector<uint8_t> bytes;
+		out.copyTo(bytes);
+
+		FlatGameView saved;
+		saved.view(bytes.data(), bytes.size());
+		game.reset(new Simulation(side * ksquare_pixels, side * ksquare_pixels, 1));
+		game->readFlat(saved);
+	}
+	return *game;
+}
+
+/*
+Plays the game with the autopilot steering and times only its plan() calls, one operation is one plan so
+1e9 / ns_per_op is plans per second. A game that ends starts over from the same position. With from_scratch the
+autopilot forgets everything before each plan, so it searches the board from the body every tick
+*/
+static long long playPlans(const Simulation& start, Stopwatch& stopwatch, bool from_scratch) {
+	BoardSize board = start.getBoardSize();
+	long long squares = static_cast<long long>(board.columns) * board.rows;
+	long long plans = kbatch_squares / squares + 16;
+	Simulation game = start;
+	Autopilot autopilot;
+	for (long long i = 0; i < plans; i++) {
+		if (from_scratch) {
+			autopilot.forget();
+		}
+		stopwatch.start();
+		SnakeDirection direction = autopilot.plan(game);
+		stopwatch.stop();
+		game.queueTurn(direction);
+		if (game.tick()) {
+			game = start;
+		}
+	}
+	doNotOptimize(autopilot.getSearches());
+	return plans;
+}
+
+// plan and plan_scratch run on square boards of 16x16 to 1024x1024 with the snake covering a quarter of the board,
+// plan_length on a 256x256 board with snakes of 10 to 10,000 segments. Compare plan with plan_scratch for what
+// keeping the search state between ticks saves
+void registerAutopilotBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sides = {16, 32, 64, 128, 256, 512, 1024};
+
+	benchmarks.push_back(Benchmark{"autopilot/plan", sides, [](long long n, Stopwatch& stopwatch) {
+		int side = static_cast<int>(n);
+		return playPlans(gameOf(side, n * n / 4), stopwatch, false);
+	}});
+
+	benchmarks.push_back(Benchmark{"autopilot/plan_scratch", sides, [](long long n, Stopwatch& stopwatch) {
+		int side = static_cast<int>(n);
+		return playPlans(gameOf(side, n * n / 4), stopwatch, true);
+	}});
+
+	benchmarks.push_back(Benchmark{"autopilot/plan_length", decades(10000), [](long long n, Stopwatch& stopwatch) {
+		return playPlans(gameOf(klength_board_side, n), stopwatch, false);
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
@@ -0,0 +1,87 @@
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "bench.h"
+#include "batch_simulation.h"
+#include "simulation.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const long long kgame_ticks = 100000; // Game ticks per batch, split between however many games are running
+static const int kboard_width = 640;
+static const int kboard_height = 480;
+
+// Both benchmarks measure one game advancing one tick, so ns_per_op is directly comparable and 1e9 / ns_per_op is
+// game ticks per second on one core. Games that end are restarted straight away so every game keeps running.
+void registerBatchBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sizes = decades(10000);
+
+	benchmarks.push_back(Benchmark{"batch/tick", sizes, [](long long n, Stopwatch& stopwatch) {
+		int games = static_cast<int>(n);
+		BatchSimulation batch(games, kboard_width, kboard_height, 1);
+		long long ticks = kgame_ticks / n + 1;
+		stopwatch.start();
+		for (long long t = 0; t < ticks; t++) {
+			for (int game = 0; game < games; game++) {
+				batch.queueTurn(game, towardsFood(batch.getHead(game), batch.getFood(game)));
+			}
+			if (batch.tick() > 0) {
+				for (int game = 0; game < games; game++) {
+					if (!batch.isAlive(game)) {
+						batch.reset(game);
+					}
+				}
+			}
+		}
+		stopwatch.stop();
+		return ticks * n;
+	}});
+
+	// The same games stepped one Simulation at a time, for comparison
+	benchmarks.push_back(Benchmark{"simulation/tick", sizes, [](long long n, Stopwatch& stopwatch) {
+		std::vector<std::unique_ptr<Simulation>> simulations;
+		for (long long i = 0; i < n; i++) {
+			simulations.emplace_back(new Simulation(kboard_width, kboard_height, static_cast<uint32_t>(1 + i)));
+		}
+		long long ticks = kgame_ticks / n + 1;
+		uint32_t next_seed = static_cast<uint32_t>(n + 1);
+		stopwatch.start();
+		for (long long t = 0; t < ticks; t++) {
+			for (std::unique_ptr<Simulation>& simulation : simulations) {
+				simulation->queueTurn(towardsFood(simulation->getSnake().getHeadCell(), simulation->getFood().getCell()));
+				if (simulation->tick()) {
+					simulation->reset(next_seed++);
+				}
+			}
+		}
+		stopwatch.stop();
+		return ticks * n;
+	}});
+
+	// One Simulation playing game after game, restarting in place, the way the app runs for weeks. The same games are
+	// played once to warm up and again while measured. tests/allocation_test.cpp checks the same loop never allocates
+	benchmarks.push_back(Benchmark{"simulation/steady_state", std::vector<long long>{1}, [](long long, Stopwatch& stopwatch) {
+		Simulation game(kboard_width, kboard_height, 1);
+		for (int pass = 0; pass < 2; pass++) {
+			game.reset(1);
+			uint32_t next_seed = 2;
+			if (pass == 1) {
+				stopwatch.start();
+			}
+			for (long long t = 0; t < kgame_ticks; t++) {
+				game.queueTurn(towardsFood(game.getSnake().getHeadCell(), game.getFood().getCell()));
+				if (game.tick()) {
+					game.reset(next_seed++);
+				}
+			}
+			if (pass == 1) {
+				stopwatch.stop();
+			}
+		}
+		return kgame_ticks;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
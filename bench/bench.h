@@ -0,0 +1,83 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include "game_types.h"
+#include "occupancy_grid.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+/*
+Minimal benchmark harness. A benchmark is a function that sets up its own state for a problem size n,
+runs some number of operations while a Stopwatch is running and reports how many it ran.
+The harness keeps calling it until enough time has been measured and reports the time per operation.
+*/
+
+// Accumulates time only while started, so set up work between start() and stop() calls is not measured
+class Stopwatch {
+private:
+	std::chrono::steady_clock::time_point started_;
+	double elapsed_ns_ = 0;
+
+public:
+	void start() { started_ = std::chrono::steady_clock::now(); }
+	void stop() {
+		elapsed_ns_ += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started_).count();
+	}
+	void add(double ns) { elapsed_ns_ += ns; } // Counts time measured some other way, e.g. on another thread
+	double elapsedNs() const { return elapsed_ns_; }
+};
+
+// Runs one batch of a benchmark at size n, timing only the measured part with the stopwatch, returns the operations run
+typedef std::function<long long(long long n, Stopwatch& stopwatch)> BenchmarkBody;
+
+struct Benchmark {
+	std::string name; // group/operation, e.g. linked_list/push_back
+	std::vector<long long> sizes; // Problem sizes to run at
+	BenchmarkBody body;
+};
+
+struct BenchmarkResult {
+	std::string name;
+	long long n;
+	long long operations; // Total operations measured
+	double ns_per_op; // 0 when no operation ran, printed as an empty field (null in JSON)
+};
+
+// Problem sizes 10, 100, ... up to max_n
+std::vector<long long> decades(long long max_n);
+
+// Benchmarks are grouped by the code they exercise, each group adds itself to the list
+void registerLinkedListBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerSnakeBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerBatchBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerRunnerBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerReplayBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerLeaderboardBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerProfilerBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerRenderBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerThreadBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerArenaBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerServerBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerSaveBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerAutopilotBenchmarks(std::vector<Benchmark>& benchmarks);
+void registerBoardBenchmarks(std::vector<Benchmark>& benchmarks);
+
+// Heads for the food along one axis at a time, a cheap policy that keeps games going long enough to grow
+inline SnakeDirection towardsFood(Cell head, Cell food) {
+	if (food.x != head.x) {
+		return food.x > head.x ? RIGHT : LEFT;
+	}
+	return food.y > head.y ? DOWN : UP;
+}
+
+// Prevents the compiler from optimizing away a value that is otherwise unused
+template<typename T>
+inline void doNotOptimize(const T& value) {
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
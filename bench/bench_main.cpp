@@ -0,0 +1,156 @@
+/*
+Snake microbenchmarks
+
+Build and run on Linux (see Makefile):
+	make -C bench
+	./bench/snake_bench --format=json > results.json
+
+Options:
+	--format=csv|json   Output format, csv by default
+	--filter=TEXT       Only run benchmarks whose name contains TEXT
+	--max-n=N           Largest problem size to run, 1000000 by default
+	--min-time-ms=T     Measure each benchmark for at least T milliseconds, 50 by default
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bench.h"
+
+using namespace snakelinkedlist::bench;
+
+namespace snakelinkedlist {
+namespace bench {
+
+std::vector<long long> decades(long long max_n) {
+	std::vector<long long> sizes;
+	for (long long n = 10; n <= max_n; n *= 10) {
+		sizes.push_back(n);
+	}
+	return sizes;
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
+
+/*
+Keeps running batches until min_time_ns has been measured, the first batch doubles as a warm up.
+Benchmarks that measure something much shorter than their batches (e.g. how late ticks run) also stop after
+kmax_wall_factor times min_time_ns of real time, so they finish however little they measure
+*/
+static BenchmarkResult measure(const Benchmark& benchmark, long long n, double min_time_ns) {
+	const double kmax_wall_factor = 10;
+	Stopwatch warm_up;
+	benchmark.body(n, warm_up);
+
+	Stopwatch stopwatch;
+	Stopwatch wall;
+	long long operations = 0;
+	while (stopwatch.elapsedNs() < min_time_ns && wall.elapsedNs() < min_time_ns * kmax_wall_factor) {
+		wall.start();
+		operations += benchmark.body(n, stopwatch);
+		wall.stop();
+	}
+
+	BenchmarkResult result;
+	result.name = benchmark.name;
+	result.n = n;
+	result.operations = operations;
+	result.ns_per_op = operations > 0 ? stopwatch.elapsedNs() / operations : 0;
+	return result;
+}
+
+static void printCsvHeader() {
+	printf("name,n,operations,ns_per_op\n");
+}
+
+// A benchmark that ran no operation has no time per operation, the field is left empty rather than inf or nan
+static void printCsv(const BenchmarkResult& result) {
+	if (result.operations > 0) {
+		printf("%s,%lld,%lld,%.3f\n", result.name.c_str(), result.n, result.operations, result.ns_per_op);
+	} else {
+		printf("%s,%lld,0,\n", result.name.c_str(), result.n);
+	}
+	fflush(stdout);
+}
+
+static void printJson(const std::vector<BenchmarkResult>& results) {
+	printf("{\n  \"benchmarks\": [\n");
+	for (size_t i = 0; i < results.size(); i++) {
+		const char* separator = (i + 1 < results.size()) ? "," : "";
+		if (results[i].operations > 0) {
+			printf("    {\"name\": \"%s\", \"n\": %lld, \"operations\": %lld, \"ns_per_op\": %.3f}%s\n",
+				results[i].name.c_str(), results[i].n, results[i].operations, results[i].ns_per_op, separator);
+		} else {
+			printf("    {\"name\": \"%s\", \"n\": %lld, \"operations\": 0, \"ns_per_op\": null}%s\n",
+				results[i].name.c_str(), results[i].n, separator);
+		}
+	}
+	printf("  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+	bool json = false;
+	std::string filter;
+	long long max_n = 1000000;
+	double min_time_ns = 50e6;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--format=json") == 0) {
+			json = true;
+		} else if (strcmp(argv[i], "--format=csv") == 0) {
+			json = false;
+		} else if (strncmp(argv[i], "--filter=", 9) == 0) {
+			filter = argv[i] + 9;
+		} else if (strncmp(argv[i], "--max-n=", 8) == 0) {
+			max_n = atoll(argv[i] + 8);
+		} else if (strncmp(argv[i], "--min-time-ms=", 14) == 0) {
+			min_time_ns = atof(argv[i] + 14) * 1e6;
+		} else {
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	std::vector<Benchmark> benchmarks;
+	registerLinkedListBenchmarks(benchmarks);
+	registerSnakeBenchmarks(benchmarks);
+	registerBatchBenchmarks(benchmarks);
+	registerRunnerBenchmarks(benchmarks);
+	registerReplayBenchmarks(benchmarks);
+	registerLeaderboardBenchmarks(benchmarks);
+	registerProfilerBenchmarks(benchmarks);
+	registerRenderBenchmarks(benchmarks);
+	registerThreadBenchmarks(benchmarks);
+	registerArenaBenchmarks(benchmarks);
+	registerServerBenchmarks(benchmarks);
+	registerSaveBenchmarks(benchmarks);
+	registerAutopilotBenchmarks(benchmarks);
+	registerBoardBenchmarks(benchmarks);
+
+	// CSV rows are printed as they finish so long runs show progress, JSON is printed once at the end
+	if (!json) {
+		printCsvHeader();
+	}
+	std::vector<BenchmarkResult> results;
+	for (const Benchmark& benchmark : benchmarks) {
+		if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+			continue;
+		}
+		for (long long n : benchmark.sizes) {
+			if (n > max_n) {
+				continue;
+			}
+			BenchmarkResult result = measure(benchmark, n, min_time_ns);
+			results.push_back(result);
+			if (!json) {
+				printCsv(result);
+			}
+		}
+	}
+	if (json) {
+		printJson(results);
+	}
+	return 0;
+}
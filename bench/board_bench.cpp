@@ -0,0 +1,120 @@
+#include <vector>
+#include "bench.h"
+#include "board.h"
+#include "random.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const int kfill_percent = 25; // Share of the squares taken, at random
+static const long long kbatch_squares = 1 << 22; // Board squares per batch, split into flood fills so big boards get fewer
+
+// A side x side grid with kfill_percent of its squares taken, the same for every board of that size
+static OccupancyGrid gridOf(int side) {
+	OccupancyGrid grid;
+	grid.reset(side, side);
+	Random random(static_cast<uint32_t>(side));
+	for (int y = 0; y < side; y++) {
+		for (int x = 0; x < side; x++) {
+			if (random.below(100) < kfill_percent) {
+				grid.add(Cell{x, y});
+			}
+		}
+	}
+	return grid;
+}
+
+// Free squares to flood fill from, so every fill starts somewhere else
+static std::vector<Cell> startsOf(const OccupancyGrid& grid) {
+	std::vector<Cell> starts;
+	for (int i = 0; i < grid.getFreeCount(); i++) {
+		starts.push_back(grid.getFree(i));
+	}
+	return starts;
+}
+
+template<typename BoardType>
+static long long fill(BoardType& board, const OccupancyGrid& grid, Stopwatch& stopwatch) {
+	board.assign(grid);
+	std::vector<Cell> starts = startsOf(grid);
+	long long fills = kbatch_squares / (static_cast<long long>(grid.getColumns()) * grid.getRows()) + 1;
+	int total = 0;
+	stopwatch.start();
+	for (long long i = 0; i < fills; i++) {
+		total += board.reachableArea(starts[i % starts.size()]);
+	}
+	stopwatch.stop();
+	doNotOptimize(total);
+	return fills;
+}
+
+// The same flood fill one square at a time over the OccupancyGrid, the way the rest of the core walks the board
+static long long fillBreadthFirst(const OccupancyGrid& grid, Stopwatch& stopwatch) {
+	std::vector<Cell> starts = startsOf(grid);
+	int columns = grid.getColumns();
+	std::vector<uint32_t> visited(static_cast<size_t>(columns) * grid.getRows(), 0);
+	std::vector<Cell> queue(visited.size());
+	long long fills = kbatch_squares / static_cast<long long>(visited.size()) + 1;
+	int total = 0;
+	stopwatch.start();
+	for (long long i = 0; i < fills; i++) {
+		uint32_t mark = static_cast<uint32_t>(i + 1);
+		Cell start = starts[i % starts.size()];
+		size_t head = 0;
+		size_t tail = 0;
+		queue[tail++] = start;
+		visited[start.y * columns + start.x] = mark;
+		while (head < tail) {
+			Cell cell = queue[head++];
+			for (int direction = 0; direction < 4; direction++) {
+				Cell next = neighbour(cell, static_cast<SnakeDirection>(direction));
+				if (grid.inBounds(next) && grid.count(next) == 0 && visited[next.y * columns + next.x] != mark) {
+					visited[next.y * columns + next.x] = mark;
+					queue[tail++] = next;
+				}
+			}
+		}
+		total += static_cast<int>(tail);
+	}
+	stopwatch.stop();
+	doNotOptimize(total);
+	return fills;
+}
+
+// Board<n, n> for the tournament sizes, which have to be named at compile time
+static long long fillFixed(long long n, Stopwatch& stopwatch) {
+	OccupancyGrid grid = gridOf(static_cast<int>(n));
+	if (n == 16) {
+		Board<16, 16> board;
+		return fill(board, grid, stopwatch);
+	} else if (n == 32) {
+		Board<32, 32> board;
+		return fill(board, grid, stopwatch);
+	}
+	Board<64, 64> board;
+	return fill(board, grid, stopwatch);
+}
+
+// Flood fills the area reachable from a free square on a 16x16, 32x32 and 64x64 board with a quarter of the squares
+// taken, one operation is one whole fill. board/reachable_fixed uses Board<n, n>, board/reachable_runtime the same
+// code sized at run time and board/reachable_bfs a breadth first search over the OccupancyGrid for comparison
+void registerBoardBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sides = {16, 32, 64};
+
+	benchmarks.push_back(Benchmark{"board/reachable_fixed", sides, [](long long n, Stopwatch& stopwatch) {
+		return fillFixed(n, stopwatch);
+	}});
+
+	benchmarks.push_back(Benchmark{"board/reachable_runtime", sides, [](long long n, Stopwatch& stopwatch) {
+		int side = static_cast<int>(n);
+		RuntimeBoard board(BoardSize{side, side});
+		return fill(board, gridOf(side), stopwatch);
+	}});
+
+	benchmarks.push_back(Benchmark{"board/reachable_bfs", sides, [](long long n, Stopwatch& stopwatch) {
+		return fillBreadthFirst(gridOf(static_cast<int>(n)), stopwatch);
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
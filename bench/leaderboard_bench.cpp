@@ -0,0 +1,87 @@
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "leaderboard.h"
+#include "random.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const int kmax_score = 2000; // About the most food a full size board holds
+
+static ScoreEntry randomEntry(Random& random) {
+	ScoreEntry entry;
+	entry.score = random.below(kmax_score);
+	entry.player = "player" + std::to_string(random.below(1000));
+	entry.seed = random.next();
+	return entry;
+}
+
+// An in memory leaderboard of n random games, kept for later batches of the same size
+static const Leaderboard& filledLeaderboard(long long n) {
+	static std::map<long long, std::unique_ptr<Leaderboard>> leaderboards;
+	std::unique_ptr<Leaderboard>& leaderboard = leaderboards[n];
+	if (!leaderboard) {
+		leaderboard.reset(new Leaderboard());
+		Random random(1);
+		for (long long i = 0; i < n; i++) {
+			leaderboard->add(randomEntry(random));
+		}
+	}
+	return *leaderboard;
+}
+
+// n is the number of games already on the leaderboard, every query should stay flat as it grows
+void registerLeaderboardBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sizes = decades(1000000);
+
+	benchmarks.push_back(Benchmark{"leaderboard/add", sizes, [](long long n, Stopwatch& stopwatch) {
+		Leaderboard leaderboard;
+		Random random(1);
+		for (long long i = 0; i < n; i++) {
+			leaderboard.add(randomEntry(random));
+		}
+		const int kadds = 1000;
+		std::vector<ScoreEntry> entries;
+		for (int i = 0; i < kadds; i++) {
+			entries.push_back(randomEntry(random));
+		}
+		stopwatch.start();
+		for (const ScoreEntry& entry : entries) {
+			leaderboard.add(entry);
+		}
+		stopwatch.stop();
+		return static_cast<long long>(kadds);
+	}});
+
+	benchmarks.push_back(Benchmark{"leaderboard/rank", sizes, [](long long n, Stopwatch& stopwatch) {
+		const Leaderboard& leaderboard = filledLeaderboard(n);
+		const int kqueries = 10000;
+		long long total = 0;
+		stopwatch.start();
+		for (int i = 0; i < kqueries; i++) {
+			total += leaderboard.getRank(i % kmax_score);
+		}
+		stopwatch.stop();
+		doNotOptimize(total);
+		return static_cast<long long>(kqueries);
+	}});
+
+	// One operation is fetching the ten best games, what the high score screen shows
+	benchmarks.push_back(Benchmark{"leaderboard/top10", sizes, [](long long n, Stopwatch& stopwatch) {
+		const Leaderboard& leaderboard = filledLeaderboard(n);
+		const int kqueries = 1000;
+		stopwatch.start();
+		for (int i = 0; i < kqueries; i++) {
+			std::vector<ScoreEntry> top = leaderboard.getTop(10);
+			doNotOptimize(top.data());
+		}
+		stopwatch.stop();
+		return static_cast<long long>(kqueries);
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
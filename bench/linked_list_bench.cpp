@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.h"
+#include "ref_ll.h"
+#include "unrolled_ll.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const long long kbatch_ops = 10000; // Operations per batch for the O(1) operations
+
+template<typename List>
+static void fill(List& list, long long n) {
+	for (long long i = 0; i < n; i++) {
+		list.push_back(static_cast<int>(i));
+	}
+}
+
+// Adds the same set of benchmarks for one list type, prefix tells the allocator variants apart
+template<typename List>
+static void registerListBenchmarks(std::vector<Benchmark>& benchmarks, const std::string& prefix) {
+	std::vector<long long> sizes = decades(1000000);
+
+	benchmarks.push_back(Benchmark{prefix + "/push_front", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			list.push_front(static_cast<int>(i));
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/push_back", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			list.push_back(static_cast<int>(i));
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/pop_front", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n + kbatch_ops);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			list.pop_front();
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/pop_back", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n + kbatch_ops);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			list.pop_back();
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/size", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			doNotOptimize(list.size());
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/back", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			doNotOptimize(list.back());
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	// Removes from the middle, the worst case walk, and pushes a replacement so the size stays at n
+	benchmarks.push_back(Benchmark{prefix + "/remove_nth_middle", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		long long operations = std::max(1LL, std::min(kbatch_ops, 10000000 / n));
+		stopwatch.start();
+		for (long long i = 0; i < operations; i++) {
+			list.RemoveNth(list.size() / 2);
+			list.push_back(static_cast<int>(i));
+		}
+		stopwatch.stop();
+		return operations;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/copy", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		stopwatch.start();
+		List copy(list);
+		stopwatch.stop();
+		doNotOptimize(copy.size());
+		return 1LL;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/move", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			List moved(std::move(list));
+			list = std::move(moved);
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	// Reported per element visited
+	benchmarks.push_back(Benchmark{prefix + "/iterate", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		long long sum = 0;
+		stopwatch.start();
+		for (auto it = list.begin(); it != list.end(); ++it) {
+			sum += *it;
+		}
+		stopwatch.stop();
+		doNotOptimize(sum);
+		return n;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/equals", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		List other(list);
+		stopwatch.start();
+		bool equal = (list == other);
+		stopwatch.stop();
+		doNotOptimize(equal);
+		return 1LL;
+	}});
+
+	benchmarks.push_back(Benchmark{prefix + "/clear", sizes, [](long long n, Stopwatch& stopwatch) {
+		List list;
+		fill(list, n);
+		stopwatch.start();
+		list.clear();
+		stopwatch.stop();
+		return 1LL;
+	}});
+}
+
+void registerLinkedListBenchmarks(std::vector<Benchmark>& benchmarks) {
+	registerListBenchmarks<LinkedList<int>>(benchmarks, "linked_list");
+	registerListBenchmarks<LinkedList<int, PoolAllocator<int>>>(benchmarks, "linked_list_pool");
+	registerListBenchmarks<UnrolledLinkedList<int>>(benchmarks, "unrolled_list");
+	registerListBenchmarks<UnrolledLinkedList<int, PoolAllocator<int>>>(benchmarks, "unrolled_list_pool");
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
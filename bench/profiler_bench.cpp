@@ -0,0 +1,24 @@
+#include <vector>
+#include "bench.h"
+#include "profiler.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+// The cost one SNAKE_PROFILE_SCOPE adds to the code it wraps: close to nothing in a normal build,
+// the price of two clock reads and a sample store in a build made with PROFILE=1
+void registerProfilerBenchmarks(std::vector<Benchmark>& benchmarks) {
+	benchmarks.push_back(Benchmark{"profiler/scope", {1}, [](long long, Stopwatch& stopwatch) {
+		const long long kscopes = 100000;
+		stopwatch.start();
+		for (long long i = 0; i < kscopes; i++) {
+			SNAKE_PROFILE_SCOPE("bench/empty");
+			doNotOptimize(i);
+		}
+		stopwatch.stop();
+		return kscopes;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
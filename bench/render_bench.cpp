@@ -0,0 +1,93 @@
+#include <vector>
+#include "bench.h"
+#include "snake.h"
+#include "SnakeFood.h"
+#include "software_renderer.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const long long kbatch_ticks = 1000; // Frames per batch
+static const int ksquare_pixels = 4; // Small squares keep the 1000x1000 board's buffer to 64MB
+static const int ksnake_length = 8;
+static const int klength_board_side = 500; // Board the render/tick_length snakes grow on, room for 250,000 segments
+
+// Steers the snake back and forth across the board, moving down a row at each edge and back to the top at the bottom
+static void steer(Snake& snake) {
+	const OccupancyGrid& occupancy = snake.getOccupancy();
+	Cell head = snake.getHeadCell();
+	SnakeDirection direction = snake.getDirection();
+	if (direction == DOWN) {
+		snake.setDirection(head.x == 0 ? RIGHT : LEFT);
+	} else if ((direction == RIGHT && head.x == occupancy.getColumns() - 1) || (direction == LEFT && head.x == 0)) {
+		snake.setDirection(head.y == occupancy.getRows() - 1 ? UP : DOWN);
+	} else if (direction == UP && head.y == 0) {
+		snake.setDirection(head.x == 0 ? RIGHT : LEFT);
+	}
+}
+
+// A snake length segments long with a different color on every segment (the colors repeat after 256) on an n by n
+// board
+static Snake makeSnake(long long n, long long length = ksnake_length) {
+	Snake snake(BoardSize{static_cast<int>(n), static_cast<int>(n)});
+	for (long long i = 1; i < length; i++) {
+		steer(snake);
+		snake.eatFood(Color(static_cast<unsigned char>(i * 30), 0, 0));
+		snake.update();
+	}
+	return snake;
+}
+
+// Ticks and renders a batch of frames, returns the frames
+static long long renderTicks(Snake& snake, const SnakeFood& food, Stopwatch& stopwatch) {
+	SoftwareRenderer renderer(ksquare_pixels);
+	renderer.render(snake, food);
+	stopwatch.start();
+	for (long long i = 0; i < kbatch_ticks; i++) {
+		steer(snake);
+		snake.update();
+		renderer.render(snake, food);
+	}
+	stopwatch.stop();
+	doNotOptimize(renderer.getPixels().data());
+	return kbatch_ticks;
+}
+
+void registerRenderBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sizes = decades(1000);
+
+	// One tick and an incremental frame, flat across board sizes since only the changed squares are painted
+	benchmarks.push_back(Benchmark{"render/tick", sizes, [](long long n, Stopwatch& stopwatch) {
+		Snake snake = makeSnake(n);
+		SnakeFood food(snake.getOccupancy(), 1);
+		return renderTicks(snake, food, stopwatch);
+	}});
+
+	// The same on a 500x500 board with snakes of 10 to 100,000 segments. A frame walks the whole body, and as every
+	// segment's color moves one square on per tick most body squares are repainted too, so this grows with the length
+	benchmarks.push_back(Benchmark{"render/tick_length", decades(100000), [](long long n, Stopwatch& stopwatch) {
+		Snake snake = makeSnake(klength_board_side, n);
+		SnakeFood food(snake.getOccupancy(), 1);
+		return renderTicks(snake, food, stopwatch);
+	}});
+
+	// The same frame painted from scratch, for comparison, grows with the board
+	benchmarks.push_back(Benchmark{"render/full", sizes, [](long long n, Stopwatch& stopwatch) {
+		Snake snake = makeSnake(n);
+		SnakeFood food(snake.getOccupancy(), 1);
+		SoftwareRenderer renderer(ksquare_pixels);
+		renderer.render(snake, food);
+		long long frames = n >= 1000 ? 4 : kbatch_ticks;
+		stopwatch.start();
+		for (long long i = 0; i < frames; i++) {
+			renderer.invalidate();
+			renderer.render(snake, food);
+		}
+		stopwatch.stop();
+		doNotOptimize(renderer.getPixels().data());
+		return frames;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "random.h"
+#include "replay.h"
+#include "replay_archive.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const int kticks_per_minute = 12 * 60; // At the game's TICK_RATE of 12
+
+/*
+Records a game of the given length played by a bot that follows a cycle through every square of the board:
+down the even columns, up the odd ones and back along the top row, so it can't die before the board is full
+*/
+static ReplayRecorder recordGame(long long ticks) {
+	Simulation game(640, 480, 1);
+	ReplayRecorder recorder;
+	recorder.start(game.getSeed(), game.getBoardWidth(), game.getBoardHeight());
+	int columns = game.getSnake().getOccupancy().getColumns();
+	int rows = game.getSnake().getOccupancy().getRows();
+
+	while (game.getTickCount() < ticks && game.getState() == IN_PROGRESS) {
+		Cell head = game.getSnake().getHeadCell();
+		SnakeDirection direction;
+		if (head.y == 0) {
+			direction = (head.x > 0) ? LEFT : DOWN;
+		} else if (head.x % 2 == 0) {
+			direction = (head.y < rows - 1) ? DOWN : RIGHT;
+		} else {
+			direction = (head.y > 1 || head.x == columns - 1) ? UP : RIGHT;
+		}
+		if (game.queueTurn(direction)) {
+			recorder.recordTurn(game.getTickCount(), direction);
+		}
+		game.tick();
+	}
+	recorder.finish(game.getTickCount());
+	return recorder;
+}
+
+// An archive written to the working directory for the length of the run
+struct TemporaryArchive {
+	std::string path;
+	explicit TemporaryArchive(const std::string& file_path) : path(file_path) {};
+	~TemporaryArchive() { std::remove(path.c_str()); }
+};
+
+// Writes n copies of the same recording to an archive, archives are kept for later batches of the same size
+static const std::string& archivePath(const std::string& name, long long n, const ReplayRecorder& recorder) {
+	static std::map<std::string, std::unique_ptr<TemporaryArchive>> archives;
+	std::string path = "snake_bench_" + name + "_" + std::to_string(n) + ".snka";
+	std::unique_ptr<TemporaryArchive>& archive = archives[path];
+	if (!archive) {
+		ReplayPlayer player(recorder.getBytes());
+		ReplayArchiveWriter writer;
+		writer.open(path);
+		for (long long i = 0; i < n; i++) {
+			writer.addGame(player);
+		}
+		writer.finish();
+		archive.reset(new TemporaryArchive(path));
+	}
+	return archive->path;
+}
+
+// n is the length of the recorded game in minutes, one operation is one replayed tick
+void registerReplayBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> minutes = {1, 10, 60};
+
+	benchmarks.push_back(Benchmark{"replay/play", minutes, [](long long n, Stopwatch& stopwatch) {
+		ReplayRecorder recorder = recordGame(n * kticks_per_minute);
+		ReplayPlayer player(recorder.getBytes());
+		stopwatch.start();
+		Simulation game = player.play();
+		stopwatch.stop();
+		return game.getTickCount();
+	}});
+
+	// n is the length of the archived game in minutes, one operation is a seek to a random tick
+	benchmarks.push_back(Benchmark{"archive/seek", minutes, [](long long n, Stopwatch& stopwatch) {
+		const std::string& path = archivePath("seek", n, recordGame(n * kticks_per_minute));
+		ReplayArchive archive;
+		archive.open(path);
+		ArchivedGame info;
+		archive.getGame(0, info);
+
+		const int kseeks = 100;
+		Random ticks(1);
+		Simulation game(info.board_width, info.board_height, info.seed);
+		stopwatch.start();
+		for (int i = 0; i < kseeks; i++) {
+			archive.seek(0, ticks.below(static_cast<int>(info.ticks) + 1), game);
+		}
+		stopwatch.stop();
+		doNotOptimize(game.getTickCount());
+		return static_cast<long long>(kseeks);
+	}});
+
+	// n is the number of ten second games in the archive, one operation is opening it and reading its last game
+	benchmarks.push_back(Benchmark{"archive/open", decades(100000), [](long long n, Stopwatch& stopwatch) {
+		static const ReplayRecorder recorder = recordGame(10 * 12);
+		const std::string& path = archivePath("open", n, recorder);
+
+		const int kopens = 100;
+		ArchivedGame info;
+		stopwatch.start();
+		for (int i = 0; i < kopens; i++) {
+			ReplayArchive archive;
+			archive.open(path);
+			archive.getGame(archive.getGameCount() - 1, info);
+		}
+		stopwatch.stop();
+		doNotOptimize(info.ticks);
+		return static_cast<long long>(kopens);
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
@@ -0,0 +1,36 @@
+#include <vector>
+#include "bench.h"
+#include "game_runner.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const long long kgames_per_thread = 64; // Games per worker thread in each batch, so every thread count does the same work per thread
+static const int kmax_ticks = 5000;
+
+/*
+Scaling of GameRunner with the number of threads, n is the thread count.
+One operation is one game tick and every thread gets the same number of games, so with perfect scaling ns_per_op
+halves each time the thread count doubles. Scaling efficiency at n threads is ns_per_op(1) / (n * ns_per_op(n)).
+Thread counts beyond the number of hardware threads only measure oversubscription.
+*/
+void registerRunnerBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> thread_counts;
+	for (long long threads = 1; threads <= 64; threads *= 2) {
+		thread_counts.push_back(threads);
+	}
+
+	benchmarks.push_back(Benchmark{"runner/threads", thread_counts, [](long long n, Stopwatch& stopwatch) {
+		GameRunner runner(640, 480, static_cast<int>(n), kmax_ticks);
+		Policy policy = [](const Simulation& game) {
+			return towardsFood(game.getSnake().getHeadCell(), game.getFood().getCell());
+		};
+		stopwatch.start();
+		RunSummary summary = runner.run(kgames_per_thread * n, policy, 1);
+		stopwatch.stop();
+		return summary.total_ticks;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
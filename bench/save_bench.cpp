@@ -0,0 +1,157 @@
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "binary_io.h"
+#include "flat_state.h"
+#include "simulation.h"
+#include "snake.h"
+#include "SnakeFood.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const int kboard_columns = 50; // The width of every board a game starts on
+static const int ksquare_pixels = 20; // Square size of a 1000 pixel wide window
+
+// Steers the snake back and forth across the board, moving down a row at each edge
+static void steer(Snake& snake) {
+	int x = snake.getHeadCell().x;
+	SnakeDirection direction = snake.getDirection();
+	if ((direction == RIGHT && x == kboard_columns - 1) || (direction == LEFT && x == 0)) {
+		snake.setDirection(DOWN);
+	} else if (direction == DOWN) {
+		snake.setDirection(x == 0 ? RIGHT : LEFT);
+	}
+}
+
+/*
+A game whose snake is n segments long, games are kept for later batches of the same size.
+Simulation can't grow a snake that long by itself in reasonable time, so the snake is grown on its own and put into
+a game through a flat save, which is also what the benchmarks measure
+*/
+static Simulation& gameOfLength(long long n) {
+	static std::map<long long, std::unique_ptr<Simulation>> games;
+	std::unique_ptr<Simulation>& game = games[n];
+	if (!game) {
+		int rows = static_cast<int>(n / kboard_columns + 4);
+		Snake snake(BoardSize{kboard_columns, rows});
+		for (long long i = 1; i < n; i++) {
+			steer(snake);
+			snake.eatFood(Color(static_cast<unsigned char>(i), 0, 0));
+			snake.update();
+		}
+		SnakeFood food(snake.getOccupancy(), 1);
+
+		FlatWriter out;
+		out.header().board_width = kboard_columns * ksquare_pixels;
+		out.header().board_height = rows * ksquare_pixels;
+		snake.writeFlat(out);
+		food.writeFlat(out);
+		std::vector<uint8_t> bytes;
+		out.copyTo(bytes);
+
+		FlatGameView saved;
+		saved.view(bytes.data(), bytes.size());
+		game.reset(new Simulation(kboard_columns * ksquare_pixels, rows * ksquare_pixels, 1));
+		game->readFlat(saved);
+	}
+	return *game;
+}
+
+// A save written to the working directory for the length of the run
+struct TemporarySave {
+	std::string path;
+	explicit TemporarySave(long long n) : path("snake_bench_save_" + std::to_string(n) + ".snkf") {};
+	~TemporarySave() { std::remove(path.c_str()); }
+};
+
+// n is the length of the snake, one operation is saving or loading the whole game
+void registerSaveBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sizes = decades(1000000);
+
+	benchmarks.push_back(Benchmark{"save/write_flat", sizes, [](long long n, Stopwatch& stopwatch) {
+		const Simulation& game = gameOfLength(n);
+		TemporarySave save(n);
+		stopwatch.start();
+		FlatWriter out;
+		game.writeFlat(out);
+		out.write(save.path);
+		stopwatch.stop();
+		return 1LL;
+	}});
+
+	benchmarks.push_back(Benchmark{"save/open_flat", sizes, [](long long n, Stopwatch& stopwatch) {
+		const Simulation& game = gameOfLength(n);
+		TemporarySave save(n);
+		FlatWriter out;
+		game.writeFlat(out);
+		out.write(save.path);
+		stopwatch.start();
+		FlatGameView saved;
+		saved.open(save.path);
+		doNotOptimize(saved.header().body_length);
+		stopwatch.stop();
+		return 1LL;
+	}});
+
+	benchmarks.push_back(Benchmark{"save/read_flat", sizes, [](long long n, Stopwatch& stopwatch) {
+		Simulation& game = gameOfLength(n);
+		std::vector<uint8_t> bytes;
+		FlatWriter out;
+		game.writeFlat(out);
+		out.copyTo(bytes);
+		FlatGameView saved;
+		saved.view(bytes.data(), bytes.size());
+		stopwatch.start();
+		game.readFlat(saved); // Into the same game, so like loading a save into a game already on that board
+		stopwatch.stop();
+		return 1LL;
+	}});
+
+	// The check a save that may be damaged needs before it is restored, a pass over the body and the board
+	benchmarks.push_back(Benchmark{"save/validate_flat", sizes, [](long long n, Stopwatch& stopwatch) {
+		const Simulation& game = gameOfLength(n);
+		std::vector<uint8_t> bytes;
+		FlatWriter out;
+		game.writeFlat(out);
+		out.copyTo(bytes);
+		FlatGameView saved;
+		saved.view(bytes.data(), bytes.size());
+		saved.validate(); // Sizes the view's scratch counts, as a view checking its second save would have them
+		stopwatch.start();
+		bool valid = saved.validate();
+		stopwatch.stop();
+		doNotOptimize(valid);
+		return 1LL;
+	}});
+
+	// The segment by segment format replays and the server use, for comparison
+	benchmarks.push_back(Benchmark{"save/write_state", sizes, [](long long n, Stopwatch& stopwatch) {
+		const Simulation& game = gameOfLength(n);
+		std::vector<uint8_t> bytes;
+		stopwatch.start();
+		BinaryWriter out(bytes);
+		game.writeState(out);
+		doNotOptimize(bytes.size());
+		stopwatch.stop();
+		return 1LL;
+	}});
+
+	benchmarks.push_back(Benchmark{"save/read_state", sizes, [](long long n, Stopwatch& stopwatch) {
+		Simulation& game = gameOfLength(n);
+		std::vector<uint8_t> bytes;
+		BinaryWriter out(bytes);
+		game.writeState(out);
+		BinaryReader in(bytes.data(), bytes.size());
+		stopwatch.start();
+		game.readState(in);
+		stopwatch.stop();
+		return 1LL;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
@@ -0,0 +1,58 @@
+#include <memory>
+#include <vector>
+#include "bench.h"
+#include "game_client.h"
+#include "game_server.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const long long kbatch_deliveries = 20000; // Frames delivered per batch, split between however many clients there are
+
+// One tick encoded once and delivered to n loopback clients, one operation is one client receiving and applying
+// the tick's delta, so n * ns_per_op is the cost of a whole tick with both ends of every connection counted
+void registerServerBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sizes = decades(100);
+	sizes.insert(sizes.begin(), 1);
+
+	benchmarks.push_back(Benchmark{"server/broadcast", sizes, [](long long n, Stopwatch& stopwatch) {
+		GameServer server(640, 480, 1);
+		if (!server.listen(0)) {
+			return 0LL;
+		}
+		std::vector<std::unique_ptr<GameClient>> clients;
+		for (long long i = 0; i < n; i++) {
+			clients.emplace_back(new GameClient());
+			clients.back()->connect(server.getPort());
+		}
+		while (server.getClientCount() < n) {
+			server.poll(10);
+		}
+		for (std::unique_ptr<GameClient>& client : clients) {
+			client->poll(10);
+		}
+
+		GameClient& player = *clients.front();
+		long long ticks = kbatch_deliveries / n + 1;
+		stopwatch.start();
+		for (long long t = 0; t < ticks; t++) {
+			const GameMirror& game = player.getGame();
+			if (game.getState() == FINISHED) {
+				player.sendRestart();
+			} else {
+				player.sendTurn(towardsFood(game.getBody().front(), game.getFood()));
+			}
+			server.poll(0);
+			server.tick();
+			for (std::unique_ptr<GameClient>& client : clients) {
+				while (client->getGame().getTickCount() != server.getGame().getTickCount() && client->poll(1) >= 0) {
+				}
+			}
+		}
+		stopwatch.stop();
+		return ticks * n;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
@@ -0,0 +1,96 @@
+#include <vector>
+#include "bench.h"
+#include "snake.h"
+#include "SnakeFood.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const long long kbatch_ops = 10000; // Operations per batch, all of the snake operations are O(1)
+static const int kboard_columns = 50; // The width of every board a game starts on
+
+// Steers the snake back and forth across the board, moving down a row at each edge
+static void steer(Snake& snake) {
+	const OccupancyGrid& occupancy = snake.getOccupancy();
+	int x = snake.getHeadCell().x;
+	SnakeDirection direction = snake.getDirection();
+	if ((direction == RIGHT && x == occupancy.getColumns() - 1) || (direction == LEFT && x == 0)) {
+		snake.setDirection(DOWN);
+	} else if (direction == DOWN) {
+		snake.setDirection(x == 0 ? RIGHT : LEFT);
+	}
+}
+
+// Grows a snake to length n on a board with spare_rows empty rows below it, so it can keep moving
+static Snake makeSnake(long long n, long long spare_rows) {
+	Snake snake(BoardSize{kboard_columns, static_cast<int>(2 + n / kboard_columns + 1 + spare_rows)});
+	for (long long i = 1; i < n; i++) {
+		steer(snake);
+		snake.eatFood(Color(static_cast<unsigned char>(i), 0, 0));
+		snake.update();
+	}
+	return snake;
+}
+
+void registerSnakeBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> sizes = decades(1000000);
+	long long update_rows = kbatch_ops / 50 + 2;
+
+	benchmarks.push_back(Benchmark{"snake/update", sizes, [update_rows](long long n, Stopwatch& stopwatch) {
+		Snake snake = makeSnake(n, update_rows);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			steer(snake);
+			snake.update();
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	benchmarks.push_back(Benchmark{"snake/is_dead", sizes, [](long long n, Stopwatch& stopwatch) {
+		Snake snake = makeSnake(n, 1);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			doNotOptimize(snake.isDead());
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	benchmarks.push_back(Benchmark{"snake/eat_food", sizes, [](long long n, Stopwatch& stopwatch) {
+		Snake snake = makeSnake(n, 1);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			snake.eatFood(Color(0, 0, 255));
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	// Plenty of room: the board is mostly empty
+	benchmarks.push_back(Benchmark{"food/rebase", sizes, [](long long n, Stopwatch& stopwatch) {
+		Snake snake = makeSnake(n, n / 50 + 10);
+		SnakeFood food(snake.getOccupancy(), 1);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			food.rebase(snake.getOccupancy());
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+
+	// Endgame: the snake covers all but a couple of rows of the board
+	benchmarks.push_back(Benchmark{"food/rebase_crowded", sizes, [](long long n, Stopwatch& stopwatch) {
+		Snake snake = makeSnake(n, 0);
+		SnakeFood food(snake.getOccupancy(), 1);
+		stopwatch.start();
+		for (long long i = 0; i < kbatch_ops; i++) {
+			food.rebase(snake.getOccupancy());
+		}
+		stopwatch.stop();
+		return kbatch_ops;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "game_thread.h"
+
+namespace snakelinkedlist {
+namespace bench {
+
+static const int kboard_width = 640;
+static const int kboard_height = 480;
+static const long long kbatch_posts = 10000; // Commands posted per batch of thread/post
+static const int kposts_per_round = 64; // Commands the stress loop posts between looking at the snapshot
+static const std::chrono::milliseconds kstress_run(100); // How long each batch of the stress test runs the game
+
+// Plays like an impatient player on the window thread: picks up the newest snapshot, drains the events,
+// then floods the queue with turns towards the food (and a restart when the game is over). Returns the commands posted
+static int hammer(GameThread& game, uint32_t& seed) {
+	game.updateSnapshot();
+	GameEvent event;
+	while (game.pollEvent(event)) {
+	}
+	const Simulation& snapshot = game.getSnapshot().game;
+	GameCommand command = {QUEUE_TURN, towardsFood(snapshot.getSnake().getHeadCell(), snapshot.getFood().getCell()), 0, 0, 0};
+	if (snapshot.getState() == FINISHED) {
+		command.kind = RESET_GAME;
+		command.seed = ++seed;
+	}
+	for (int i = 0; i < kposts_per_round; i++) {
+		if (!game.post(command)) {
+			std::this_thread::yield();
+			return i;
+		}
+	}
+	return kposts_per_round;
+}
+
+// Runs the game at n ticks per second for kstress_run while hammering it with input, returns how punctual it was
+static TickStats stress(long long n) {
+	GameThread game(kboard_width, kboard_height, static_cast<double>(n));
+	uint32_t seed = 1;
+	game.start(seed);
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + kstress_run;
+	while (std::chrono::steady_clock::now() < end) {
+		hammer(game, seed);
+	}
+	game.stop();
+	return game.getTickStats();
+}
+
+void registerThreadBenchmarks(std::vector<Benchmark>& benchmarks) {
+	std::vector<long long> rates = {100, 1000};
+
+	// Cost of sending input to the running simulation thread, including picking up snapshots and events
+	benchmarks.push_back(Benchmark{"thread/post", rates, [](long long n, Stopwatch& stopwatch) {
+		GameThread game(kboard_width, kboard_height, static_cast<double>(n));
+		uint32_t seed = 1;
+		game.start(seed);
+		stopwatch.start();
+		long long posted = 0;
+		while (posted < kbatch_posts) {
+			posted += hammer(game, seed);
+		}
+		stopwatch.stop();
+		game.stop();
+		return posted;
+	}});
+
+	// The stress test: n is ticks per second, ns_per_op is how long after it was due a tick ran on average
+	// while input is hammered. The simulation thread never waits for input, so this should stay near the sleep
+	// granularity of the OS whatever the input rate
+	benchmarks.push_back(Benchmark{"thread/tick_lateness", rates, [](long long n, Stopwatch& stopwatch) {
+		TickStats stats = stress(n);
+		stopwatch.add(stats.mean_lateness_us * 1000 * stats.ticks);
+		return stats.ticks;
+	}});
+
+	// The latest tick of each batch of the stress test, the worst case jitter
+	benchmarks.push_back(Benchmark{"thread/tick_lateness_max", rates, [](long long n, Stopwatch& stopwatch) {
+		TickStats stats = stress(n);
+		stopwatch.add(stats.max_lateness_us * 1000);
+		return 1LL;
+	}});
+}
+
+} // namespace bench
+} // namespace snakelinkedlist
@@ -1,50 +1,67 @@
-#include <stdlib.h>
 #include "SnakeFood.h"
+#include "profiler.h"
 using namespace snakelinkedlist;
 
-const float SnakeFood::kfood_modifier_ = 0.02;
+SnakeFood::SnakeFood(const OccupancyGrid& occupancy, uint32_t seed) : generator_(seed), cell_{0, 0} {
+	rebase(occupancy);
+}
 
-SnakeFood::SnakeFood() {
-	int window_width = ofGetWindowWidth();
-	int window_height = ofGetWindowHeight();
-	window_dims_.set(window_width, window_height);
-	float size_d = kfood_modifier_ * window_width;
-	food_rect_.setSize(size_d, size_d);
+// A single uniform pick from the empty squares, if the snake covers the whole board the food stays where it is
+void SnakeFood::rebase(const OccupancyGrid& occupancy) {
+	SNAKE_PROFILE_SCOPE("food/rebase");
+	int free_count = occupancy.getFreeCount();
+	if (free_count > 0) {
+		cell_ = occupancy.getFree(generator_.below(free_count));
+	}
 
-	generator_ = std::mt19937(rand());
-	dist_x_ = std::uniform_int_distribution<>(0, window_width - size_d);
-	dist_y_ = std::uniform_int_distribution<>(0, window_height - size_d);
-	dist_color_ = std::uniform_int_distribution<>(0, 255);
-	rebase();
+	color_.r = static_cast<unsigned char>(generator_.below(256));
+	color_.g = static_cast<unsigned char>(generator_.below(256));
+	color_.b = static_cast<unsigned char>(generator_.below(256));
 }
 
-void SnakeFood::resize(int w, int h) {
-	float size_d = kfood_modifier_ * w;
-	food_rect_.setSize(size_d, size_d);
+Cell SnakeFood::getCell() const {
+	return cell_;
+}
 
-	float new_x = ((food_rect_.getX() / window_dims_.x) * w);
-	float new_y = ((food_rect_.getY() / window_dims_.y) * h);
-	food_rect_.setPosition(new_x, new_y);
+Color SnakeFood::getColor() const {
+	return color_;
+}
 
-	dist_x_ = std::uniform_int_distribution<>(0, w - size_d);
-	dist_y_ = std::uniform_int_distribution<>(0, h - size_d);
-	window_dims_.set(w, h);
+void SnakeFood::writeState(BinaryWriter& out) const {
+	out.write(generator_.getState());
+	out.write(cell_);
+	out.write(color_);
 }
 
-void SnakeFood::rebase() {
-	auto x = dist_x_(generator_);
-	auto y = dist_y_(generator_);
-	food_rect_.setPosition(x, y);
+bool SnakeFood::readState(BinaryReader& in) {
+	uint64_t generator_state;
+	Cell cell;
+	Color color;
+	in.read(generator_state);
+	in.read(cell);
+	in.read(color);
+	if (!in.ok()) {
+		return false;
+	}
 
-	color_.r = dist_color_(generator_);
-	color_.g = dist_color_(generator_);
-	color_.b = dist_color_(generator_);
+	generator_.setState(generator_state);
+	cell_ = cell;
+	color_ = color;
+	return true;
 }
 
-ofRectangle SnakeFood::getFoodRect() {
-	return food_rect_;
+void SnakeFood::writeFlat(FlatWriter& out) const {
+	FlatGameHeader& header = out.header();
+	header.food_generator = generator_.getState();
+	header.food = cell_;
+	header.food_color[0] = color_.r;
+	header.food_color[1] = color_.g;
+	header.food_color[2] = color_.b;
 }
 
-ofColor SnakeFood::getColor() {
-	return color_;
-}
\ No newline at end of file
+void SnakeFood::readFlat(const FlatGameView& in) {
+	const FlatGameHeader& header = in.header();
+	generator_.setState(header.food_generator);
+	cell_ = header.food;
+	color_ = Color(header.food_color[0], header.food_color[1], header.food_color[2]);
+}
@@ -1,26 +1,27 @@
 #pragma once
-#include <random>
-#include "ofMain.h"
+#include <cstdint>
+#include "game_types.h"
+#include "occupancy_grid.h"
+#include "random.h"
+#include "binary_io.h"
+#include "flat_state.h"
 
 namespace snakelinkedlist {
 
 class SnakeFood {
 private:
-	ofVec2f window_dims_; // The object must be aware of current window dimensions for resizing things appropriately
-	std::mt19937 generator_; // Generator used for pseudorandom number generation for food color and position
-	std::uniform_int_distribution<> dist_x_; // Generates valid x positions in current window dimension
-	std::uniform_int_distribution<> dist_y_; // Generates valid y positions in current window dimension
-	std::uniform_int_distribution<> dist_color_; // Generates valid rgb values
-
-	static const float kfood_modifier_; // What proportion of the window width the food square should be in size
-	ofRectangle food_rect_; // The rectangle which represents the actual food pellet on the game board
-	ofColor color_; // The color of the food rectangle
+	Random generator_; // Generator used for pseudorandom number generation for food color and position
+	Cell cell_; // The board square the food pellet is on
+	Color color_; // The color of the food pellet
 
 public:
-	SnakeFood(); // Default constructor, sets up generator devices and rarndomly places food at a valid location
-	void rebase(); // Called once the snake has successfully eaten food, replaces the foods color and location
-	void resize(int w, int h); // Called by application resize, resizes food rect to new window dimensions
-	ofRectangle getFoodRect(); // Gets the rectangle that represents the food object
-	ofColor getColor(); // Gets the color of the current food object
+	SnakeFood(const OccupancyGrid& occupancy, uint32_t seed); // Seeds the generator and randomly places food on an empty square
+	void rebase(const OccupancyGrid& occupancy); // Called once the snake has successfully eaten food, moves the food to a random empty square and replaces its color
+	Cell getCell() const; // Gets the board square the food is on
+	Color getColor() const; // Gets the color of the current food object
+	void writeState(BinaryWriter& out) const; // Writes the food and the generator state
+	bool readState(BinaryReader& in); // Restores a state written by writeState(), false if it is damaged
+	void writeFlat(FlatWriter& out) const; // Puts the food and the generator state in a flat save's header
+	void readFlat(const FlatGameView& in); // Restores them from a flat save
 };
 } // namespace snakelinkedlist
\ No newline at end of file
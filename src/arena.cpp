@@ -0,0 +1,214 @@
+#include "arena.h"
+#include "profiler.h"
+
+using namespace snakelinkedlist;
+
+const uint8_t Arena::kno_turn_;
+const int Arena::kno_food_;
+
+Arena::Arena(BoardSize board, int snake_count, int food_count, uint32_t seed)
+	: board_(board),
+	  generator_(seed),
+	  bodies_(snake_count),
+	  direction_(snake_count, RIGHT),
+	  pending_turn_(snake_count, kno_turn_),
+	  alive_(snake_count, 0),
+	  score_(snake_count, 0),
+	  next_head_(snake_count, -1),
+	  food_squares_(food_count, -1),
+	  food_index_(static_cast<size_t>(board.columns) * board.rows, kno_food_) {
+	occupancy_.reset(board.columns, board.rows);
+	dying_.reserve(snake_count);
+	for (int snake = 0; snake < snake_count; snake++) {
+		respawn(snake);
+	}
+	unplaced_food_.reserve(food_count);
+	for (int food = 0; food < food_count; food++) {
+		unplaced_food_.push_back(food);
+	}
+	placeFood();
+}
+
+int Arena::indexOf(Cell cell) const {
+	return cell.y * board_.columns + cell.x;
+}
+
+Cell Arena::cellOf(int square) const {
+	return Cell{square % board_.columns, square / board_.columns};
+}
+
+// Empty squares come from the grid's list of uncovered squares, only the food on them has to be tried around
+int Arena::randomEmptySquare() {
+	for (int i = 0; i < kmax_placement_tries_ && occupancy_.getFreeCount() > 0; i++) {
+		int square = indexOf(occupancy_.getFree(generator_.below(occupancy_.getFreeCount())));
+		if (food_index_[square] == kno_food_) {
+			return square;
+		}
+	}
+	return -1;
+}
+
+void Arena::placeFood() {
+	size_t kept = 0;
+	for (size_t i = 0; i < unplaced_food_.size(); i++) {
+		int food = unplaced_food_[i];
+		int square = randomEmptySquare();
+		food_squares_[food] = square;
+		if (square >= 0) {
+			food_index_[square] = food;
+		} else {
+			unplaced_food_[kept++] = food;
+		}
+	}
+	unplaced_food_.resize(kept);
+}
+
+bool Arena::respawn(int snake) {
+	if (alive_[snake]) {
+		return true;
+	}
+	int square = randomEmptySquare();
+	if (square < 0) {
+		return false;
+	}
+	bodies_[snake].clear();
+	bodies_[snake].push_front(square);
+	occupancy_.add(cellOf(square));
+	direction_[snake] = static_cast<uint8_t>(generator_.below(4));
+	pending_turn_[snake] = kno_turn_;
+	alive_[snake] = 1;
+	score_[snake] = 0;
+	return true;
+}
+
+/*
+Advances every living snake by one step in four passes, so every snake sees the board as it was at the start of
+the tick and the order of the snakes never matters:
+1. Apply the queued turn if it is legal, eat the food under the head (growing instead of dropping the tail),
+   otherwise take the tail off the board, and work out where the head goes
+2. Put every head on its new square
+3. A snake dies if its head left the board or shares its square with any other segment
+4. Take the dead snakes off the board and put the eaten food back on empty squares
+*/
+int Arena::tick() {
+	SNAKE_PROFILE_SCOPE("arena/tick");
+	int snake_count = getSnakeCount();
+	for (int snake = 0; snake < snake_count; snake++) {
+		if (!alive_[snake]) {
+			continue;
+		}
+		// Turns are only legal onto the other axis, UP and DOWN are the two vertical directions
+		uint8_t direction = direction_[snake];
+		uint8_t turn = pending_turn_[snake];
+		if (turn != kno_turn_ && (turn < 2) != (direction < 2)) {
+			direction = turn;
+			direction_[snake] = direction;
+		}
+		pending_turn_[snake] = kno_turn_;
+
+		RingBuffer<int>& body = bodies_[snake];
+		int head = body.front();
+		int food = food_index_[head];
+		if (food != kno_food_) {
+			food_index_[head] = kno_food_;
+			food_squares_[food] = -1;
+			unplaced_food_.push_back(food);
+			score_[snake]++;
+		} else {
+			occupancy_.remove(cellOf(body.back()));
+			body.pop_back();
+		}
+
+		Cell next = neighbour(cellOf(head), static_cast<SnakeDirection>(direction));
+		next_head_[snake] = occupancy_.inBounds(next) ? indexOf(next) : -1;
+	}
+
+	for (int snake = 0; snake < snake_count; snake++) {
+		if (alive_[snake] && next_head_[snake] >= 0) {
+			bodies_[snake].push_front(next_head_[snake]);
+			occupancy_.add(cellOf(next_head_[snake]));
+		}
+	}
+
+	dying_.clear();
+	for (int snake = 0; snake < snake_count; snake++) {
+		if (alive_[snake] && (next_head_[snake] < 0 || occupancy_.count(cellOf(next_head_[snake])) > 1)) {
+			dying_.push_back(snake);
+		}
+	}
+
+	for (int snake : dying_) {
+		RingBuffer<int>& body = bodies_[snake];
+		for (size_t i = 0; i < body.size(); i++) {
+			occupancy_.remove(cellOf(body[i]));
+		}
+		body.clear();
+		alive_[snake] = 0;
+	}
+	placeFood();
+	SNAKE_PROFILE_COUNT("arena/deaths", static_cast<long long>(dying_.size()));
+	return static_cast<int>(dying_.size());
+}
+
+void Arena::queueTurn(int snake, SnakeDirection new_direction) {
+	pending_turn_[snake] = static_cast<uint8_t>(new_direction);
+}
+
+int Arena::getSnakeCount() const {
+	return static_cast<int>(bodies_.size());
+}
+
+int Arena::getAliveCount() const {
+	int alive = 0;
+	for (uint8_t snake_alive : alive_) {
+		alive += snake_alive;
+	}
+	return alive;
+}
+
+BoardSize Arena::getBoardSize() const {
+	return board_;
+}
+
+const OccupancyGrid& Arena::getOccupancy() const {
+	return occupancy_;
+}
+
+bool Arena::isAlive(int snake) const {
+	return alive_[snake] != 0;
+}
+
+int Arena::getLength(int snake) const {
+	return static_cast<int>(bodies_[snake].size());
+}
+
+int Arena::getScore(int snake) const {
+	return score_[snake];
+}
+
+SnakeDirection Arena::getDirection(int snake) const {
+	return static_cast<SnakeDirection>(direction_[snake]);
+}
+
+Cell Arena::getHead(int snake) const {
+	return cellOf(bodies_[snake].front());
+}
+
+Cell Arena::getSegment(int snake, int i) const {
+	return cellOf(bodies_[snake][i]);
+}
+
+int Arena::getFoodCount() const {
+	return static_cast<int>(food_squares_.size());
+}
+
+Cell Arena::getFood(int food) const {
+	if (food_squares_[food] < 0) {
+		return Cell{-1, -1};
+	}
+	return cellOf(food_squares_[food]);
+}
+
+bool Arena::hasFood(Cell cell) const {
+	return occupancy_.inBounds(cell) && food_index_[indexOf(cell)] != kno_food_;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game_types.h"
+#include "occupancy_grid.h"
+#include "random.h"
+#include "ring_buffer.h"
+
+namespace snakelinkedlist {
+
+/*
+Many snakes on one shared board, e.g. an arena of bot snakes.
+
+Every snake follows the rules of Simulation::tick() and also dies when its head runs into another snake. Instead of
+checking each head against every other body, all the snakes share one OccupancyGrid: each tick a snake removes the
+square its tail left and adds the square its head entered, so the grid always holds how many segments cover every
+square and a collision with any body (its own or another snake's) is a single lookup of the head's square.
+A tick therefore costs the same per snake however long the snakes are and however many of them there are.
+
+All the snakes move at once: tails leave before heads arrive, so a head may take the square another snake's tail
+just left, and two heads entering the same square both die. Two length 1 snakes swapping squares pass through each
+other, like the tail of a single snake.
+
+Food is spread over the board, food_count items at a time. A snake that ends a tick on a food square grows on the
+next one and the food moves to a random empty square. Dead snakes leave the board and stay dead until respawn().
+*/
+class Arena {
+private:
+	static const uint8_t kno_turn_ = 0xff; // pending_turn_ value when no turn was queued
+	static const int kno_food_ = -1; // food_index_ value of a square without food
+	static const int kmax_placement_tries_ = 64; // Random empty squares tried before giving up on placing something
+
+	BoardSize board_; // Size of the board in squares
+	Random generator_; // Decides where snakes spawn and food lands, so a seed and the turns reproduce an arena
+	OccupancyGrid occupancy_; // Segments of every snake on each square, shared by all the snakes
+
+	// One entry per snake
+	std::vector<RingBuffer<int>> bodies_; // Row by row square index of every segment from head to tail, empty when dead
+	std::vector<uint8_t> direction_; // SnakeDirection the snake is moving in
+	std::vector<uint8_t> pending_turn_; // Turn to try on the next tick, kno_turn_ if none
+	std::vector<uint8_t> alive_; // 1 while the snake is on the board
+	std::vector<int> score_; // Food eaten since the snake last spawned
+	std::vector<int> next_head_; // Square the head moves to on this tick, -1 if it leaves the board
+	std::vector<int> dying_; // Snakes that died on this tick, reused between ticks
+
+	// Food, one entry per item and one per square
+	std::vector<int> food_squares_; // Square of every food item, -1 while it has nowhere to go
+	std::vector<int> unplaced_food_; // Food items eaten this tick or that found no empty square, placed at the end of a tick
+	std::vector<int> food_index_; // Which food item is on each square, kno_food_ if none
+
+	int indexOf(Cell cell) const; // Row by row index of a square on the board
+	Cell cellOf(int square) const; // The square with a row by row index
+	int randomEmptySquare(); // A random square with no segment or food on it, -1 if none was found
+	void placeFood(); // Puts every unplaced food item on a random empty square, leaving those that find none for later
+
+public:
+	Arena(BoardSize board, int snake_count, int food_count, uint32_t seed); // Spawns every snake and food item on an empty board
+
+	int tick(); // Advances every living snake by one step, returns how many died on this step
+	void queueTurn(int snake, SnakeDirection new_direction); // Tries the turn on the snake's next tick, replaces any turn already queued
+	bool respawn(int snake); // Puts a dead snake back as length 1 on a random empty square, false if none was found
+
+	int getSnakeCount() const; // Gets the number of snakes, dead or alive
+	int getAliveCount() const; // Gets the number of snakes on the board
+	BoardSize getBoardSize() const; // Gets the size of the board in squares
+	const OccupancyGrid& getOccupancy() const; // The squares covered by any snake
+	bool isAlive(int snake) const; // Whether the snake is on the board
+	int getLength(int snake) const; // Gets the number of segments of the snake, 0 when dead
+	int getScore(int snake) const; // Gets the food the snake has eaten since it last spawned
+	SnakeDirection getDirection(int snake) const; // Gets the direction the snake is moving in
+	Cell getHead(int snake) const; // Gets the square of the snake's head, the snake must be alive
+	Cell getSegment(int snake, int i) const; // Gets the square of the ith segment from the head, 0 <= i < getLength()
+	int getFoodCount() const; // Gets the number of food items
+	Cell getFood(int food) const; // Gets the square of a food item, {-1, -1} while the board is too full to place it
+	bool hasFood(Cell cell) const; // Whether there is food on the square
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include "autopilot.h"
+#include "profiler.h"
+
+using namespace snakelinkedlist;
+
+int Autopilot::indexOf(Cell cell) const {
+	return cell.y * board_.columns + cell.x;
+}
+
+Cell Autopilot::cellOf(int square) const {
+	return Cell{square % board_.columns, square / board_.columns};
+}
+
+/*
+After one step of the same game the body is the old body with a new head and possibly without its tail, so only
+the head's square needs its move number. Anything else (the first plan, a new game, a resize, a load, ticks the
+autopilot didn't see) renumbers the body from the tail to the head, so the head wins where a dead snake overlaps
+*/
+void Autopilot::observe(const Simulation& game) {
+	const RingBuffer<Cell>& body = game.getSnake().getBody();
+	BoardSize board = game.getBoardSize();
+	Cell head = body.front();
+	bool same_game = tick_ >= 0 && board.columns == board_.columns && board.rows == board_.rows &&
+		game.getSeed() == seed_;
+	if (same_game && game.getTickCount() == tick_) {
+		return;
+	}
+
+	bool one_step = same_game && game.getTickCount() == tick_ + 1 &&
+		(body.size() > 1 ? body[1] == head_ : std::abs(head.x - head_.x) + std::abs(head.y - head_.y) == 1);
+	board_ = board;
+	seed_ = game.getSeed();
+	tick_ = game.getTickCount();
+	head_ = head;
+	if (one_step) {
+		entered_[indexOf(head)] = ++moves_;
+		return;
+	}
+
+	size_t squares = static_cast<size_t>(board.columns) * board.rows;
+	if (entered_.size() != squares) {
+		entered_.assign(squares, 0);
+		visited_.assign(squares, 0);
+		parent_.assign(squares, -1);
+		arrival_.assign(squares, 0);
+		frontier_.reserve(squares);
+		path_.reserve(squares);
+		search_ = 0;
+		if (squares <= kmax_bitboard_squares) {
+			runtime_board_ = RuntimeBoard(board);
+		}
+	}
+	moves_ = static_cast<uint32_t>(body.size());
+	for (size_t i = body.size(); i-- > 0;) {
+		entered_[indexOf(body[i])] = moves_ - static_cast<uint32_t>(i);
+	}
+	path_.clear();
+	target_ = Cell{-1, -1};
+}
+
+// Segment i from the head entered its square i moves ago, and the tail leaves one square per move from now on,
+// one move later if the snake is about to grow
+int Autopilot::expiresAt(const Simulation& game, int square, int growth) const {
+	if (game.getSnake().getOccupancy().count(cellOf(square)) == 0) {
+		return 0;
+	}
+	int segment = static_cast<int>(moves_ - entered_[square]);
+	return static_cast<int>(game.getSnake().getBody().size()) - segment + growth;
+}
+
+void Autopilot::beginSearch(Cell goal) {
+	if (++search_ == 0) {
+		std::fill(visited_.begin(), visited_.end(), 0);
+		search_ = 1;
+	}
+	frontier_.clear();
+	goal_ = goal;
+	shortcut_ = std::numeric_limits<int>::max();
+}
+
+/*
+A square reached before its segment leaves isn't marked, a longer way round may still reach it in time. The search
+doesn't wait for it, so a later search (with the body further along) may find a way through it, but never one
+shorter than the square's expiry plus its distance to the goal, which is what shortcut_ keeps the least of
+*/
+void Autopilot::reach(const Simulation& game, int square, int parent, int arrival, int growth) {
+	if (visited_[square] == search_) {
+		return;
+	}
+	int expires = expiresAt(game, square, growth);
+	if (expires > arrival) {
+		if (goal_.x >= 0) {
+			Cell cell = cellOf(square);
+			shortcut_ = std::min(shortcut_, expires + std::abs(cell.x - goal_.x) + std::abs(cell.y - goal_.y));
+		}
+		return;
+	}
+	visited_[square] = search_;
+	parent_[square] = parent;
+	arrival_[square] = arrival;
+	frontier_.push_back(square);
+}
+
+int Autopilot::search(const Simulation& game, int growth, int target, int limit) {
+	const OccupancyGrid& occupancy = game.getSnake().getOccupancy();
+	size_t next = 0;
+	while (next < frontier_.size() && static_cast<int>(frontier_.size()) < limit) {
+		if (target >= 0 && visited_[target] == search_) {
+			break;
+		}
+		int square = frontier_[next++];
+		Cell cell = cellOf(square);
+		for (int direction = 0; direction < 4; direction++) {
+			Cell next = neighbour(cell, static_cast<SnakeDirection>(direction));
+			if (occupancy.inBounds(next)) {
+				reach(game, indexOf(next), square, arrival_[square] + 1, growth);
+			}
+		}
+	}
+	return static_cast<int>(frontier_.size());
+}
+
+// The snake can't reverse, and the search never goes back through the head's own square
+void Autopilot::seedFrontier(const Simulation& game, int growth, Cell goal) {
+	const Snake& snake = game.getSnake();
+	Cell head = snake.getHeadCell();
+	SnakeDirection reverse = kopposite[snake.getDirection()];
+	beginSearch(goal);
+	visited_[indexOf(head)] = search_;
+	shortcut_ = static_cast<int>(snake.getBody().size()) + growth + std::abs(head.x - goal.x) + std::abs(head.y - goal.y);
+	for (int direction = 0; direction < 4; direction++) {
+		Cell next = neighbour(head, static_cast<SnakeDirection>(direction));
+		if (direction != reverse && snake.getOccupancy().inBounds(next)) {
+			reach(game, indexOf(next), -1, 1, growth);
+		}
+	}
+}
+
+SnakeDirection Autopilot::directionTo(Cell from, int square) const {
+	Cell to = cellOf(square);
+	if (to.x != from.x) {
+		return to.x > from.x ? RIGHT : LEFT;
+	}
+	return to.y > from.y ? DOWN : UP;
+}
+
+/*
+The body goes on the board as it is, and before each pass the segment whose expiry (see expiresAt()) is the move
+that pass reaches comes off, unless a segment nearer the head has entered its square since. The head's own square
+never comes off, the search doesn't go back through it either
+*/
+template<typename BoardType>
+int Autopilot::roomOn(BoardType& board, const Simulation& game, Cell next, int growth, int limit) {
+	const RingBuffer<Cell>& body = game.getSnake().getBody();
+	int length = static_cast<int>(body.size());
+	board.clearAll();
+	for (int i = 0; i < length; i++) {
+		board.set(body[i]);
+	}
+	return board.reachableArea(next, limit, [&](int steps) {
+		int segment = length + growth - (steps + 1);
+		if (segment > 0 && segment < length && moves_ - entered_[indexOf(body[segment])] == static_cast<uint32_t>(segment)) {
+			board.clear(body[segment]);
+		}
+	});
+}
+
+int Autopilot::roomAfter(const Simulation& game, Cell next, int growth, int limit) {
+	if (board_.columns == 16 && board_.rows == 16) {
+		return roomOn(board16_, game, next, growth, limit);
+	} else if (board_.columns == 32 && board_.rows == 32) {
+		return roomOn(board32_, game, next, growth, limit);
+	} else if (board_.columns == 64 && board_.rows == 64) {
+		return roomOn(board64_, game, next, growth, limit);
+	} else if (static_cast<long long>(board_.columns) * board_.rows <= kmax_bitboard_squares) {
+		return roomOn(runtime_board_, game, next, growth, limit);
+	}
+	beginSearch(Cell{-1, -1});
+	visited_[indexOf(game.getSnake().getHeadCell())] = search_;
+	reach(game, indexOf(next), -1, 1, growth);
+	return std::min(search(game, growth, -1, limit), limit);
+}
+
+/*
+Counts the squares reachable after each legal move, trying the current direction first so ties keep the snake going
+straight. Room for the whole body is as good as any, so counting stops there and a long snake on a big board
+doesn't flood the whole board three times
+*/
+SnakeDirection Autopilot::mostRoom(const Simulation& game, int growth) {
+	const Snake& snake = game.getSnake();
+	Cell head = snake.getHeadCell();
+	SnakeDirection current = snake.getDirection();
+	int limit = static_cast<int>(snake.getBody().size()) + 1;
+	SnakeDirection best = current;
+	int best_room = 0;
+	for (int i = 0; i < 4; i++) {
+		SnakeDirection direction = static_cast<SnakeDirection>((current + i) % 4);
+		Cell next = neighbour(head, direction);
+		if (direction == kopposite[current] || !snake.getOccupancy().inBounds(next)) {
+			continue;
+		}
+		int room = roomAfter(game, next, growth, limit);
+		if (room > best_room) {
+			best = direction;
+			best_room = room;
+		}
+	}
+	return best;
+}
+
+/*
+1. Brings the move numbers up to date (see observe())
+2. Follows the last path if the head is where it said and the food hasn't moved
+3. Otherwise searches for the food, and failing that makes the move with the most room
+A snake whose head is on the food grows on the next tick and the food moves somewhere unknown yet, so that tick
+also makes the move with the most room
+*/
+SnakeDirection Autopilot::plan(const Simulation& game) {
+	if (game.getState() != IN_PROGRESS) {
+		return game.getSnake().getDirection();
+	}
+	SNAKE_PROFILE_SCOPE("autopilot/plan");
+	observe(game);
+	Cell head = game.getSnake().getHeadCell();
+	Cell food = game.getFood().getCell();
+	int growth = (head == food) ? 1 : 0;
+
+	if (!growth && shortest_ && food == target_ && path_next_ + 1 < path_.size() && path_[path_next_] == indexOf(head)) {
+		reuses_++;
+		path_next_++;
+		return directionTo(head, path_[path_next_]);
+	}
+
+	searches_++;
+	path_.clear();
+	target_ = Cell{-1, -1};
+	if (!growth) {
+		int target = indexOf(food);
+		seedFrontier(game, growth, food);
+		search(game, growth, target, static_cast<int>(visited_.size()) + 1);
+		if (visited_[target] == search_) {
+			for (int square = target; square >= 0; square = parent_[square]) {
+				path_.push_back(square);
+			}
+			std::reverse(path_.begin(), path_.end());
+			path_next_ = 0;
+			target_ = food;
+			shortest_ = static_cast<int>(path_.size()) <= shortcut_;
+			return directionTo(head, path_[0]);
+		}
+	}
+	return mostRoom(game, growth);
+}
+
+bool Autopilot::hasPath() const {
+	return !path_.empty();
+}
+
+int Autopilot::getPathLength() const {
+	return path_.empty() ? 0 : static_cast<int>(path_.size() - path_next_);
+}
+
+void Autopilot::forget() {
+	tick_ = -1;
+	path_.clear();
+	target_ = Cell{-1, -1};
+}
+
+long long Autopilot::getSearches() const {
+	return searches_;
+}
+
+long long Autopilot::getReuses() const {
+	return reuses_;
+}
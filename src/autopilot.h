@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "board.h"
+#include "game_types.h"
+#include "simulation.h"
+
+namespace snakelinkedlist {
+
+/*
+Steers a Simulation towards its food, e.g. for soak tests, attract mode or as a GameRunner policy.
+
+plan() finds the shortest path from the head to the food with a breadth first search over the board. The body is
+treated as obstacles that expire: segment i from the head leaves its square after length - i moves, so the search
+may enter a body square as long as it arrives there no earlier than that. When no path reaches the food it takes
+the legal move with the most room to move in (counted the same way), so it puts off dying as long as it can see.
+On boards of up to kmax_bitboard_squares the room is flood filled on a bitboard (board.h) with the tail moving on
+one square per pass, a word of 64 squares at a time, a Board<W, H> on the tournament sizes.
+
+Little changes between two ticks, so little is redone:
+- When the snake followed the last plan and the food hasn't moved, the rest of the path is still valid (every
+  arrival and every expiry came one move closer) and plan() returns its next step without searching. Squares the
+  body frees as it moves can open a shorter way though, so this is only done when the search showed that no
+  square it had to pass up could lead to one
+- When a search is needed the move number each square was entered on is already known, it is updated by one
+  square per tick rather than rebuilt from the body, so a search only costs the squares it visits
+- The search's arrays are marked with a number that changes every search instead of being cleared
+A new game, a load or anything else that doesn't look like one step of the last game starts over from the body.
+*/
+class Autopilot {
+private:
+	// The game as of the last plan(), to tell whether it has only moved one step since
+	BoardSize board_ = {0, 0};
+	uint32_t seed_ = 0;
+	long long tick_ = -1; // -1 before the first plan()
+	Cell head_ = {0, 0};
+
+	uint32_t moves_ = 0; // Move number the head entered its square on
+	std::vector<uint32_t> entered_; // Move number each square was last entered on, only meaningful while it is covered
+
+	// Search state, indexed by row by row square
+	uint32_t search_ = 0; // Changes every search, a square was reached by this search when its visited_ matches
+	std::vector<uint32_t> visited_;
+	std::vector<int> parent_; // Square the search came from, -1 for the first step
+	std::vector<int> arrival_; // Moves from the head to the square
+	std::vector<int> frontier_; // Squares in the order they were reached, the search's queue
+	Cell goal_ = {-1, -1}; // Square the search is looking for, {-1, -1} when it only counts room
+	int shortcut_ = 0; // Shortest a path through a square the search had to pass up could be, see reach()
+
+	// Bitboards mostRoom() counts room on, a Board for each tournament size and a RuntimeBoard for other small boards.
+	// Every pass over a board costs the same, so past kmax_bitboard_squares the search is cheaper
+	static const int kmax_bitboard_squares = 64 * 64;
+	Board<16, 16> board16_;
+	Board<32, 32> board32_;
+	Board<64, 64> board64_;
+	RuntimeBoard runtime_board_ = RuntimeBoard(BoardSize{0, 0}); // Sized by observe() when the board changes
+
+	std::vector<int> path_; // Squares from the head's next square to the food
+	size_t path_next_ = 0; // Entry of path_ the head should be on now that it has moved
+	Cell target_ = {-1, -1}; // The food path_ leads to
+	bool shortest_ = false; // Whether no later search can find a shorter way, so following path_ is as good as searching again
+
+	long long searches_ = 0;
+	long long reuses_ = 0;
+
+	int indexOf(Cell cell) const; // Row by row index of a square on the board
+	Cell cellOf(int square) const; // The square with a row by row index
+	void observe(const Simulation& game); // Brings entered_ up to date with the game, one square if it only moved
+	int expiresAt(const Simulation& game, int square, int growth) const; // Moves until a square can be entered, 0 if empty
+	void beginSearch(Cell goal); // Starts a new search for goal ({-1, -1} to only count room) with an empty frontier
+	void reach(const Simulation& game, int square, int parent, int arrival, int growth); // Adds a square to the frontier if it can be entered then
+	int search(const Simulation& game, int growth, int target, int limit); // Expands the frontier until target is reached or limit squares were, returns squares reached
+	void seedFrontier(const Simulation& game, int growth, Cell goal); // Starts a search for goal from the squares the head can move to next
+	SnakeDirection directionTo(Cell from, int square) const; // Direction of a neighbouring square
+	template<typename BoardType>
+	int roomOn(BoardType& board, const Simulation& game, Cell next, int growth, int limit); // Squares reachable after moving to next, up to limit
+	int roomAfter(const Simulation& game, Cell next, int growth, int limit); // The same on whichever board fits the game
+	SnakeDirection mostRoom(const Simulation& game, int growth); // The legal move with the most reachable squares
+
+public:
+	SnakeDirection plan(const Simulation& game); // Direction the snake should move in on the next tick
+	bool hasPath() const; // Whether the last plan() leads to the food
+	int getPathLength() const; // Moves left to the food on the current path, 0 without one
+	void forget(); // Drops everything kept between ticks, the next plan() starts from scratch
+	long long getSearches() const; // Plans that searched the board
+	long long getReuses() const; // Plans that followed the previous path
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,264 @@
+#include "batch_simulation.h"
+
+using namespace snakelinkedlist;
+
+// The board is measured exactly like Simulation measures it, a board the batch can't play on gets no games
+BatchSimulation::BatchSimulation(int game_count, int board_width, int board_height, uint32_t seed)
+	: game_count_(fitsBoard(boardForWindow(board_width, board_height)) ? game_count : 0),
+	  head_x_(game_count_),
+	  head_y_(game_count_),
+	  direction_(game_count_),
+	  pending_turn_(game_count_),
+	  length_(game_count_),
+	  food_x_(game_count_),
+	  food_y_(game_count_),
+	  alive_(game_count_),
+	  ate_(game_count_),
+	  on_board_(game_count_),
+	  body_head_(game_count_),
+	  free_count_(game_count_) {
+	BoardSize board = boardForWindow(board_width, board_height);
+	columns_ = board.columns;
+	rows_ = board.rows;
+	squares_ = (game_count_ > 0) ? columns_ * rows_ : 0;
+
+	body_capacity_ = 2;
+	while (body_capacity_ < static_cast<size_t>(squares_) + 1) {
+		body_capacity_ <<= 1;
+	}
+	body_mask_ = body_capacity_ - 1;
+
+	counts_.resize(static_cast<size_t>(game_count_) * squares_);
+	free_squares_.resize(counts_.size());
+	free_position_.resize(counts_.size());
+	body_.resize(static_cast<size_t>(game_count_) * body_capacity_);
+
+	generators_.reserve(game_count_);
+	for (int game = 0; game < game_count_; game++) {
+		generators_.push_back(Random(seed + static_cast<uint32_t>(game)));
+		reset(game);
+	}
+}
+
+bool BatchSimulation::fitsBoard(BoardSize board) {
+	return board.columns >= 1 && board.rows >= kmin_rows_ &&
+		static_cast<long long>(board.columns) * board.rows <= kmax_squares;
+}
+
+/*
+Same starting position as Snake: length 1 on the third row, moving right, with food on a random empty square
+*/
+void BatchSimulation::reset(int game) {
+	size_t plane = static_cast<size_t>(game) * squares_;
+	for (int square = 0; square < squares_; square++) {
+		counts_[plane + square] = 0;
+		free_squares_[plane + square] = static_cast<uint16_t>(square);
+		free_position_[plane + square] = static_cast<uint16_t>(square);
+	}
+	free_count_[game] = squares_;
+
+	head_x_[game] = 0;
+	head_y_[game] = 2;
+	direction_[game] = RIGHT;
+	pending_turn_[game] = kno_turn_;
+	length_[game] = 1;
+	alive_[game] = 1;
+	ate_[game] = 0;
+	on_board_[game] = 1;
+
+	int start = head_y_[game] * columns_ + head_x_[game];
+	body_head_[game] = 0;
+	body_[static_cast<size_t>(game) * body_capacity_] = static_cast<uint16_t>(start);
+	addSquare(game, start);
+	placeFood(game);
+}
+
+void BatchSimulation::addSquare(int game, int square) {
+	size_t plane = static_cast<size_t>(game) * squares_;
+	if (counts_[plane + square]++ == 0) {
+		// Swap remove from the empty squares, exactly like OccupancyGrid::markOccupied()
+		uint16_t position = free_position_[plane + square];
+		uint16_t last = free_squares_[plane + --free_count_[game]];
+		free_squares_[plane + position] = last;
+		free_position_[plane + last] = position;
+		free_position_[plane + square] = kno_position_;
+	}
+}
+
+void BatchSimulation::removeSquare(int game, int square) {
+	size_t plane = static_cast<size_t>(game) * squares_;
+	if (--counts_[plane + square] == 0) {
+		int position = free_count_[game]++;
+		free_squares_[plane + position] = static_cast<uint16_t>(square);
+		free_position_[plane + square] = static_cast<uint16_t>(position);
+	}
+}
+
+// The same draws as SnakeFood::rebase(): one for the square, then three for the color
+void BatchSimulation::placeFood(int game) {
+	Random& generator = generators_[game];
+	if (free_count_[game] > 0) {
+		uint16_t square = free_squares_[static_cast<size_t>(game) * squares_ + generator.below(free_count_[game])];
+		food_x_[game] = square % columns_;
+		food_y_[game] = square / columns_;
+	}
+
+	for (int channel = 0; channel < 3; channel++) {
+		generator.below(256);
+	}
+}
+
+/*
+Advances every game in progress by one step, in the same order Simulation::tick() applies its rules:
+0. Apply the queued turn, if it is legal
+1. Check if the head is on the food, and if so grow the snake
+2. Move the head one square and drop the tail, unless the snake grew
+    * If the snake ate, move the food to a new random empty square
+3. End the game if the head left the board or ran into the body
+*/
+int BatchSimulation::tick() {
+	moveHeads();
+	updateBodies();
+	return checkDeaths();
+}
+
+void BatchSimulation::moveHeads() {
+	for (int game = 0; game < game_count_; game++) {
+		// Turns are only legal onto the other axis, UP and DOWN are the two vertical directions
+		uint8_t direction = direction_[game];
+		uint8_t turn = pending_turn_[game];
+		bool legal = turn != kno_turn_ && (turn < 2) != (direction < 2);
+		direction = legal ? turn : direction;
+		direction_[game] = direction;
+		pending_turn_[game] = kno_turn_;
+
+		int alive = alive_[game];
+		int x = head_x_[game];
+		int y = head_y_[game];
+		uint8_t ate = alive & (x == food_x_[game]) & (y == food_y_[game]);
+		ate_[game] = ate;
+		length_[game] += ate;
+
+		x += alive * kdirection_dx[direction];
+		y += alive * kdirection_dy[direction];
+		head_x_[game] = x;
+		head_y_[game] = y;
+		on_board_[game] = (x >= 0) & (y >= 0) & (x < columns_) & (y < rows_);
+	}
+}
+
+void BatchSimulation::updateBodies() {
+	for (int game = 0; game < game_count_; game++) {
+		if (!alive_[game]) {
+			continue;
+		}
+
+		size_t ring = static_cast<size_t>(game) * body_capacity_;
+		if (ate_[game]) {
+			// Snake::eatFood() adds a tail square behind the old tail that update() removes again straight away.
+			// That only matters when the square was empty: OccupancyGrid takes it out of the empty squares and appends
+			// it back at the end, which changes where the next food can land
+			uint16_t tail = body_[ring + ((body_head_[game] + length_[game] - 2) & body_mask_)];
+			int direction = direction_[game];
+			int behind_x = tail % columns_ - kdirection_dx[direction];
+			int behind_y = tail / columns_ - kdirection_dy[direction];
+			if (behind_x >= 0 && behind_y >= 0 && behind_x < columns_ && behind_y < rows_) {
+				int behind = behind_y * columns_ + behind_x;
+				if (counts_[static_cast<size_t>(game) * squares_ + behind] == 0) {
+					addSquare(game, behind);
+					removeSquare(game, behind);
+				}
+			}
+		} else {
+			removeSquare(game, body_[ring + ((body_head_[game] + length_[game] - 1) & body_mask_)]);
+		}
+
+		if (on_board_[game]) {
+			int head = head_y_[game] * columns_ + head_x_[game];
+			body_head_[game] = (body_head_[game] - 1) & body_mask_;
+			body_[ring + body_head_[game]] = static_cast<uint16_t>(head);
+			addSquare(game, head);
+		}
+
+		if (ate_[game]) {
+			placeFood(game);
+		}
+	}
+}
+
+int BatchSimulation::checkDeaths() {
+	int ended = 0;
+	for (int game = 0; game < game_count_; game++) {
+		int alive = alive_[game];
+		int collided = 0;
+		if (on_board_[game]) {
+			collided = counts_[static_cast<size_t>(game) * squares_ + head_y_[game] * columns_ + head_x_[game]] > 1;
+		}
+		int survives = alive & on_board_[game] & !collided;
+		ended += alive & !survives;
+		alive_[game] = static_cast<uint8_t>(survives);
+	}
+	return ended;
+}
+
+void BatchSimulation::queueTurn(int game, SnakeDirection new_direction) {
+	pending_turn_[game] = static_cast<uint8_t>(new_direction);
+}
+
+int BatchSimulation::getGameCount() const {
+	return game_count_;
+}
+
+int BatchSimulation::getAliveCount() const {
+	int alive = 0;
+	for (int game = 0; game < game_count_; game++) {
+		alive += alive_[game];
+	}
+	return alive;
+}
+
+int BatchSimulation::getColumns() const {
+	return columns_;
+}
+
+int BatchSimulation::getRows() const {
+	return rows_;
+}
+
+bool BatchSimulation::isAlive(int game) const {
+	return alive_[game] != 0;
+}
+
+int BatchSimulation::getLength(int game) const {
+	return length_[game];
+}
+
+int BatchSimulation::getScore(int game) const {
+	return length_[game] - 1;
+}
+
+SnakeDirection BatchSimulation::getDirection(int game) const {
+	return static_cast<SnakeDirection>(direction_[game]);
+}
+
+Cell BatchSimulation::getHead(int game) const {
+	Cell head;
+	head.x = head_x_[game];
+	head.y = head_y_[game];
+	return head;
+}
+
+Cell BatchSimulation::getSegment(int game, int i) const {
+	uint16_t square = body_[static_cast<size_t>(game) * body_capacity_ + ((body_head_[game] + i) & body_mask_)];
+	Cell segment;
+	segment.x = square % columns_;
+	segment.y = square / columns_;
+	return segment;
+}
+
+Cell BatchSimulation::getFood(int game) const {
+	Cell food;
+	food.x = food_x_[game];
+	food.y = food_y_[game];
+	return food;
+}
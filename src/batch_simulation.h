@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game_types.h"
+#include "occupancy_grid.h"
+#include "random.h"
+
+namespace snakelinkedlist {
+
+/*
+Steps many independent games in lockstep for batch runs such as policy evaluation.
+Every game follows exactly the rules of Simulation::tick() on the same board, but the games are stored as
+parallel arrays (heads, directions, lengths, food, alive flags) and each tick runs one pass per rule over all of them:
+turning and moving, updating the bodies, then checking for deaths. The per game passes are plain loops over
+small integers the compiler can vectorize, only the body update has to touch each game's own grid.
+
+Positions are whole board squares rather than pixels. Each game owns a slice of a few shared planes:
+its body as a ring of square indices, a segment count per square, and the dense list of empty squares that food is
+drawn from, kept in the same order OccupancyGrid would keep it. Food is placed with the same draws as SnakeFood,
+so game i of a batch seeded with s plays out exactly like a Simulation seeded with s + i given the same turns.
+
+Boards may have at most kmax_squares squares, square indices are kept in 16 bits, and must be at least three rows
+high so the snake starts on the board. A batch asked for any other board is created with no games (see fitsBoard()).
+*/
+class BatchSimulation {
+private:
+	static const uint8_t kno_turn_ = 0xff; // pending_turn_ value when no turn was queued
+	static const uint16_t kno_position_ = 0xffff; // free_position_ value of an occupied square
+	static const int kmin_rows_ = 3; // The snake starts on the third row
+
+	int game_count_; // Number of games in the batch
+	int columns_; // Board width in squares
+	int rows_; // Board height in squares
+	int squares_; // columns_ * rows_, the stride of the per square planes, 0 in a batch with no games
+	size_t body_capacity_; // Ring slots per game, a power of two larger than the board
+	size_t body_mask_; // body_capacity_ - 1
+
+	// One entry per game
+	std::vector<int> head_x_; // Column of the head
+	std::vector<int> head_y_; // Row of the head
+	std::vector<uint8_t> direction_; // SnakeDirection the snake is moving in
+	std::vector<uint8_t> pending_turn_; // Turn to try on the next tick, kno_turn_ if none
+	std::vector<int> length_; // Number of body segments, the score is length - 1
+	std::vector<int> food_x_; // Column of the food
+	std::vector<int> food_y_; // Row of the food
+	std::vector<uint8_t> alive_; // 1 while the game is in progress
+	std::vector<uint8_t> ate_; // Set by the move pass when the head was on the food before moving
+	std::vector<uint8_t> on_board_; // Set by the move pass when the new head is on the board
+	std::vector<size_t> body_head_; // Ring slot of the head
+	std::vector<int> free_count_; // Number of empty squares
+	std::vector<Random> generators_; // Food generator, drawn from like SnakeFood's. Food colors are not kept but still drawn
+
+	// squares_ entries per game
+	std::vector<uint8_t> counts_; // Segments covering each square
+	std::vector<uint16_t> free_squares_; // Every empty square, the first free_count_ entries are valid
+	std::vector<uint16_t> free_position_; // Where each square sits in free_squares_
+
+	// body_capacity_ entries per game
+	std::vector<uint16_t> body_; // Square index of every segment, from body_head_ towards the tail
+
+	void moveHeads(); // Applies pending turns, checks for food and moves every head one square
+	void updateBodies(); // Moves each body onto its new head and places new food where a snake ate
+	int checkDeaths(); // Ends the games whose head left the board or ran into the body, returns how many ended
+
+	void addSquare(int game, int square); // A segment entered the square
+	void removeSquare(int game, int square); // A segment left the square
+	void placeFood(int game); // Moves the food to a random empty square
+
+public:
+	static const int kmax_squares = 0xffff; // Largest board, every square index and position has to stay below kno_position_
+
+	BatchSimulation(int game_count, int board_width, int board_height, uint32_t seed); // Starts game_count new games seeded seed, seed + 1, ... on a board of the given size in pixels, none if fitsBoard() rejects it
+	static bool fitsBoard(BoardSize board); // Whether the batch can play on a board, see the limits above
+
+	int tick(); // Advances every game in progress by one step, returns how many games ended on this step
+	void queueTurn(int game, SnakeDirection new_direction); // Tries the turn on the game's next tick, replaces any turn already queued
+	void reset(int game); // Starts a new game in the slot, keeping its food generator
+
+	int getGameCount() const; // Gets the number of games in the batch
+	int getAliveCount() const; // Gets the number of games in progress
+	int getColumns() const; // Gets the board width in squares
+	int getRows() const; // Gets the board height in squares
+	bool isAlive(int game) const; // Whether the game is still in progress
+	int getLength(int game) const; // Gets the length of the game's snake
+	int getScore(int game) const; // Gets the number of food items the game's snake has eaten
+	SnakeDirection getDirection(int game) const; // Gets the direction the game's snake is moving in
+	Cell getHead(int game) const; // Gets the square of the game's snake head
+	Cell getSegment(int game, int i) const; // Gets the square of the ith segment from the head, 0 <= i < getLength()
+	Cell getFood(int game) const; // Gets the square of the game's food
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace snakelinkedlist {
+
+/*
+Appends plain values to a byte buffer in their in memory representation.
+Files written this way are only read back on the same kind of machine (every platform the game targets is
+little endian with IEEE floats), which keeps writing and reading a straight memory copy.
+*/
+class BinaryWriter {
+private:
+	std::vector<uint8_t>& bytes_; // Buffer being appended to
+
+public:
+	explicit BinaryWriter(std::vector<uint8_t>& bytes) : bytes_(bytes) {};
+
+	template<typename T>
+	void write(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+		writeBytes(&value, sizeof(T));
+	}
+
+	void writeBytes(const void* data, size_t size) {
+		const uint8_t* begin = static_cast<const uint8_t*>(data);
+		bytes_.insert(bytes_.end(), begin, begin + size);
+	}
+};
+
+/*
+Reads back what a BinaryWriter wrote. Every read is bounds checked: once a read runs past the end the reader fails,
+all further reads fail too and the values read are left zeroed, so callers can check ok() once at the end.
+Values are copied out, so the data does not have to be aligned (e.g. when it points into a mapped file).
+*/
+class BinaryReader {
+private:
+	const uint8_t* data_; // Start of the data
+	size_t size_; // Bytes available
+	size_t position_ = 0; // Next byte to read
+	bool ok_ = true; // False once a read ran past the end
+
+public:
+	BinaryReader(const uint8_t* data, size_t size) : data_(data), size_(size) {};
+
+	template<typename T>
+	bool read(T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read");
+		return readBytes(&value, sizeof(T));
+	}
+
+	bool readBytes(void* out, size_t size) {
+		if (!ok_ || size > size_ - position_) {
+			ok_ = false;
+			std::memset(out, 0, size);
+			return false;
+		}
+		std::memcpy(out, data_ + position_, size);
+		position_ += size;
+		return true;
+	}
+
+	bool ok() const { return ok_; }
+	size_t getPosition() const { return position_; }
+	size_t remaining() const { return size_ - position_; } // Bytes left to read, used to reject counts that can't fit
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,307 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "game_types.h"
+#include "occupancy_grid.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace snakelinkedlist {
+
+// Number of set bits in a word
+inline int popcount64(uint64_t word) {
+#if defined(_MSC_VER)
+	return static_cast<int>(__popcnt64(word));
+#else
+	return __builtin_popcountll(word);
+#endif
+}
+
+// Size and storage of a board known at compile time (see Board), every index calculation folds to constants
+template<int Columns, int Rows>
+class FixedBoardGeometry {
+	static_assert(Columns > 0 && Rows > 0, "a board needs at least one square");
+
+public:
+	static const size_t kwords = (static_cast<size_t>(Columns) * Rows + 63) / 64;
+	typedef std::array<uint64_t, kwords> Words;
+
+	static constexpr int columns() { return Columns; }
+	static constexpr int rows() { return Rows; }
+	static constexpr size_t words() { return kwords; }
+	static void allocate(Words&) {} // Always the right size already
+};
+
+// Size and storage of a board only known when the game starts (see RuntimeBoard)
+class RuntimeBoardGeometry {
+private:
+	int columns_;
+	int rows_;
+
+public:
+	typedef std::vector<uint64_t> Words;
+
+	RuntimeBoardGeometry(BoardSize board) : columns_(board.columns), rows_(board.rows) {}
+	int columns() const { return columns_; }
+	int rows() const { return rows_; }
+	size_t words() const { return (static_cast<size_t>(columns_) * rows_ + 63) / 64; }
+	void allocate(Words& words) const { words.assign(this->words(), 0); }
+};
+
+/*
+Which squares of a board are taken, one bit per square packed row by row into 64 bit words (square y * columns + x
+is bit i % 64 of word i / 64). Bits past the last square are always clear.
+
+Moving one square is shifting the whole board by a fixed number of bits (kdirection_dx + kdirection_dy * columns),
+so questions about whole areas are answered a word, 64 squares, at a time. reachableArea() grows the set of
+squares reachable from a start by one step in all four directions per pass and counts it with popcount, a pass
+costs the same however many squares it adds. Horizontal steps are masked so they don't wrap onto the next row.
+
+Use Board<W, H> for boards whose size is fixed at compile time, e.g. tournament formats, where the number of words,
+the shifts and the masks are all constants, and RuntimeBoard for any other size. Both share this implementation.
+*/
+template<typename Geometry>
+class BasicBoard {
+private:
+	typedef typename Geometry::Words Words;
+
+	Geometry geometry_;
+	Words occupied_; // The bit of every square that is taken
+	Words valid_; // The bit of every square on the board
+	Words not_first_column_; // Squares a step right can land on, x != 0
+	Words not_last_column_; // Squares a step left can land on, x != columns - 1
+	mutable Words reached_; // reachableArea() scratch, kept so it never allocates
+	mutable Words next_;
+	Words added_; // Squares the last pass of the releasing reachableArea() added
+
+	// Word w of words shifted towards higher squares by bits (lower when negative), with zeros shifted in
+	uint64_t shifted(const Words& words, ptrdiff_t w, ptrdiff_t bits) const;
+
+public:
+	explicit BasicBoard(const Geometry& geometry = Geometry());
+
+	int getColumns() const { return geometry_.columns(); }
+	int getRows() const { return geometry_.rows(); }
+	bool inBounds(Cell cell) const; // Whether the square lies on the board
+	int indexOf(Cell cell) const { return cell.y * geometry_.columns() + cell.x; } // Row by row index of a square
+
+	bool test(Cell cell) const; // Whether the square is taken, false when off the board
+	void set(Cell cell); // Marks the square taken, ignored if it is off the board
+	void clear(Cell cell); // Marks the square empty, ignored if it is off the board
+	void clearAll(); // Marks every square empty
+	bool assign(const OccupancyGrid& occupancy); // Takes every covered square of a grid of the same size, false if the sizes differ
+	int count() const; // Number of squares taken
+
+	// Number of empty squares that can be reached from start through empty squares, counting start, 0 if start is
+	// off the board or taken. Stops once limit squares are reachable and returns limit
+	int reachableArea(Cell start, int limit) const;
+	int reachableArea(Cell start) const { return reachableArea(start, geometry_.columns() * geometry_.rows()); }
+
+	// The same on a board whose taken squares free up as the fill goes, e.g. a snake's body as its tail moves on: before
+	// adding the squares steps moves from start, release(steps) clears the squares that can be entered from then on
+	// (start is steps 0). A square is only entered from one the pass before added, nothing waits beside it to free up
+	template<typename Release>
+	int reachableArea(Cell start, int limit, Release release);
+};
+
+// A board whose size is part of its type, see BasicBoard
+template<int Columns, int Rows>
+using Board = BasicBoard<FixedBoardGeometry<Columns, Rows>>;
+
+// A board of any size, e.g. RuntimeBoard board(game.getBoardSize()), see BasicBoard
+typedef BasicBoard<RuntimeBoardGeometry> RuntimeBoard;
+
+template<typename Geometry>
+BasicBoard<Geometry>::BasicBoard(const Geometry& geometry) : geometry_(geometry) {
+	geometry_.allocate(occupied_);
+	geometry_.allocate(valid_);
+	geometry_.allocate(not_first_column_);
+	geometry_.allocate(not_last_column_);
+	geometry_.allocate(reached_);
+	geometry_.allocate(next_);
+	geometry_.allocate(added_);
+	clearAll();
+	for (size_t w = 0; w < geometry_.words(); w++) {
+		valid_[w] = not_first_column_[w] = not_last_column_[w] = 0;
+	}
+	int columns = geometry_.columns();
+	int squares = columns * geometry_.rows();
+	for (int i = 0; i < squares; i++) {
+		uint64_t bit = uint64_t(1) << (i % 64);
+		valid_[i / 64] |= bit;
+		if (i % columns != 0) {
+			not_first_column_[i / 64] |= bit;
+		}
+		if (i % columns != columns - 1) {
+			not_last_column_[i / 64] |= bit;
+		}
+	}
+}
+
+template<typename Geometry>
+uint64_t BasicBoard<Geometry>::shifted(const Words& words, ptrdiff_t w, ptrdiff_t bits) const {
+	ptrdiff_t count = static_cast<ptrdiff_t>(geometry_.words());
+	ptrdiff_t source = w - (bits >= 0 ? bits / 64 : -((-bits + 63) / 64));
+	int offset = static_cast<int>(bits >= 0 ? bits % 64 : (64 - (-bits % 64)) % 64);
+	uint64_t low = (source >= 0 && source < count) ? words[source] : 0;
+	if (offset == 0) {
+		return low;
+	}
+	uint64_t carry = (source - 1 >= 0 && source - 1 < count) ? words[source - 1] : 0;
+	return (low << offset) | (carry >> (64 - offset));
+}
+
+template<typename Geometry>
+bool BasicBoard<Geometry>::inBounds(Cell cell) const {
+	return cell.x >= 0 && cell.y >= 0 && cell.x < geometry_.columns() && cell.y < geometry_.rows();
+}
+
+template<typename Geometry>
+bool BasicBoard<Geometry>::test(Cell cell) const {
+	if (!inBounds(cell)) {
+		return false;
+	}
+	int i = indexOf(cell);
+	return (occupied_[i / 64] >> (i % 64)) & 1;
+}
+
+template<typename Geometry>
+void BasicBoard<Geometry>::set(Cell cell) {
+	if (inBounds(cell)) {
+		int i = indexOf(cell);
+		occupied_[i / 64] |= uint64_t(1) << (i % 64);
+	}
+}
+
+template<typename Geometry>
+void BasicBoard<Geometry>::clear(Cell cell) {
+	if (inBounds(cell)) {
+		int i = indexOf(cell);
+		occupied_[i / 64] &= ~(uint64_t(1) << (i % 64));
+	}
+}
+
+template<typename Geometry>
+void BasicBoard<Geometry>::clearAll() {
+	for (size_t w = 0; w < geometry_.words(); w++) {
+		occupied_[w] = 0;
+	}
+}
+
+template<typename Geometry>
+bool BasicBoard<Geometry>::assign(const OccupancyGrid& occupancy) {
+	if (occupancy.getColumns() != geometry_.columns() || occupancy.getRows() != geometry_.rows()) {
+		return false;
+	}
+	clearAll();
+	for (int y = 0; y < geometry_.rows(); y++) {
+		for (int x = 0; x < geometry_.columns(); x++) {
+			if (occupancy.count(Cell{x, y}) > 0) {
+				set(Cell{x, y});
+			}
+		}
+	}
+	return true;
+}
+
+template<typename Geometry>
+int BasicBoard<Geometry>::count() const {
+	int taken = 0;
+	for (size_t w = 0; w < geometry_.words(); w++) {
+		taken += popcount64(occupied_[w]);
+	}
+	return taken;
+}
+
+/*
+Each pass adds every empty square next to one already reached:
+	next = reached | right & not_first_column | left & not_last_column | down | up, only empty squares
+until a pass adds nothing. A square is reached on the pass equal to its distance from start, so the passes are at
+most the longest path in the area, each a handful of operations per word
+*/
+template<typename Geometry>
+int BasicBoard<Geometry>::reachableArea(Cell start, int limit) const {
+	if (!inBounds(start) || test(start)) {
+		return 0;
+	}
+	const ptrdiff_t words = static_cast<ptrdiff_t>(geometry_.words());
+	const ptrdiff_t columns = geometry_.columns();
+	Words* reached = &reached_;
+	Words* next = &next_;
+	for (ptrdiff_t w = 0; w < words; w++) {
+		(*reached)[w] = 0;
+	}
+	int i = indexOf(start);
+	(*reached)[i / 64] = uint64_t(1) << (i % 64);
+
+	int area = 1;
+	while (area < limit) {
+		int next_area = 0;
+		for (ptrdiff_t w = 0; w < words; w++) {
+			uint64_t grown = (*reached)[w] |
+				(shifted(*reached, w, kdirection_dx[RIGHT]) & not_first_column_[w]) |
+				(shifted(*reached, w, kdirection_dx[LEFT]) & not_last_column_[w]) |
+				shifted(*reached, w, kdirection_dy[DOWN] * columns) |
+				shifted(*reached, w, kdirection_dy[UP] * columns);
+			(*next)[w] = grown & valid_[w] & ~occupied_[w];
+			next_area += popcount64((*next)[w]);
+		}
+		std::swap(reached, next);
+		if (next_area == area) {
+			break;
+		}
+		area = next_area;
+	}
+	return area < limit ? area : limit;
+}
+
+/*
+Squares a snake could reach moving one square per pass, so unlike above a pass only grows from the squares the pass
+before added: a square that was still taken when the fill first came by isn't entered later from there
+	added = (last right & not_first_column | last left & not_last_column | last down | last up), only empty squares
+	        not reached before
+It gives the same squares as a breadth first search that checks each square against when it frees up on arrival
+*/
+template<typename Geometry>
+template<typename Release>
+int BasicBoard<Geometry>::reachableArea(Cell start, int limit, Release release) {
+	release(0);
+	if (!inBounds(start) || test(start)) {
+		return 0;
+	}
+	const ptrdiff_t words = static_cast<ptrdiff_t>(geometry_.words());
+	const ptrdiff_t columns = geometry_.columns();
+	Words* last = &next_;
+	Words* added = &added_;
+	for (ptrdiff_t w = 0; w < words; w++) {
+		reached_[w] = (*last)[w] = 0;
+	}
+	int i = indexOf(start);
+	reached_[i / 64] = (*last)[i / 64] = uint64_t(1) << (i % 64);
+
+	int area = 1;
+	for (int steps = 1; area < limit; steps++) {
+		release(steps);
+		int added_area = 0;
+		for (ptrdiff_t w = 0; w < words; w++) {
+			uint64_t grown = (shifted(*last, w, kdirection_dx[RIGHT]) & not_first_column_[w]) |
+				(shifted(*last, w, kdirection_dx[LEFT]) & not_last_column_[w]) |
+				shifted(*last, w, kdirection_dy[DOWN] * columns) |
+				shifted(*last, w, kdirection_dy[UP] * columns);
+			(*added)[w] = grown & valid_[w] & ~occupied_[w] & ~reached_[w];
+			reached_[w] |= (*added)[w];
+			added_area += popcount64((*added)[w]);
+		}
+		std::swap(last, added);
+		if (added_area == 0) {
+			break;
+		}
+		area += added_area;
+	}
+	return area < limit ? area : limit;
+}
+} // namespace snakelinkedlist
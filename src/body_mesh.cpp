@@ -0,0 +1,160 @@
+#include "body_mesh.h"
+
+using namespace snakelinkedlist;
+
+static Vec2 toVec2(Cell square) {
+	return Vec2(static_cast<float>(square.x), static_cast<float>(square.y));
+}
+
+// Quads are in board squares, the renderer scales them to the window when drawing
+void BodyMesh::writeQuad(size_t slot, Vec2 position) {
+	float left = position.x;
+	float top = position.y;
+	float right = position.x + 1;
+	float bottom = position.y + 1;
+	float quad[kvertices_per_quad * kfloats_per_vertex] = {
+		left, top, right, top, right, bottom,
+		left, top, right, bottom, left, bottom
+	};
+
+	float* out = &vertices_[slot * kvertices_per_quad * kfloats_per_vertex];
+	for (int i = 0; i < kvertices_per_quad * kfloats_per_vertex; i++) {
+		out[i] = quad[i];
+	}
+	if (!full_upload_) {
+		dirty_slots_.push_back(slot);
+	}
+}
+
+void BodyMesh::writeColor(size_t index, Color color) {
+	const size_t floats = kvertices_per_quad * kfloats_per_color;
+	for (size_t copy = index; copy < 2 * capacity_; copy += capacity_) {
+		float* out = &colors_[copy * floats];
+		for (int v = 0; v < kvertices_per_quad; v++) {
+			out[v * kfloats_per_color] = color.r / 255.0f;
+			out[v * kfloats_per_color + 1] = color.g / 255.0f;
+			out[v * kfloats_per_color + 2] = color.b / 255.0f;
+			out[v * kfloats_per_color + 3] = 1.0f;
+		}
+		if (!full_upload_) {
+			dirty_colors_.push_back(copy);
+		}
+	}
+}
+
+void BodyMesh::rebuild(const Snake& snake) {
+	const RingBuffer<Cell>& body = snake.getBody();
+	const std::vector<Color>& body_colors = snake.getBodyColors();
+
+	capacity_ = body.capacity();
+	vertices_.assign(capacity_ * kvertices_per_quad * kfloats_per_vertex, 0.0f);
+	colors_.assign(2 * capacity_ * kvertices_per_quad * kfloats_per_color, 0.0f);
+	full_upload_ = true;
+	dirty_slots_.clear();
+	dirty_colors_.clear();
+
+	for (size_t i = 0; i < body.size(); i++) {
+		writeQuad(body.slotOf(i), toVec2(body[i]));
+		writeColor(i, body_colors[i]);
+	}
+	// The vacated tail square is drawn shrinking behind the tail, in the tail's color
+	writeColor(body.size(), body_colors.back());
+}
+
+/*
+Brings the mesh in line with the snake:
+1. If the ring was reallocated or the mesh invalidated, rebuild everything
+2. Otherwise write the final position of every square the head has passed through since the last sync
+   and of any segments added by eating, along with their colors
+3. Write the head and the vacated tail interpolated by alpha, these are the only quads that move between ticks
+*/
+void BodyMesh::sync(const Snake& snake, float alpha) {
+	const RingBuffer<Cell>& body = snake.getBody();
+	const std::vector<Color>& body_colors = snake.getBodyColors();
+	size_t head_slot = body.slotOf(0);
+
+	if (capacity_ != body.capacity() || body.size() < length_) {
+		rebuild(snake);
+	} else {
+		size_t steps = (head_slot_ - head_slot) & (capacity_ - 1);
+		for (size_t i = 1; i <= steps && i < body.size(); i++) {
+			writeQuad(body.slotOf(i), toVec2(body[i]));
+		}
+		if (body.size() != length_) {
+			for (size_t i = length_; i < body.size(); i++) {
+				writeQuad(body.slotOf(i), toVec2(body[i]));
+				writeColor(i, body_colors[i]);
+			}
+			writeColor(body.size(), body_colors.back());
+		}
+	}
+	head_slot_ = head_slot;
+	length_ = body.size();
+
+	Vec2 head_from = toVec2(snake.getPreviousPosition(0));
+	Vec2 head_to = toVec2(body.front());
+	writeQuad(head_slot, Vec2(head_from.x + (head_to.x - head_from.x) * alpha,
+		head_from.y + (head_to.y - head_from.y) * alpha));
+
+	Vec2 tail_from = toVec2(snake.getPreviousPosition(body.size() - 1));
+	Vec2 tail_to = toVec2(body.back());
+	writeQuad(body.slotOf(body.size()), Vec2(tail_from.x + (tail_to.x - tail_from.x) * alpha,
+		tail_from.y + (tail_to.y - tail_from.y) * alpha));
+
+	// Draw the body plus the vacated tail slot, split in two where the ring wraps around
+	size_t count = body.size() + 1;
+	if (head_slot + count <= capacity_) {
+		ranges_[0].first = head_slot;
+		ranges_[0].count = count;
+		range_count_ = 1;
+	} else {
+		ranges_[0].first = head_slot;
+		ranges_[0].count = capacity_ - head_slot;
+		ranges_[1].first = 0;
+		ranges_[1].count = count - ranges_[0].count;
+		range_count_ = 2;
+	}
+}
+
+void BodyMesh::invalidate() {
+	capacity_ = 0;
+}
+
+void BodyMesh::clearDirty() {
+	full_upload_ = false;
+	dirty_slots_.clear();
+	dirty_colors_.clear();
+}
+
+const std::vector<float>& BodyMesh::getVertices() const {
+	return vertices_;
+}
+
+const std::vector<float>& BodyMesh::getColors() const {
+	return colors_;
+}
+
+bool BodyMesh::needsFullUpload() const {
+	return full_upload_;
+}
+
+const std::vector<size_t>& BodyMesh::getDirtySlots() const {
+	return dirty_slots_;
+}
+
+const std::vector<size_t>& BodyMesh::getDirtyColors() const {
+	return dirty_colors_;
+}
+
+// Slot s has to show the color of body index (s - head) mod capacity, which sits at entry s + (capacity - head)
+size_t BodyMesh::getColorOffset() const {
+	return (capacity_ - head_slot_) & (capacity_ - 1);
+}
+
+size_t BodyMesh::getDrawRangeCount() const {
+	return range_count_;
+}
+
+BodyMesh::DrawRange BodyMesh::getDrawRange(size_t i) const {
+	return ranges_[i];
+}
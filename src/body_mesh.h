@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "snake.h"
+
+namespace snakelinkedlist {
+
+/*
+CPU side copy of the snake body as one triangle mesh with per vertex colors, laid out so that it can be
+drawn in a single call and kept up to date by rewriting only a handful of quads per frame.
+
+Quads are stored in the same slot order as the snake's RingBuffer, so a tick only writes the new head slot
+and the old tail slot simply falls out of the drawn range. Colors belong to a place in the body (head first)
+rather than a slot, so they are stored separately in body order, twice in a row: pointing the color attribute
+kcolor_offset() slots into that buffer lines the colors up with the rotated slots without rewriting any of them.
+
+Nothing here touches OpenGL, the renderer uploads the dirty ranges and issues the draw ranges.
+*/
+class BodyMesh {
+public:
+	static const int kvertices_per_quad = 6; // Two triangles per body square
+	static const int kfloats_per_vertex = 2; // x, y
+	static const int kfloats_per_color = 4; // r, g, b, a
+
+	// A run of quads to draw with one call, measured in slots
+	struct DrawRange {
+		size_t first;
+		size_t count;
+	};
+
+private:
+	std::vector<float> vertices_; // kvertices_per_quad * kfloats_per_vertex floats per ring slot
+	std::vector<float> colors_; // kvertices_per_quad * kfloats_per_color floats per body index, two copies of capacity_ entries
+	size_t capacity_ = 0; // Ring capacity the buffers were built for, 0 until the first sync
+	size_t head_slot_ = 0; // Ring slot of the head at the last sync
+	size_t length_ = 0; // Snake length at the last sync
+	bool full_upload_ = true; // The buffers were rebuilt and must be uploaded whole
+	std::vector<size_t> dirty_slots_; // Quads that changed since the last upload
+	std::vector<size_t> dirty_colors_; // Color entries that changed since the last upload
+	DrawRange ranges_[2]; // What to draw, the body wraps around the end of the ring at most once
+	size_t range_count_ = 0; // Number of entries in ranges_
+
+	void writeQuad(size_t slot, Vec2 position); // Fills in a one square quad and marks it dirty
+	void writeColor(size_t index, Color color); // Fills in both copies of a color entry and marks them dirty
+	void rebuild(const Snake& snake); // Rewrites every quad and color for the current body
+
+public:
+	void sync(const Snake& snake, float alpha); // Brings the mesh up to date with the snake, alpha interpolates the moving ends
+	void invalidate(); // Forces a full rebuild on the next sync, needed when the snake was replaced
+	void clearDirty(); // Call once the dirty ranges have been uploaded
+
+	const std::vector<float>& getVertices() const; // Quad vertices in ring slot order
+	const std::vector<float>& getColors() const; // Vertex colors in body order, two copies
+	bool needsFullUpload() const; // Whether the buffers were reallocated since the last upload
+	const std::vector<size_t>& getDirtySlots() const; // Quads to upload if a full upload isn't needed
+	const std::vector<size_t>& getDirtyColors() const; // Color entries to upload if a full upload isn't needed
+	size_t getColorOffset() const; // Offset in color entries to bind the color attribute at
+	size_t getDrawRangeCount() const; // Number of draw calls needed this frame, at most 2
+	DrawRange getDrawRange(size_t i) const; // The ith range of slots to draw
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,52 @@
+#include "fixed_timestep.h"
+
+using namespace snakelinkedlist;
+
+FixedTimestep::FixedTimestep(double steps_per_second, int max_steps_per_frame)
+	: step_seconds_(1.0 / steps_per_second),
+	  accumulator_(0),
+	  max_steps_per_frame_(max_steps_per_frame),
+	  dropped_steps_(0) {
+}
+
+int FixedTimestep::advance(double elapsed_seconds) {
+	accumulator_ += elapsed_seconds;
+
+	int steps = 0;
+	while (accumulator_ >= step_seconds_ && steps < max_steps_per_frame_) {
+		accumulator_ -= step_seconds_;
+		steps++;
+	}
+
+	// We fell too far behind to catch up, forget the backlog rather than running the game in fast forward
+	if (accumulator_ >= step_seconds_) {
+		dropped_steps_ += static_cast<long long>(accumulator_ / step_seconds_);
+		accumulator_ = 0;
+	}
+	return steps;
+}
+
+void FixedTimestep::defer(int steps) {
+	accumulator_ += steps * step_seconds_;
+}
+
+double FixedTimestep::alpha() const {
+	return accumulator_ / step_seconds_;
+}
+
+long long FixedTimestep::getDroppedSteps() const {
+	return dropped_steps_;
+}
+
+void FixedTimestep::reset() {
+	accumulator_ = 0;
+}
+
+void FixedTimestep::setStepsPerSecond(double steps_per_second) {
+	step_seconds_ = 1.0 / steps_per_second;
+	accumulator_ = 0;
+}
+
+double FixedTimestep::getStepsPerSecond() const {
+	return 1.0 / step_seconds_;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace snakelinkedlist {
+
+/*
+Fixed timestep accumulator that decouples the simulation rate from the render rate.
+Every frame the renderer reports how much time passed and gets back how many whole simulation steps to run,
+the leftover fraction of a step is kept for the next frame and exposed as alpha() for interpolating the drawing.
+*/
+class FixedTimestep {
+private:
+	double step_seconds_; // Length of one simulation step
+	double accumulator_; // Time that has passed but not been simulated yet, less than one step after advance() unless steps were deferred
+	int max_steps_per_frame_; // Cap on catch up steps so a long stall doesn't fast forward the game
+	long long dropped_steps_; // Steps forgotten because the game fell too far behind to catch up
+
+public:
+	explicit FixedTimestep(double steps_per_second, int max_steps_per_frame = 4);
+	int advance(double elapsed_seconds); // Adds elapsed time and returns the number of steps that are now due
+	void defer(int steps); // Puts back steps advance() returned that weren't run, they are due again on the next advance()
+	double alpha() const; // How far between the last step and the next one we are, from 0 to 1 (more while steps are deferred)
+	long long getDroppedSteps() const; // Steps that were due but forgotten so far, see advance()
+	void reset(); // Drops any accumulated time
+	void setStepsPerSecond(double steps_per_second); // Changes the simulation rate
+	double getStepsPerSecond() const; // Gets the simulation rate
+};
+} // namespace snakelinkedlist
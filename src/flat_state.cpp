@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include "flat_state.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+using namespace snakelinkedlist;
+
+static const uint8_t kpadding[8] = {}; // Source of the zero bytes that align sections
+
+FlatWriter::FlatWriter() : size_(sizeof(FlatGameHeader)) {
+	std::memset(&header_, 0, sizeof(header_));
+	std::memcpy(header_.magic, "SNKF", 4);
+	header_.version = kflat_version;
+	header_.header_bytes = sizeof(FlatGameHeader);
+}
+
+FlatSection FlatWriter::add(const void* data, size_t bytes, const void* more, size_t more_bytes) {
+	size_t padding = static_cast<size_t>((8 - size_ % 8) % 8);
+	if (padding > 0) {
+		chunks_.push_back(Chunk{kpadding, padding});
+		size_ += padding;
+	}
+
+	FlatSection section = {size_, bytes + more_bytes};
+	if (bytes > 0) {
+		chunks_.push_back(Chunk{data, bytes});
+	}
+	if (more_bytes > 0) {
+		chunks_.push_back(Chunk{more, more_bytes});
+	}
+	size_ += bytes + more_bytes;
+	return section;
+}
+
+/*
+The header and every section go to the kernel in one writev() straight from where the game keeps them.
+A write can stop short (e.g. on a signal), so whatever is left is written by carrying on from where it stopped
+*/
+bool FlatWriter::write(const std::string& path) const {
+#ifndef _WIN32
+	int file = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (file < 0) {
+		return false;
+	}
+	std::vector<iovec> pieces;
+	pieces.reserve(chunks_.size() + 1);
+	pieces.push_back(iovec{const_cast<FlatGameHeader*>(&header_), sizeof(header_)});
+	for (const Chunk& chunk : chunks_) {
+		pieces.push_back(iovec{const_cast<void*>(chunk.data), chunk.bytes});
+	}
+
+	size_t next = 0;
+	bool ok = true;
+	while (ok && next < pieces.size()) {
+		ssize_t written = writev(file, &pieces[next], static_cast<int>(std::min<size_t>(pieces.size() - next, IOV_MAX)));
+		if (written < 0) {
+			ok = errno == EINTR;
+			continue;
+		}
+		size_t remaining = static_cast<size_t>(written);
+		while (next < pieces.size() && remaining >= pieces[next].iov_len) {
+			remaining -= pieces[next].iov_len;
+			next++;
+		}
+		if (remaining > 0) {
+			pieces[next].iov_base = static_cast<uint8_t*>(pieces[next].iov_base) + remaining;
+			pieces[next].iov_len -= remaining;
+		}
+	}
+	return ::close(file) == 0 && ok;
+#else
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+	for (const Chunk& chunk : chunks_) {
+		file.write(static_cast<const char*>(chunk.data), static_cast<std::streamsize>(chunk.bytes));
+	}
+	return static_cast<bool>(file);
+#endif
+}
+
+void FlatWriter::copyTo(std::vector<uint8_t>& bytes) const {
+	bytes.resize(size_);
+	std::memcpy(bytes.data(), &header_, sizeof(header_));
+	size_t position = sizeof(header_);
+	for (const Chunk& chunk : chunks_) {
+		std::memcpy(&bytes[position], chunk.data, chunk.bytes);
+		position += chunk.bytes;
+	}
+}
+
+bool FlatGameView::checkSection(const FlatSection& section, uint64_t bytes) const {
+	return section.offset % 8 == 0 && section.offset >= sizeof(FlatGameHeader) && section.offset <= size_ &&
+		section.bytes == bytes && section.bytes <= size_ - section.offset;
+}
+
+/*
+Only the header is checked: the scalars are in range and every section is where it can be read in place with the
+size the header implies. The contents of the arrays are checked by validate()
+*/
+bool FlatGameView::view(const uint8_t* data, size_t size) {
+	data_ = nullptr;
+	size_ = size;
+	if (data == nullptr || size < sizeof(FlatGameHeader) || reinterpret_cast<uintptr_t>(data) % 8 != 0) {
+		return false;
+	}
+
+	const FlatGameHeader& saved = *reinterpret_cast<const FlatGameHeader*>(data);
+	if (std::memcmp(saved.magic, "SNKF", 4) != 0 || saved.version != kflat_version ||
+		saved.header_bytes != sizeof(FlatGameHeader)) {
+		return false;
+	}
+	if (saved.columns < 0 || saved.rows < 0 || static_cast<int64_t>(saved.columns) * saved.rows > INT32_MAX ||
+		saved.state < IN_PROGRESS || saved.state > HIGHSCORES ||
+		saved.direction < UP || saved.direction > LEFT || saved.queued_turn_count < 0 || saved.queued_turn_count > 3 ||
+		saved.body_length == 0 || saved.food_eaten < 0 || static_cast<uint32_t>(saved.food_eaten) >= saved.body_length) {
+		return false;
+	}
+	for (int i = 0; i < saved.queued_turn_count; i++) {
+		if (saved.queued_turns[i] < UP || saved.queued_turns[i] > LEFT) {
+			return false;
+		}
+	}
+
+	uint64_t squares = static_cast<uint64_t>(saved.columns) * static_cast<uint64_t>(saved.rows);
+	if (saved.free_count > squares ||
+		!checkSection(saved.body, static_cast<uint64_t>(saved.body_length) * sizeof(Cell)) ||
+		!checkSection(saved.body_colors, static_cast<uint64_t>(saved.body_length) * sizeof(Color)) ||
+		!checkSection(saved.counts, squares * sizeof(uint16_t)) ||
+		!checkSection(saved.free_squares, static_cast<uint64_t>(saved.free_count) * sizeof(int32_t))) {
+		return false;
+	}
+	data_ = data;
+	return true;
+}
+
+/*
+Four checks, reading the save in place, that take one pass over the body and two over the board:
+1. Every body square is on the board, and the segments on each square are counted into segments_, along with the
+   squares the body covers. A game that ended by running into a wall has its head one square off the board, like the
+   grid it isn't counted
+2. The saved segment counts are the ones the body makes
+3. As many squares are empty as the save lists
+4. Every listed empty square is on the board, has no segment and is listed once. Listed squares are marked in
+   segments_ with a count no body square can reach
+*/
+bool FlatGameView::validate() const {
+	static const uint16_t kseen = UINT16_MAX;
+	if (!valid()) {
+		return false;
+	}
+	const FlatGameHeader& saved = header();
+	size_t squares = static_cast<size_t>(saved.columns) * saved.rows;
+	if (saved.food.x < 0 || saved.food.y < 0 || saved.food.x >= saved.columns || saved.food.y >= saved.rows) {
+		return false;
+	}
+
+	segments_.assign(squares, 0);
+	const Cell* body = getBody();
+	size_t covered = 0;
+	for (uint32_t i = 0; i < saved.body_length; i++) {
+		Cell cell = body[i];
+		if (cell.x < 0 || cell.y < 0 || cell.x >= saved.columns || cell.y >= saved.rows) {
+			if (i == 0 && saved.state == FINISHED && cell.x >= -1 && cell.y >= -1 && cell.x <= saved.columns &&
+				cell.y <= saved.rows) {
+				continue;
+			}
+			return false;
+		}
+		uint16_t& count = segments_[static_cast<size_t>(cell.y) * saved.columns + cell.x];
+		if (count == kseen - 1) {
+			return false;
+		}
+		covered += count == 0;
+		count++;
+	}
+	if (std::memcmp(segments_.data(), getCounts(), squares * sizeof(uint16_t)) != 0 ||
+		squares - covered != saved.free_count) {
+		return false;
+	}
+
+	const int32_t* free_squares = getFreeSquares();
+	for (uint32_t i = 0; i < saved.free_count; i++) {
+		int32_t square = free_squares[i];
+		if (square < 0 || static_cast<size_t>(square) >= squares || segments_[square] != 0) {
+			return false;
+		}
+		segments_[square] = kseen;
+	}
+	return true;
+}
+
+bool FlatGameView::open(const std::string& path) {
+	data_ = nullptr;
+	return file_.open(path) && view(file_.data(), file_.size());
+}
+
+const Cell* FlatGameView::getBody() const {
+	return reinterpret_cast<const Cell*>(data_ + header().body.offset);
+}
+
+const Color* FlatGameView::getBodyColors() const {
+	return reinterpret_cast<const Color*>(data_ + header().body_colors.offset);
+}
+
+const uint16_t* FlatGameView::getCounts() const {
+	return reinterpret_cast<const uint16_t*>(data_ + header().counts.offset);
+}
+
+const int32_t* FlatGameView::getFreeSquares() const {
+	return reinterpret_cast<const int32_t*>(data_ + header().free_squares.offset);
+}
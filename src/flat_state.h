@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "game_types.h"
+#include "mapped_file.h"
+
+namespace snakelinkedlist {
+
+/*
+Flat save format for a complete game, laid out so it can be used straight from the bytes it was written to.
+
+A fixed size FlatGameHeader holds every scalar of the game (board, state, seed, tick, queued turns, direction, score,
+food and its generator) and where each array is in the file. The arrays follow, each exactly as the game keeps it in
+memory: the body squares from head to tail, their colors, the segment count of every square and the list of empty
+squares in the order food is drawn from them. Every section starts on an 8 byte boundary.
+
+Saving gathers the header and the game's arrays into a single write() without copying any of them, and FlatGameView
+reads a saved game in place (e.g. from a mapped file) after checking only the header, so opening a save costs the
+same however long the snake is. Restoring a Simulation from a view is one block copy per array (see
+Simulation::readFlat()). Checking that the arrays agree with each other takes a pass over the body and the board, so
+it is a separate step, validate(), for saves that may be damaged. Like BinaryWriter the layout is the machine's own,
+little endian on every platform the game targets.
+*/
+
+// Where an array is in a saved game
+struct FlatSection {
+	uint64_t offset; // From the start of the save, a multiple of 8
+	uint64_t bytes;
+};
+
+struct FlatGameHeader {
+	char magic[4]; // "SNKF"
+	uint32_t version; // kflat_version
+	uint32_t header_bytes; // sizeof(FlatGameHeader), another check that reader and writer agree
+	uint32_t reserved;
+
+	int32_t board_width; // Window size the board was measured from, in pixels
+	int32_t board_height;
+	int32_t columns; // Board size in squares
+	int32_t rows;
+	int32_t state; // GameState
+	uint32_t seed;
+	int64_t tick_count;
+	int32_t queued_turn_count;
+	int32_t queued_turns[3]; // SnakeDirection, the first queued_turn_count are used
+
+	int32_t direction; // SnakeDirection the snake is moving in
+	int32_t food_eaten;
+	Cell previous_tail; // Where the tail was before the last move
+	uint32_t body_length;
+	uint32_t free_count; // Empty squares on the board
+
+	uint64_t food_generator; // Random state of the food
+	Cell food; // Square the food is on
+	uint8_t food_color[4]; // r, g, b and one byte of padding
+	uint32_t reserved_food;
+
+	FlatSection body; // body_length Cells from head to tail
+	FlatSection body_colors; // body_length Colors
+	FlatSection counts; // columns * rows uint16_t segment counts, row by row
+	FlatSection free_squares; // free_count int32_t row by row square indices, in food drawing order
+};
+
+static_assert(std::is_trivially_copyable<FlatGameHeader>::value, "the header is read in place");
+static_assert(sizeof(FlatGameHeader) % 8 == 0, "sections after the header must stay 8 byte aligned");
+static_assert(sizeof(Cell) == 8 && sizeof(Color) == 3, "sections hold Cells and Colors as they are in memory");
+
+static const uint32_t kflat_version = 3; // 3 keeps the body as Cells and saves the segment counts, so nothing is rebuilt
+
+/*
+Collects a save without copying the game's arrays: each add() records a pointer to memory the game owns and
+the section it will occupy. The game must not change until write() or copyTo() has returned
+*/
+class FlatWriter {
+private:
+	struct Chunk {
+		const void* data;
+		size_t bytes;
+	};
+
+	FlatGameHeader header_; // Filled in by the writeFlat() of each part of the game
+	std::vector<Chunk> chunks_; // Everything after the header in file order, padding included
+	uint64_t size_; // Bytes of the save so far
+
+public:
+	FlatWriter();
+	FlatGameHeader& header() { return header_; }
+	FlatSection add(const void* data, size_t bytes, const void* more = nullptr, size_t more_bytes = 0); // Appends one section, optionally in two pieces (e.g. a wrapped ring)
+	uint64_t size() const { return size_; } // Total bytes of the save
+	bool write(const std::string& path) const; // Writes the save with one write() where it can, false if it fails
+	void copyTo(std::vector<uint8_t>& bytes) const; // Replaces bytes with the save
+};
+
+/*
+A saved game read in place. view() only checks the header and that every section lies within the bytes with the
+size the header implies, nothing is copied, so the arrays are read straight out of the buffer or the mapped file.
+validate() checks the arrays themselves against each other, which a save from anywhere but this process needs before
+it is restored. The bytes have to stay alive and unchanged while the view is used, and must start 8 byte aligned
+*/
+class FlatGameView {
+private:
+	const uint8_t* data_ = nullptr; // Start of the save, nullptr when nothing valid is viewed
+	size_t size_ = 0;
+	MappedFile file_; // The save when it was opened from a file
+	mutable std::vector<uint16_t> segments_; // Segments on each square counted by validate(), kept so repeated checks don't allocate
+
+	bool checkSection(const FlatSection& section, uint64_t bytes) const; // Whether a section is aligned, in range and bytes long
+
+public:
+	bool view(const uint8_t* data, size_t size); // Views a save in memory, false if the header doesn't check out
+	bool open(const std::string& path); // Maps a save file and views it, false if it can't be read or isn't a save
+	bool valid() const { return data_ != nullptr; }
+	bool validate() const; // Whether the body, the segment counts and the empty squares agree, O(board)
+
+	const FlatGameHeader& header() const { return *reinterpret_cast<const FlatGameHeader*>(data_); }
+	const Cell* getBody() const; // header().body_length squares from head to tail
+	const Color* getBodyColors() const; // header().body_length colors
+	const uint16_t* getCounts() const; // columns * rows segment counts, row by row
+	const int32_t* getFreeSquares() const; // header().free_count empty squares
+};
+} // namespace snakelinkedlist
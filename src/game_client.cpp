@@ -0,0 +1,137 @@
+#include <cerrno>
+#include <cstring>
+#include "game_client.h"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace snakelinkedlist;
+
+GameClient::~GameClient() {
+	close();
+}
+
+bool GameClient::connect(uint16_t port, const std::string& address) {
+	close();
+#ifndef _WIN32
+	sockaddr_in endpoint = {};
+	endpoint.sin_family = AF_INET;
+	endpoint.sin_port = htons(port);
+	if (inet_pton(AF_INET, address.c_str(), &endpoint.sin_addr) != 1) {
+		return false;
+	}
+	socket_ = socket(AF_INET, SOCK_STREAM, 0);
+	if (socket_ < 0) {
+		return false;
+	}
+	if (::connect(socket_, reinterpret_cast<sockaddr*>(&endpoint), sizeof(endpoint)) != 0) {
+		close();
+		return false;
+	}
+	int on = 1;
+	setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+	return true;
+#else
+	(void)port;
+	(void)address;
+	return false;
+#endif
+}
+
+void GameClient::close() {
+#ifndef _WIN32
+	if (socket_ >= 0) {
+		::close(socket_);
+	}
+#endif
+	socket_ = -1;
+	inbox_.clear();
+}
+
+bool GameClient::isConnected() const {
+	return socket_ >= 0;
+}
+
+bool GameClient::send(uint8_t input) {
+#ifndef _WIN32
+	if (socket_ < 0 || ::send(socket_, &input, 1, MSG_NOSIGNAL | MSG_DONTWAIT) != 1) {
+		return false;
+	}
+	return true;
+#else
+	(void)input;
+	return false;
+#endif
+}
+
+bool GameClient::sendTurn(SnakeDirection direction) {
+	return send(static_cast<uint8_t>(direction));
+}
+
+bool GameClient::sendRestart() {
+	return send(kinput_restart);
+}
+
+/*
+Reads everything the socket has, then applies the complete frames from the front of the inbox and keeps the
+unfinished one for the next call. A frame that doesn't apply means the stream is out of step, so it disconnects.
+Frames that arrived before the server hung up are still applied, the next call returns -1
+*/
+int GameClient::poll(int timeout_ms) {
+#ifndef _WIN32
+	if (socket_ < 0) {
+		return -1;
+	}
+	pollfd waiting = {socket_, POLLIN, 0};
+	if (::poll(&waiting, 1, timeout_ms) <= 0) {
+		return 0;
+	}
+
+	uint8_t buffer[4096];
+	bool disconnected = false;
+	while (true) {
+		ssize_t received = recv(socket_, buffer, sizeof(buffer), MSG_DONTWAIT);
+		if (received > 0) {
+			inbox_.insert(inbox_.end(), buffer, buffer + received);
+		} else {
+			disconnected = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+			break;
+		}
+	}
+
+	int applied = 0;
+	size_t position = 0;
+	while (inbox_.size() - position >= kframe_header_bytes) {
+		uint32_t payload;
+		std::memcpy(&payload, &inbox_[position], sizeof(payload));
+		if (inbox_.size() - position - kframe_header_bytes < payload) {
+			break;
+		}
+		FrameType type = static_cast<FrameType>(inbox_[position + sizeof(payload)]);
+		if (!mirror_.apply(type, &inbox_[position + kframe_header_bytes], payload)) {
+			close();
+			return -1;
+		}
+		position += kframe_header_bytes + payload;
+		applied++;
+	}
+	inbox_.erase(inbox_.begin(), inbox_.begin() + position);
+	if (disconnected) {
+		close();
+	}
+	return applied;
+#else
+	(void)timeout_ms;
+	return -1;
+#endif
+}
+
+const GameMirror& GameClient::getGame() const {
+	return mirror_;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "game_protocol.h"
+
+namespace snakelinkedlist {
+
+/*
+Thin client of a GameServer: sends input and keeps a GameMirror of the server's game up to date for drawing.
+Like the server it never blocks, poll() takes whatever has arrived and applies every complete frame.
+Sockets are POSIX only, elsewhere connect() fails.
+*/
+class GameClient {
+private:
+	int socket_ = -1; // Connection to the server, -1 when not connected
+	std::vector<uint8_t> inbox_; // Bytes received that don't make up a whole frame yet
+	GameMirror mirror_; // The game as of the last frame applied
+
+	bool send(uint8_t input); // Sends one input byte, false if the connection failed
+
+public:
+	GameClient() {};
+	~GameClient(); // Disconnects
+	GameClient(const GameClient&) = delete;
+	GameClient& operator=(const GameClient&) = delete;
+
+	bool connect(uint16_t port, const std::string& address = "127.0.0.1"); // Connects to a server, false if it can't
+	void close(); // Disconnects
+	bool isConnected() const;
+
+	bool sendTurn(SnakeDirection direction); // Asks the server to turn the snake, false if the connection failed
+	bool sendRestart(); // Asks the server for a new game once the current one is over
+	int poll(int timeout_ms); // Waits up to timeout_ms for frames and applies every complete one, returns how many. -1 once disconnected
+
+	const GameMirror& getGame() const; // The server's game as of the last frame
+};
+} // namespace snakelinkedlist
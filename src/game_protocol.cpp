@@ -0,0 +1,218 @@
+#include <cstring>
+#include "game_protocol.h"
+
+using namespace snakelinkedlist;
+
+TickSummary::TickSummary(const Simulation& game)
+	: head(game.getSnake().getHeadCell()),
+	  length(game.getSnake().getBody().size()),
+	  food(game.getFood().getCell()),
+	  food_color(game.getFood().getColor()),
+	  score(game.getSnake().getFoodEaten()) {
+}
+
+/*
+A tick that ran always moves the head. The tail only stays put when the snake grew, and the food only moves
+when it was eaten, although it may land on the square it was on (the color is sent either way)
+*/
+TickDelta snakelinkedlist::diffTick(const TickSummary& before, const Simulation& after) {
+	const Snake& snake = after.getSnake();
+	TickDelta delta;
+	delta.tick = after.getTickCount();
+	delta.flags = 0;
+	delta.head = snake.getHeadCell();
+	delta.food = after.getFood().getCell();
+	delta.food_color = after.getFood().getColor();
+	delta.score = snake.getFoodEaten();
+	delta.state = after.getState();
+
+	if (delta.head != before.head || snake.getBody().size() != before.length) {
+		delta.flags |= kdelta_head_added;
+		delta.flags |= snake.getBody().size() == before.length ? kdelta_tail_removed : kdelta_food_eaten;
+	}
+	if (delta.score != before.score || delta.food != before.food) {
+		delta.flags |= kdelta_food_moved;
+	}
+	return delta;
+}
+
+// The payload size is only known at the end, it is written as 0 and filled in afterwards
+static void beginFrame(std::vector<uint8_t>& frame, FrameType type) {
+	frame.clear();
+	BinaryWriter out(frame);
+	out.write(static_cast<uint32_t>(0));
+	out.write(static_cast<uint8_t>(type));
+}
+
+static void endFrame(std::vector<uint8_t>& frame) {
+	uint32_t payload = static_cast<uint32_t>(frame.size() - kframe_header_bytes);
+	std::memcpy(frame.data(), &payload, sizeof(payload));
+}
+
+// Squares are written as two int16_t, boards are far smaller than that and heads only ever step one square off
+static void writeCell(BinaryWriter& out, Cell cell) {
+	out.write(static_cast<int16_t>(cell.x));
+	out.write(static_cast<int16_t>(cell.y));
+}
+
+static Cell readCell(BinaryReader& in) {
+	int16_t x, y;
+	in.read(x);
+	in.read(y);
+	return Cell{x, y};
+}
+
+void snakelinkedlist::encodeSnapshot(const Simulation& game, std::vector<uint8_t>& frame) {
+	beginFrame(frame, SNAPSHOT_FRAME);
+	BinaryWriter out(frame);
+	const Snake& snake = game.getSnake();
+	out.write(static_cast<int32_t>(game.getBoardSize().columns));
+	out.write(static_cast<int32_t>(game.getBoardSize().rows));
+	out.write(static_cast<uint8_t>(game.getState()));
+	out.write(static_cast<int64_t>(game.getTickCount()));
+	out.write(static_cast<int32_t>(snake.getFoodEaten()));
+	writeCell(out, game.getFood().getCell());
+	out.write(game.getFood().getColor());
+	out.write(static_cast<uint32_t>(snake.getBody().size()));
+	for (const Cell& segment : snake.getBody()) {
+		writeCell(out, segment);
+	}
+	out.writeBytes(snake.getBodyColors().data(), snake.getBody().size() * sizeof(Color));
+	endFrame(frame);
+}
+
+void snakelinkedlist::encodeDelta(const TickDelta& delta, std::vector<uint8_t>& frame) {
+	beginFrame(frame, DELTA_FRAME);
+	BinaryWriter out(frame);
+	out.write(static_cast<int64_t>(delta.tick));
+	out.write(delta.flags);
+	writeCell(out, delta.head);
+	writeCell(out, delta.food);
+	out.write(delta.food_color);
+	out.write(static_cast<int32_t>(delta.score));
+	out.write(static_cast<uint8_t>(delta.state));
+	endFrame(frame);
+}
+
+bool GameMirror::apply(FrameType type, const uint8_t* payload, size_t size) {
+	BinaryReader in(payload, size);
+	if (type == SNAPSHOT_FRAME) {
+		return applySnapshot(in);
+	} else if (type == DELTA_FRAME) {
+		return applyDelta(in);
+	}
+	return false;
+}
+
+// Read into locals first so a damaged snapshot leaves the mirror as it was
+bool GameMirror::applySnapshot(BinaryReader& in) {
+	int32_t columns, rows, score;
+	uint8_t state;
+	int64_t tick;
+	uint32_t length;
+	Color food_color;
+	in.read(columns);
+	in.read(rows);
+	in.read(state);
+	in.read(tick);
+	in.read(score);
+	Cell food = readCell(in);
+	in.read(food_color);
+	in.read(length);
+	if (!in.ok() || state > HIGHSCORES || length == 0 ||
+		length > in.remaining() / (2 * sizeof(int16_t) + sizeof(Color))) {
+		return false;
+	}
+
+	body_.clear();
+	body_.reserve(length);
+	for (uint32_t i = 0; i < length; i++) {
+		body_.push_back(readCell(in));
+	}
+	body_colors_.resize(length);
+	in.readBytes(body_colors_.data(), length * sizeof(Color));
+
+	board_ = BoardSize{columns, rows};
+	state_ = static_cast<GameState>(state);
+	tick_ = tick;
+	score_ = score;
+	food_ = food;
+	food_color_ = food_color;
+	synced_ = true;
+	return in.ok();
+}
+
+/*
+Applies a tick the same way Snake::update() does: the head goes on the front, and either the tail comes off the back
+or the snake grew and the new tail segment gets the color of the food that was eaten
+*/
+bool GameMirror::applyDelta(BinaryReader& in) {
+	int64_t tick;
+	uint8_t flags, state;
+	int32_t score;
+	Color food_color;
+	in.read(tick);
+	in.read(flags);
+	Cell head = readCell(in);
+	Cell food = readCell(in);
+	in.read(food_color);
+	in.read(score);
+	in.read(state);
+	if (!in.ok() || !synced_ || state > HIGHSCORES) {
+		return false;
+	}
+
+	if (flags & kdelta_head_added) {
+		body_.push_front(head);
+	}
+	if (flags & kdelta_tail_removed) {
+		body_.pop_back();
+	}
+	if (flags & kdelta_food_eaten) {
+		body_colors_.push_back(food_color_);
+	}
+	if (flags & kdelta_food_moved) {
+		food_ = food;
+		food_color_ = food_color;
+	}
+	tick_ = tick;
+	score_ = score;
+	state_ = static_cast<GameState>(state);
+	return true;
+}
+
+bool GameMirror::isSynced() const {
+	return synced_;
+}
+
+BoardSize GameMirror::getBoardSize() const {
+	return board_;
+}
+
+GameState GameMirror::getState() const {
+	return state_;
+}
+
+long long GameMirror::getTickCount() const {
+	return tick_;
+}
+
+const RingBuffer<Cell>& GameMirror::getBody() const {
+	return body_;
+}
+
+const std::vector<Color>& GameMirror::getBodyColors() const {
+	return body_colors_;
+}
+
+Cell GameMirror::getFood() const {
+	return food_;
+}
+
+Color GameMirror::getFoodColor() const {
+	return food_color_;
+}
+
+int GameMirror::getScore() const {
+	return score_;
+}
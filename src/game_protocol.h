@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "binary_io.h"
+#include "game_types.h"
+#include "ring_buffer.h"
+#include "simulation.h"
+
+namespace snakelinkedlist {
+
+/*
+What a GameServer sends its clients, and the client side copy of the game it keeps up to date.
+
+Every message is a frame: a uint32_t payload size, a FrameType byte and the payload, written with BinaryWriter
+(so client and server have to share a byte order, which loopback and every platform the game targets do).
+A client gets a SNAPSHOT_FRAME with the whole game when it joins and whenever a new game starts, and after that one
+DELTA_FRAME per tick that only says what changed: the square the head entered, whether the tail left its square,
+where the food went and the score. A delta is the same size however long the snake is.
+
+Clients send single bytes back: a SnakeDirection to turn, or kinput_restart to start a new game once it is over.
+*/
+enum FrameType : uint8_t {
+	SNAPSHOT_FRAME = 1,
+	DELTA_FRAME = 2
+};
+
+// Which parts of a TickDelta changed on the tick
+enum DeltaFlags : uint8_t {
+	kdelta_head_added = 1, // The head entered head
+	kdelta_tail_removed = 2, // The tail left its square, so the snake kept its length
+	kdelta_food_eaten = 4, // The snake grew, its new tail segment takes the color of the food it ate
+	kdelta_food_moved = 8 // The food is now on food with food_color
+};
+
+struct TickDelta {
+	long long tick; // Tick of the game after the step
+	uint8_t flags; // DeltaFlags
+	Cell head;
+	Cell food;
+	Color food_color;
+	int score;
+	GameState state;
+};
+
+typedef std::shared_ptr<const std::vector<uint8_t>> SharedFrame; // An encoded frame, shared by every client it is sent to
+
+static const size_t kframe_header_bytes = sizeof(uint32_t) + sizeof(uint8_t); // Payload size and FrameType
+static const uint8_t kinput_restart = 0xff; // Input byte asking for a new game once the current one is over
+
+// The parts of a game a delta is worked out from, taken before a tick
+struct TickSummary {
+	Cell head;
+	size_t length;
+	Cell food;
+	Color food_color;
+	int score;
+
+	explicit TickSummary(const Simulation& game);
+};
+
+TickDelta diffTick(const TickSummary& before, const Simulation& after); // What a tick changed, from the game before and after it
+void encodeSnapshot(const Simulation& game, std::vector<uint8_t>& frame); // Replaces frame with a SNAPSHOT_FRAME of the game
+void encodeDelta(const TickDelta& delta, std::vector<uint8_t>& frame); // Replaces frame with a DELTA_FRAME
+
+/*
+The client's copy of the game, built from a snapshot and kept up to date by applying every delta in order.
+It holds exactly what a renderer needs: the body squares and colors from the head, the food and the score.
+Applying a delta touches at most the two ends of the body, like Snake::update()
+*/
+class GameMirror {
+private:
+	BoardSize board_ = {0, 0}; // Size of the board in squares
+	GameState state_ = FINISHED; // State of the game as of the last frame
+	long long tick_ = 0; // Tick of the last frame
+	RingBuffer<Cell> body_; // Squares of the body from head to tail
+	std::vector<Color> body_colors_; // Colors of the body segments from the head, see Snake::getBodyColors()
+	Cell food_ = {0, 0}; // Square the food is on
+	Color food_color_; // Color of the food
+	int score_ = 0; // Food eaten
+	bool synced_ = false; // Whether a snapshot has been applied, deltas are ignored until then
+
+	bool applySnapshot(BinaryReader& in);
+	bool applyDelta(BinaryReader& in);
+
+public:
+	bool apply(FrameType type, const uint8_t* payload, size_t size); // Applies one frame, false if it is damaged or out of place
+
+	bool isSynced() const;
+	BoardSize getBoardSize() const;
+	GameState getState() const;
+	long long getTickCount() const;
+	const RingBuffer<Cell>& getBody() const;
+	const std::vector<Color>& getBodyColors() const;
+	Cell getFood() const;
+	Color getFoodColor() const;
+	int getScore() const;
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <thread>
+#include "game_runner.h"
+
+using namespace snakelinkedlist;
+
+GameRunner::GameRunner(int board_width, int board_height, int thread_count, int max_ticks_per_game)
+	: board_width_(board_width),
+	  board_height_(board_height),
+	  thread_count_(thread_count),
+	  max_ticks_per_game_(max_ticks_per_game) {
+	if (thread_count_ <= 0) {
+		thread_count_ = std::max(1u, std::thread::hardware_concurrency());
+	}
+}
+
+uint64_t GameRunner::packRange(uint32_t first, uint32_t last) {
+	return (static_cast<uint64_t>(last) << 32) | first;
+}
+
+bool GameRunner::takeGame(Worker& worker, uint32_t& game) {
+	uint64_t range = worker.range_.load(std::memory_order_relaxed);
+	while (true) {
+		uint32_t first = static_cast<uint32_t>(range);
+		uint32_t last = static_cast<uint32_t>(range >> 32);
+		if (first >= last) {
+			return false;
+		}
+		if (worker.range_.compare_exchange_weak(range, packRange(first + 1, last), std::memory_order_relaxed)) {
+			game = first;
+			return true;
+		}
+	}
+}
+
+/*
+Looks at every other worker once, starting with the next one so thieves spread out over their victims.
+The thief takes the back half of the first range that has games left, rounding up so a single game can be stolen.
+Only the thief writes its own range while it is empty, so storing the stolen games there can't race with anyone.
+*/
+bool GameRunner::stealGames(Worker* workers, int worker_count, int thief) {
+	for (int offset = 1; offset < worker_count; offset++) {
+		Worker& victim = workers[(thief + offset) % worker_count];
+		uint64_t range = victim.range_.load(std::memory_order_relaxed);
+		while (true) {
+			uint32_t first = static_cast<uint32_t>(range);
+			uint32_t last = static_cast<uint32_t>(range >> 32);
+			if (first >= last) {
+				break;
+			}
+			uint32_t middle = first + (last - first) / 2;
+			if (victim.range_.compare_exchange_weak(range, packRange(first, middle), std::memory_order_relaxed)) {
+				workers[thief].range_.store(packRange(middle, last), std::memory_order_relaxed);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+GameResult GameRunner::playGame(Simulation& game, const Policy& policy, uint32_t seed) const {
+	game.reset(seed);
+	GameResult result;
+	while (result.ticks < max_ticks_per_game_) {
+		game.queueTurn(policy(game));
+		result.ticks++;
+		if (game.tick()) {
+			result.finished = true;
+			break;
+		}
+	}
+	result.food_eaten = game.getSnake().getFoodEaten();
+	return result;
+}
+
+void GameRunner::work(Worker* workers, int index, const Policy& policy, uint32_t seed, RunSummary& summary) const {
+	// Created on the worker's own thread so its memory comes from that thread's allocator arena
+	Simulation game(board_width_, board_height_, seed);
+	Worker& worker = workers[index];
+	uint32_t game_number;
+	while (takeGame(worker, game_number) || (stealGames(workers, thread_count_, index) && takeGame(worker, game_number))) {
+		GameResult result = playGame(game, policy, seed + game_number);
+		summary.games[game_number] = result;
+
+		worker.games_played_++;
+		worker.food_eaten_ += result.food_eaten;
+		worker.ticks_ += result.ticks;
+		worker.best_food_eaten_ = std::max(worker.best_food_eaten_, result.food_eaten);
+	}
+}
+
+RunSummary GameRunner::run(long long game_count, const Policy& policy, uint32_t seed) {
+	RunSummary summary;
+	summary.games.resize(static_cast<size_t>(game_count));
+
+	// Over allocate and align by hand, std::vector and new only honour alignas for cache lines from C++17 on
+	std::unique_ptr<unsigned char[]> storage(new unsigned char[(thread_count_ + 1) * sizeof(Worker)]);
+	void* aligned = storage.get();
+	size_t space = (thread_count_ + 1) * sizeof(Worker);
+	Worker* workers = static_cast<Worker*>(std::align(alignof(Worker), thread_count_ * sizeof(Worker), aligned, space));
+
+	// Every worker starts with an equal share of the games
+	for (int i = 0; i < thread_count_; i++) {
+		uint32_t first = static_cast<uint32_t>(game_count * i / thread_count_);
+		uint32_t last = static_cast<uint32_t>(game_count * (i + 1) / thread_count_);
+		Worker* worker = new (&workers[i]) Worker();
+		worker->range_.store(packRange(first, last), std::memory_order_relaxed);
+		worker->games_played_ = 0;
+		worker->food_eaten_ = 0;
+		worker->ticks_ = 0;
+		worker->best_food_eaten_ = 0;
+	}
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < thread_count_; i++) {
+		threads.emplace_back(&GameRunner::work, this, workers, i, std::cref(policy), seed, std::ref(summary));
+	}
+	work(workers, 0, policy, seed, summary);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	for (int i = 0; i < thread_count_; i++) {
+		summary.total_food_eaten += workers[i].food_eaten_;
+		summary.total_ticks += workers[i].ticks_;
+		summary.best_food_eaten = std::max(summary.best_food_eaten, workers[i].best_food_eaten_);
+		summary.games_per_thread.push_back(workers[i].games_played_);
+		workers[i].~Worker();
+	}
+	return summary;
+}
+
+int GameRunner::getThreadCount() const {
+	return thread_count_;
+}
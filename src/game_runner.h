@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "game_types.h"
+#include "simulation.h"
+
+namespace snakelinkedlist {
+
+// Picks the direction to turn to before each tick. Called from several threads at once, so it must not share
+// mutable state between calls without synchronizing it. Returning the current direction (or any illegal turn) goes straight on
+typedef std::function<SnakeDirection(const Simulation& game)> Policy;
+
+// How one game ended
+struct GameResult {
+	int food_eaten = 0; // The final Snake::getFoodEaten()
+	int ticks = 0; // Ticks the snake survived, including the one that ended the game
+	bool finished = false; // False if the game was stopped at the tick limit instead of ending
+};
+
+// Results of every game in a run, in game order, plus totals over the run
+struct RunSummary {
+	std::vector<GameResult> games; // One result per game, indexed by game number
+	long long total_food_eaten = 0; // Sum of food_eaten over all games
+	long long total_ticks = 0; // Sum of ticks over all games
+	int best_food_eaten = 0; // Highest food_eaten of any game
+	std::vector<long long> games_per_thread; // How many games each worker thread played, shows how work was balanced
+};
+
+/*
+Plays large numbers of independent headless games across several threads, e.g. to evaluate a bot policy.
+
+Game numbers are split into one contiguous range per worker. A worker plays games from the front of its own range
+and, once that is empty, steals the back half of another worker's remaining range, so threads that draw short games
+keep helping the ones that drew long games until every game has been played. Each range is a single atomic word so
+taking and stealing games needs no lock.
+
+Every worker plays its games one after another on its own Simulation and keeps its totals in its own cache line,
+the totals are only added up once all threads have finished. Results go straight into the game's slot in RunSummary::games.
+Game g of a run is seeded with seed + g, so the results are the same however the games were spread over the threads.
+*/
+class GameRunner {
+private:
+	static const size_t kcache_line_ = 64; // Workers are kept this far apart so their hot counters never share a line
+
+	// What each thread writes while it runs, owned by one thread except for range_ which thieves update
+	struct alignas(kcache_line_) Worker {
+		std::atomic<uint64_t> range_; // Games still to play, the first game in the low 32 bits and one past the last in the high 32 bits
+		long long games_played_; // Games this worker played
+		long long food_eaten_; // Total food eaten in those games
+		long long ticks_; // Total ticks survived in those games
+		int best_food_eaten_; // Best single game score
+	};
+
+	int board_width_; // Board size in pixels of every game
+	int board_height_;
+	int thread_count_; // Number of worker threads to run
+	int max_ticks_per_game_; // Games still going after this many ticks are stopped, so a policy that circles forever can't hang the run
+
+	static uint64_t packRange(uint32_t first, uint32_t last); // Packs the range [first, last) into one word
+	static bool takeGame(Worker& worker, uint32_t& game); // Takes the first game of the worker's own range, returns false if it is empty
+	static bool stealGames(Worker* workers, int worker_count, int thief); // Moves half of another worker's games to the thief, returns false if there are none left
+	GameResult playGame(Simulation& game, const Policy& policy, uint32_t seed) const; // Plays one game to the end or the tick limit
+	void work(Worker* workers, int index, const Policy& policy, uint32_t seed, RunSummary& summary) const;
+
+public:
+	// thread_count 0 uses every hardware thread
+	GameRunner(int board_width, int board_height, int thread_count = 0, int max_ticks_per_game = 100000);
+
+	// Plays game_count games with the policy and waits for all of them to finish, game_count must fit in 32 bits
+	RunSummary run(long long game_count, const Policy& policy, uint32_t seed);
+
+	int getThreadCount() const; // Gets the number of worker threads used by run()
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,243 @@
+#include <cerrno>
+#include <memory>
+#include "game_server.h"
+#include "profiler.h"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace snakelinkedlist;
+
+GameServer::GameServer(int board_width, int board_height, uint32_t seed)
+	: game_(board_width, board_height, seed), seeds_(seed) {
+}
+
+GameServer::~GameServer() {
+	close();
+}
+
+#ifndef _WIN32
+// Frames are small and sent as soon as a tick ends, so Nagle's algorithm would only add latency
+static bool prepareSocket(int socket) {
+	int on = 1;
+	setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+	int flags = fcntl(socket, F_GETFL, 0);
+	return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+#endif
+
+bool GameServer::listen(uint16_t port, const std::string& address) {
+	close();
+#ifndef _WIN32
+	sockaddr_in endpoint = {};
+	endpoint.sin_family = AF_INET;
+	endpoint.sin_port = htons(port);
+	if (inet_pton(AF_INET, address.c_str(), &endpoint.sin_addr) != 1) {
+		return false;
+	}
+
+	listener_ = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener_ < 0) {
+		return false;
+	}
+	int on = 1;
+	setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	socklen_t length = sizeof(endpoint);
+	if (bind(listener_, reinterpret_cast<sockaddr*>(&endpoint), sizeof(endpoint)) != 0 ||
+		::listen(listener_, SOMAXCONN) != 0 || !prepareSocket(listener_) ||
+		getsockname(listener_, reinterpret_cast<sockaddr*>(&endpoint), &length) != 0) {
+		close();
+		return false;
+	}
+	port_ = ntohs(endpoint.sin_port);
+	return true;
+#else
+	(void)port;
+	(void)address;
+	return false;
+#endif
+}
+
+void GameServer::close() {
+#ifndef _WIN32
+	for (Client& client : clients_) {
+		::close(client.socket);
+	}
+	if (listener_ >= 0) {
+		::close(listener_);
+	}
+#endif
+	clients_.clear();
+	listener_ = -1;
+	port_ = 0;
+}
+
+void GameServer::accept() {
+#ifndef _WIN32
+	while (true) {
+		int socket = ::accept(listener_, nullptr, nullptr);
+		if (socket < 0) {
+			return;
+		}
+		if (!prepareSocket(socket)) {
+			::close(socket);
+			continue;
+		}
+		std::shared_ptr<std::vector<uint8_t>> snapshot = std::make_shared<std::vector<uint8_t>>();
+		encodeSnapshot(game_, *snapshot);
+		clients_.push_back(Client{socket, std::deque<PendingFrame>()});
+		clients_.back().outbox.push_back(PendingFrame{snapshot, 0});
+		flush(clients_.back());
+	}
+#endif
+}
+
+bool GameServer::receive(Client& client) {
+#ifndef _WIN32
+	uint8_t input[64];
+	while (true) {
+		ssize_t received = recv(client.socket, input, sizeof(input), 0);
+		if (received == 0) {
+			return false;
+		} else if (received < 0) {
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+		for (ssize_t i = 0; i < received; i++) {
+			if (input[i] <= LEFT) {
+				game_.queueTurn(static_cast<SnakeDirection>(input[i]));
+			} else if (input[i] == kinput_restart) {
+				restart_requested_ = true;
+			}
+		}
+	}
+#else
+	(void)client;
+	return false;
+#endif
+}
+
+bool GameServer::flush(Client& client) {
+#ifndef _WIN32
+	while (!client.outbox.empty()) {
+		PendingFrame& pending = client.outbox.front();
+		const std::vector<uint8_t>& frame = *pending.frame;
+		ssize_t sent = send(client.socket, frame.data() + pending.sent, frame.size() - pending.sent, MSG_NOSIGNAL);
+		if (sent < 0) {
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+		pending.sent += static_cast<size_t>(sent);
+		if (pending.sent < frame.size()) {
+			return true;
+		}
+		client.outbox.pop_front();
+	}
+	return true;
+#else
+	(void)client;
+	return false;
+#endif
+}
+
+// Clients are dropped by swapping the last one into their place, so the loops only move on when they keep one
+void GameServer::broadcast(const SharedFrame& frame) {
+	last_frame_bytes_ = frame->size();
+	for (size_t i = 0; i < clients_.size();) {
+		Client& client = clients_[i];
+		client.outbox.push_back(PendingFrame{frame, 0});
+		if (client.outbox.size() > kmax_pending_frames_ || !flush(client)) {
+#ifndef _WIN32
+			::close(client.socket);
+#endif
+			client = std::move(clients_.back());
+			clients_.pop_back();
+		} else {
+			i++;
+		}
+	}
+}
+
+void GameServer::broadcastSnapshot() {
+	std::shared_ptr<std::vector<uint8_t>> frame = std::make_shared<std::vector<uint8_t>>();
+	encodeSnapshot(game_, *frame);
+	broadcast(frame);
+}
+
+void GameServer::poll(int timeout_ms) {
+#ifndef _WIN32
+	if (listener_ < 0) {
+		return;
+	}
+	std::vector<pollfd> sockets(clients_.size() + 1);
+	sockets[0] = pollfd{listener_, POLLIN, 0};
+	for (size_t i = 0; i < clients_.size(); i++) {
+		short events = POLLIN | (clients_[i].outbox.empty() ? 0 : POLLOUT);
+		sockets[i + 1] = pollfd{clients_[i].socket, events, 0};
+	}
+	if (::poll(sockets.data(), sockets.size(), timeout_ms) <= 0) {
+		return;
+	}
+
+	// Walk backwards so dropping a client (swapping the last one into its place) only moves clients already handled
+	for (size_t i = clients_.size(); i-- > 0;) {
+		short events = sockets[i + 1].revents;
+		bool keep = true;
+		if (events & (POLLIN | POLLHUP | POLLERR)) {
+			keep = receive(clients_[i]);
+		}
+		if (keep && (events & POLLOUT)) {
+			keep = flush(clients_[i]);
+		}
+		if (!keep) {
+			::close(clients_[i].socket);
+			clients_[i] = std::move(clients_.back());
+			clients_.pop_back();
+		}
+	}
+	if (restart_requested_ && game_.getState() == FINISHED) {
+		game_.reset(seeds_.next());
+		broadcastSnapshot();
+	}
+	restart_requested_ = false;
+	if (sockets[0].revents & POLLIN) {
+		accept();
+	}
+#else
+	(void)timeout_ms;
+#endif
+}
+
+bool GameServer::tick() {
+	if (game_.getState() != IN_PROGRESS) {
+		return false;
+	}
+	SNAKE_PROFILE_SCOPE("server/tick");
+	TickSummary before(game_);
+	bool ended = game_.tick();
+	std::shared_ptr<std::vector<uint8_t>> frame = std::make_shared<std::vector<uint8_t>>();
+	encodeDelta(diffTick(before, game_), *frame);
+	broadcast(frame);
+	return ended;
+}
+
+uint16_t GameServer::getPort() const {
+	return port_;
+}
+
+int GameServer::getClientCount() const {
+	return static_cast<int>(clients_.size());
+}
+
+size_t GameServer::getLastFrameBytes() const {
+	return last_frame_bytes_;
+}
+
+const Simulation& GameServer::getGame() const {
+	return game_;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "game_protocol.h"
+#include "random.h"
+#include "simulation.h"
+
+namespace snakelinkedlist {
+
+/*
+Runs the authoritative copy of a game and streams it to clients over TCP (see game_protocol.h for the messages).
+The server only reacts when it is driven: poll() accepts clients and applies their input, tick() advances the game,
+so the caller decides the tick rate, e.g. with a FixedTimestep:
+	GameServer server(640, 480, seed);
+	server.listen(7126);
+	while (true) {
+		server.poll(1);
+		for (int steps = timestep.advance(elapsed); steps > 0; steps--) server.tick();
+	}
+
+Each tick is encoded once into a SharedFrame and every client's queue of unsent frames points at that same buffer,
+so broadcasting costs one encode and one send() per client however many clients there are, and nothing is copied
+per client. Sockets never block: a client that can't keep up has frames wait in its queue, and one that falls
+kmax_pending_frames_ behind is disconnected rather than held in memory.
+
+Sockets are POSIX only, elsewhere listen() fails.
+*/
+class GameServer {
+private:
+	static const size_t kmax_pending_frames_ = 4096; // Unsent frames a client may fall behind by before it is dropped
+
+	struct PendingFrame {
+		SharedFrame frame; // Shared with every other client it was broadcast to
+		size_t sent; // Bytes of it already sent to this client
+	};
+
+	struct Client {
+		int socket;
+		std::deque<PendingFrame> outbox; // Frames not fully sent yet, oldest first
+	};
+
+	Simulation game_; // The game every client sees
+	Random seeds_; // Seeds of the games after the first
+	int listener_ = -1; // Listening socket, -1 when not listening
+	uint16_t port_ = 0; // Port listened on
+	std::vector<Client> clients_; // Connected clients
+	bool restart_requested_ = false; // A client asked for a new game during this poll()
+	size_t last_frame_bytes_ = 0; // Size of the last broadcast frame
+
+	void accept(); // Takes every waiting connection and sends it a snapshot
+	bool receive(Client& client); // Applies every input byte that arrived, false if the client left
+	bool flush(Client& client); // Sends as much of the outbox as the socket takes, false if the connection failed
+	void broadcast(const SharedFrame& frame); // Queues the frame for every client and sends what it can
+	void broadcastSnapshot(); // Sends the whole game to every client, e.g. when a new game starts
+
+public:
+	GameServer(int board_width, int board_height, uint32_t seed); // Starts a game on the board that fits a window of the given size in pixels
+	~GameServer(); // Closes every socket
+	GameServer(const GameServer&) = delete;
+	GameServer& operator=(const GameServer&) = delete;
+
+	bool listen(uint16_t port, const std::string& address = "127.0.0.1"); // Starts accepting clients, port 0 picks a free one. False if it can't
+	void close(); // Disconnects every client and stops listening
+
+	void poll(int timeout_ms); // Waits up to timeout_ms for clients or input, then accepts clients, applies input and sends what is pending
+	bool tick(); // Advances the game by one step and broadcasts what changed, returns true if this step ended the game
+
+	uint16_t getPort() const; // Port the server is listening on
+	int getClientCount() const; // Number of connected clients
+	size_t getLastFrameBytes() const; // Size of the last frame broadcast, header included
+	const Simulation& getGame() const; // The authoritative game
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include "game_thread.h"
+#include "profiler.h"
+
+using namespace snakelinkedlist;
+
+double GameSnapshot::alpha(std::chrono::steady_clock::time_point now) const {
+	if (tick_seconds <= 0) {
+		return 1.0;
+	}
+	double alpha = std::chrono::duration<double>(now - tick_time).count() / tick_seconds;
+	return std::min(std::max(alpha, 0.0), 1.0);
+}
+
+GameThread::GameThread(int board_width, int board_height, double ticks_per_second)
+	: game_(board_width, board_height, 0),
+	  timestep_(ticks_per_second),
+	  snapshots_(GameSnapshot(game_)),
+	  running_(false),
+	  ticks_(0),
+	  total_lateness_ns_(0),
+	  max_lateness_ns_(0),
+	  dropped_ticks_(0) {
+}
+
+GameThread::~GameThread() {
+	stop();
+}
+
+// The first snapshot is published from this thread, the simulation thread takes over as the writer once it starts
+void GameThread::start(uint32_t seed) {
+	if (running_.load()) {
+		return;
+	}
+	game_.reset(seed);
+	timestep_.reset();
+	emit(GameEvent{GAME_STARTED, 0, seed, RIGHT, game_.getBoardWidth(), game_.getBoardHeight(), 0});
+	publish(std::chrono::steady_clock::now());
+	running_.store(true);
+	thread_ = std::thread(&GameThread::run, this);
+}
+
+void GameThread::stop() {
+	running_.store(false);
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+bool GameThread::post(const GameCommand& command) {
+	return commands_.push(command);
+}
+
+bool GameThread::pollEvent(GameEvent& event) {
+	return events_.pop(event);
+}
+
+bool GameThread::updateSnapshot() {
+	return snapshots_.acquire();
+}
+
+const GameSnapshot& GameThread::getSnapshot() const {
+	return snapshots_.front();
+}
+
+TickStats GameThread::getTickStats() const {
+	TickStats stats;
+	stats.ticks = ticks_.load(std::memory_order_relaxed);
+	stats.mean_lateness_us = stats.ticks > 0 ? total_lateness_ns_.load(std::memory_order_relaxed) / 1000.0 / stats.ticks : 0;
+	stats.max_lateness_us = max_lateness_ns_.load(std::memory_order_relaxed) / 1000.0;
+	stats.dropped_ticks = dropped_ticks_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void GameThread::emit(const GameEvent& event) {
+	events_.push(event);
+}
+
+// Copy assignment reuses the storage of the snapshot being overwritten, so publishing doesn't allocate
+void GameThread::publish(std::chrono::steady_clock::time_point tick_time) {
+	GameSnapshot& snapshot = snapshots_.back();
+	snapshot.game = game_;
+	snapshot.tick_time = tick_time;
+	snapshot.tick_seconds = 1.0 / timestep_.getStepsPerSecond();
+	snapshots_.publish();
+}
+
+bool GameThread::apply(const GameCommand& command) {
+	switch (command.kind) {
+		case QUEUE_TURN:
+			if (!autopilot_on_ && game_.queueTurn(command.direction)) {
+				emit(GameEvent{TURN_QUEUED, game_.getTickCount(), game_.getSeed(), command.direction, 0, 0, 0});
+			}
+			return false;
+		case TOGGLE_PAUSE:
+			game_.togglePause();
+			return true;
+		case TOGGLE_HIGH_SCORES:
+			game_.toggleHighScores();
+			return true;
+		case RESET_GAME:
+			game_.reset(command.seed);
+			timestep_.reset();
+			emit(GameEvent{GAME_STARTED, 0, command.seed, RIGHT, game_.getBoardWidth(), game_.getBoardHeight(), 0});
+			return true;
+		case RESIZE_WINDOW:
+			game_.resize(command.width, command.height);
+			emit(GameEvent{WINDOW_RESIZED, game_.getTickCount(), game_.getSeed(), RIGHT, command.width, command.height, 0});
+			return true;
+		case TOGGLE_AUTOPILOT:
+			autopilot_on_ = !autopilot_on_;
+			return false;
+	}
+	return false;
+}
+
+// Only a change of direction is queued, the player's keys are ignored meanwhile so the queue holds nothing else
+void GameThread::steer() {
+	SnakeDirection direction = autopilot_.plan(game_);
+	if (direction != game_.getSnake().getDirection() && game_.queueTurn(direction)) {
+		emit(GameEvent{TURN_QUEUED, game_.getTickCount(), game_.getSeed(), direction, 0, 0, 0});
+	}
+}
+
+/*
+Each pass of the loop:
+1. Applies every command that has arrived, as long as there is room for the events they may send back
+2. Runs the ticks that are due (see FixedTimestep), letting the autopilot turn before each one if it is on, and
+   records how late each one ran against when it was due. Steps due while the game is paused or over run nothing and
+   aren't counted. Ticks there is no room for events for are deferred to the next pass, ticks FixedTimestep gives up
+   on after a long stall are counted in TickStats::dropped_ticks
+3. Publishes a snapshot if anything on screen changed, stamped with the time the last tick was due
+4. Sleeps until the next tick is due, waking at least every kmax_poll_ms_ to pick up input
+If the window thread stops draining events, commands and ticks wait rather than lose events the replay needs
+*/
+void GameThread::run() {
+	std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+	const size_t kevent_room = 3; // A command sends at most one event and a tick two (the autopilot's turn), keep a spare
+
+	while (running_.load(std::memory_order_relaxed)) {
+		bool changed = false;
+		GameCommand command;
+		while (events_.size() + kevent_room < kqueue_size_ && commands_.pop(command)) {
+			changed = apply(command) || changed;
+		}
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		int steps = timestep_.advance(std::chrono::duration<double>(now - last).count());
+		last = now;
+		double step_seconds = 1.0 / timestep_.getStepsPerSecond();
+		// The last due step was due alpha steps ago, each one before it a step earlier
+		std::chrono::duration<double> first_due_ago((steps - 1 + timestep_.alpha()) * step_seconds);
+		std::chrono::steady_clock::time_point first_due =
+			now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(first_due_ago);
+		std::chrono::steady_clock::duration step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(step_seconds));
+
+		int ran = 0;
+		long long ticked = 0;
+		long long total_lateness = 0;
+		long long max_lateness = max_lateness_ns_.load(std::memory_order_relaxed);
+		for (; ran < steps && events_.size() + kevent_room < kqueue_size_; ran++) {
+			if (game_.getState() != IN_PROGRESS) {
+				continue;
+			}
+			long long lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - (first_due + ran * step)).count();
+			if (autopilot_on_) {
+				steer();
+			}
+			if (game_.tick()) {
+				emit(GameEvent{GAME_FINISHED, game_.getTickCount(), game_.getSeed(), RIGHT, 0, 0, game_.getSnake().getFoodEaten()});
+			}
+			changed = true;
+			ticked++;
+			total_lateness += lateness;
+			max_lateness = std::max(max_lateness, lateness);
+			SNAKE_PROFILE_COUNT("ticks", 1);
+		}
+
+		timestep_.defer(steps - ran);
+		dropped_ticks_.store(timestep_.getDroppedSteps(), std::memory_order_relaxed);
+		if (ticked > 0) {
+			ticks_.store(ticks_.load(std::memory_order_relaxed) + ticked, std::memory_order_relaxed);
+			total_lateness_ns_.store(total_lateness_ns_.load(std::memory_order_relaxed) + total_lateness, std::memory_order_relaxed);
+			max_lateness_ns_.store(max_lateness, std::memory_order_relaxed);
+		}
+		if (changed) {
+			std::chrono::duration<double> since_due(timestep_.alpha() * step_seconds);
+			publish(now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(since_due));
+		}
+
+		// With ticks deferred the event queue is full, wait a poll for the window thread to drain it rather than spin
+		double until_due = ran < steps ? kmax_poll_ms_ / 1000.0 : (1.0 - timestep_.alpha()) * step_seconds;
+		std::this_thread::sleep_for(std::min(std::chrono::duration<double>(until_due),
+			std::chrono::duration<double>(kmax_poll_ms_ / 1000.0)));
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "autopilot.h"
+#include "fixed_timestep.h"
+#include "game_types.h"
+#include "simulation.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
+
+namespace snakelinkedlist {
+
+// Input for the game, sent from the window thread (see GameThread::post())
+enum GameCommandKind {
+	QUEUE_TURN,
+	TOGGLE_PAUSE,
+	TOGGLE_HIGH_SCORES,
+	RESET_GAME,
+	RESIZE_WINDOW,
+	TOGGLE_AUTOPILOT // Hands the steering to the Autopilot or back to the player
+};
+
+struct GameCommand {
+	GameCommandKind kind;
+	SnakeDirection direction; // QUEUE_TURN
+	uint32_t seed; // RESET_GAME
+	int width; // RESIZE_WINDOW, in pixels
+	int height;
+};
+
+// Something the window thread has to know about, e.g. to record the replay or the score (see GameThread::pollEvent())
+enum GameEventKind {
+	GAME_STARTED, // A game began with seed on a window of width x height
+	TURN_QUEUED, // The game accepted a turn to direction on tick
+	WINDOW_RESIZED, // The game saw the window become width x height on tick
+	GAME_FINISHED // The game ended on tick with score food eaten
+};
+
+struct GameEvent {
+	GameEventKind kind;
+	long long tick;
+	uint32_t seed;
+	SnakeDirection direction;
+	int width;
+	int height;
+	int score;
+};
+
+// The game as of one tick, handed to the renderer whole so it never sees a tick half applied
+struct GameSnapshot {
+	Simulation game;
+	std::chrono::steady_clock::time_point tick_time; // When the tick was taken, for interpolating the drawing
+	double tick_seconds; // Length of a tick at the time
+
+	explicit GameSnapshot(const Simulation& state) : game(state), tick_seconds(0) {};
+	double alpha(std::chrono::steady_clock::time_point now) const; // How far towards the next tick now is, from 0 to 1
+};
+
+// How punctual the ticks have been, see GameThread::getTickStats()
+struct TickStats {
+	long long ticks; // Ticks taken since start()
+	double mean_lateness_us; // How long after it was due a tick ran, on average
+	double max_lateness_us;
+	long long dropped_ticks; // Ticks that were due but never ran, the thread fell further behind than it catches up
+};
+
+/*
+Runs a Simulation on its own thread at a fixed tick rate so drawing and simulating never hold each other up.
+
+The window thread sends input with post(), which goes through a lock free single producer single consumer queue,
+and the simulation thread applies everything that has arrived before each step. After every step (and every
+command that changes what is on screen) it copies the game into the back copy of a triple buffer and publishes
+it, and the window thread picks up the newest copy with updateSnapshot() whenever it likes. Neither thread ever
+waits for the other or takes a lock. Things the window thread has to record (the start of a game, accepted turns,
+resizes and the end of a game) come back in order through a second queue, see pollEvent().
+While the autopilot is on it queues the turns before each tick instead of the player, and they come back as
+TURN_QUEUED events like the player's so the replay plays the game the same way.
+
+post(), pollEvent(), updateSnapshot() and getSnapshot() must all be called from the same (window) thread.
+*/
+class GameThread {
+private:
+	static const size_t kqueue_size_ = 1024; // Commands or events in flight, far more than a frame can produce
+	static const int kmax_poll_ms_ = 1; // Longest the thread sleeps without looking for new commands
+
+	Simulation game_; // Only touched by the simulation thread once it has started
+	FixedTimestep timestep_; // Turns time into ticks on the simulation thread
+	Autopilot autopilot_; // Steers the game while autopilot_on_, only touched by the simulation thread
+	bool autopilot_on_ = false;
+
+	SpscQueue<GameCommand, kqueue_size_> commands_; // Window thread to simulation thread
+	SpscQueue<GameEvent, kqueue_size_> events_; // Simulation thread to window thread, commands and ticks wait while it is nearly full
+	TripleBuffer<GameSnapshot> snapshots_; // Latest state of the game for the renderer
+	std::thread thread_;
+	std::atomic<bool> running_;
+
+	// Written by the simulation thread only, read by anyone
+	std::atomic<long long> ticks_;
+	std::atomic<long long> total_lateness_ns_;
+	std::atomic<long long> max_lateness_ns_;
+	std::atomic<long long> dropped_ticks_;
+
+	void run(); // The simulation thread
+	bool apply(const GameCommand& command); // Applies one command, returns whether the picture changed
+	void publish(std::chrono::steady_clock::time_point tick_time); // Copies the game into the triple buffer
+	void emit(const GameEvent& event); // Queues an event for the window thread
+	void steer(); // Queues the autopilot's turn for the next tick
+
+public:
+	GameThread(int board_width, int board_height, double ticks_per_second);
+	~GameThread(); // Stops the thread
+	GameThread(const GameThread&) = delete;
+	GameThread& operator=(const GameThread&) = delete;
+
+	void start(uint32_t seed); // Starts the first game and the thread, does nothing if it is already running
+	void stop(); // Stops the thread and waits for it, the last snapshot stays available
+
+	bool post(const GameCommand& command); // Sends input to the game, false if the queue is full and it was dropped
+	bool pollEvent(GameEvent& event); // Takes the oldest event the game has sent, false if there is none
+	bool updateSnapshot(); // Picks up the newest published state, returns false if nothing changed since the last call
+	const GameSnapshot& getSnapshot() const; // The state picked up by the last updateSnapshot(), stable until the next call
+
+	TickStats getTickStats() const; // Punctuality of the ticks so far, safe to call from any thread
+};
+} // namespace snakelinkedlist
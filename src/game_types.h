@@ -0,0 +1,114 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+/*
+Plain value types shared by the simulation and the openFrameworks front end.
+Nothing in the simulation may include ofMain.h so it can be built and run without a window,
+the renderer converts these into their of* counterparts when drawing.
+*/
+namespace snakelinkedlist {
+
+// Enum that represents all possible directions that the snake can be moving
+typedef enum {
+	UP = 0,
+	DOWN,
+	RIGHT,
+	LEFT
+} SnakeDirection;
+
+// Enum to represent the current state of the game
+enum GameState {
+  IN_PROGRESS = 0,
+  PAUSED,
+  FINISHED,
+  HIGHSCORES
+};
+
+// A square on the game board, measured in body squares from the top left corner
+struct Cell {
+	int x;
+	int y;
+};
+
+inline bool operator==(const Cell& lhs, const Cell& rhs) {
+	return lhs.x == rhs.x && lhs.y == rhs.y;
+}
+
+inline bool operator!=(const Cell& lhs, const Cell& rhs) {
+	return !(lhs == rhs);
+}
+
+// Column and row step of each SnakeDirection, indexed by its value
+constexpr int kdirection_dx[4] = {0, 0, 1, -1};
+constexpr int kdirection_dy[4] = {-1, 1, 0, 0};
+
+// The reverse of each SnakeDirection, UP and DOWN (and RIGHT and LEFT) differ only in the lowest bit
+constexpr SnakeDirection kopposite[4] = {DOWN, UP, LEFT, RIGHT};
+
+// The square one step from cell in direction, which may be off the board
+constexpr Cell neighbour(Cell cell, SnakeDirection direction) {
+	return Cell{cell.x + kdirection_dx[direction], cell.y + kdirection_dy[direction]};
+}
+
+// The size of a board in squares
+struct BoardSize {
+	int columns;
+	int rows;
+};
+
+/*
+The board a game started in a window of the given size plays on: squares are a fiftieth of the window width and
+there are as many rows as fit. The board keeps its size for the rest of the game, resizing the window only changes
+how big the squares are drawn (see BoardProjection). A minimised window (0 pixels either way) is measured as one
+pixel, and the board always has at least one row and one column
+*/
+inline BoardSize boardForWindow(int window_width, int window_height) {
+	window_width = std::max(window_width, 1);
+	window_height = std::max(window_height, 1);
+	float square = 0.02f * window_width;
+	BoardSize board;
+	board.columns = std::max(static_cast<int>(std::floor(static_cast<float>(window_width) / square + 0.001f)), 1);
+	board.rows = std::max(static_cast<int>(std::floor(static_cast<float>(window_height) / square + 0.001f)), 1);
+	return board;
+}
+
+// A position or size in pixels, or a position on the board in squares where it has to be fractional (animation)
+struct Vec2 {
+	float x;
+	float y;
+
+	Vec2() : x(0), y(0) {};
+	Vec2(float new_x, float new_y) : x(new_x), y(new_y) {};
+	void set(float new_x, float new_y) { x = new_x; y = new_y; }
+};
+
+/*
+Where the board appears in a window: squares are as large as they can be with the whole board in view, and the board
+is centred. The game itself never deals in pixels, this is only applied when drawing, so a resize costs the same
+however long the snake is
+*/
+struct BoardProjection {
+	float square_size; // Size of a board square in pixels
+	Vec2 origin; // Pixel position of the top left corner of the board
+
+	BoardProjection() : square_size(0) {};
+	BoardProjection(BoardSize board, int window_width, int window_height) {
+		square_size = std::min(static_cast<float>(window_width) / std::max(board.columns, 1),
+			static_cast<float>(window_height) / std::max(board.rows, 1));
+		origin.set((window_width - board.columns * square_size) / 2, (window_height - board.rows * square_size) / 2);
+	}
+	Vec2 toPixels(Vec2 square) const { return Vec2(origin.x + square.x * square_size, origin.y + square.y * square_size); }
+	Vec2 toPixels(Cell square) const { return toPixels(Vec2(static_cast<float>(square.x), static_cast<float>(square.y))); }
+};
+
+// An rgb color with 8 bits per channel
+struct Color {
+	unsigned char r;
+	unsigned char g;
+	unsigned char b;
+
+	Color() : r(0), g(0), b(0) {};
+	Color(unsigned char new_r, unsigned char new_g, unsigned char new_b) : r(new_r), g(new_g), b(new_b) {};
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "binary_io.h"
+#include "leaderboard.h"
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace snakelinkedlist;
+
+static const char kmagic[4] = {'S', 'N', 'K', 'L'};
+static const uint32_t kversion = 1;
+static const size_t kheader_size = sizeof(kmagic) + sizeof(kversion);
+
+const int Leaderboard::kmax_score;
+
+Leaderboard::Leaderboard(int sync_every) : sync_every_(std::max(sync_every, 1)) {
+}
+
+Leaderboard::~Leaderboard() {
+	close();
+}
+
+void Leaderboard::close() {
+	if (log_ != nullptr) {
+		flush();
+		std::fclose(log_);
+		log_ = nullptr;
+	}
+}
+
+/*
+Reads every record in the log and indexes it. Reading stops at the first record that runs past the end of the file,
+which can only be a record cut short by a crash, or that has a score no game can reach, which can only be damage.
+The file is cut back to the last whole record so new records follow on from it
+*/
+bool Leaderboard::open(const std::string& path) {
+	close();
+	entries_.clear();
+	score_tree_.clear();
+	entries_by_score_.clear();
+	players_.clear();
+
+	size_t valid_size = 0;
+	{
+		MappedFile file;
+		if (file.open(path) && file.size() > 0) {
+			if (file.size() < kheader_size || std::memcmp(file.data(), kmagic, sizeof(kmagic)) != 0) {
+				return false;
+			}
+			BinaryReader in(file.data() + sizeof(kmagic), file.size() - sizeof(kmagic));
+			uint32_t version;
+			in.read(version);
+			if (version != kversion) {
+				return false;
+			}
+
+			valid_size = kheader_size;
+			while (in.remaining() > 0) {
+				ScoreEntry entry;
+				int32_t score;
+				uint8_t player_length;
+				in.read(score);
+				in.read(entry.seed);
+				in.read(entry.time);
+				in.read(entry.ticks);
+				in.read(player_length);
+				if (!in.ok() || in.remaining() < player_length || score < 0 || score > kmax_score) {
+					break;
+				}
+				entry.score = score;
+				entry.player.resize(player_length);
+				in.readBytes(&entry.player[0], player_length);
+				index(entry);
+				valid_size = sizeof(kmagic) + in.getPosition();
+			}
+		}
+	}
+
+	if (valid_size == 0) {
+		log_ = std::fopen(path.c_str(), "w+b");
+		if (log_ == nullptr) {
+			return false;
+		}
+		std::fwrite(kmagic, 1, sizeof(kmagic), log_);
+		std::fwrite(&kversion, sizeof(kversion), 1, log_);
+		return flush();
+	}
+
+	log_ = std::fopen(path.c_str(), "r+b");
+	if (log_ == nullptr) {
+		return false;
+	}
+#ifdef _WIN32
+	bool truncated = _chsize_s(_fileno(log_), static_cast<long long>(valid_size)) == 0;
+#else
+	bool truncated = ftruncate(fileno(log_), static_cast<off_t>(valid_size)) == 0;
+#endif
+	return truncated && std::fseek(log_, 0, SEEK_END) == 0;
+}
+
+bool Leaderboard::add(ScoreEntry entry) {
+	entry.score = std::min(std::max(entry.score, 0), kmax_score);
+	if (entry.player.size() > kmax_player_length) {
+		entry.player.resize(kmax_player_length);
+	}
+	index(entry);
+	if (log_ == nullptr) {
+		return true;
+	}
+
+	std::vector<uint8_t> record;
+	BinaryWriter out(record);
+	out.write(static_cast<int32_t>(entry.score));
+	out.write(entry.seed);
+	out.write(entry.time);
+	out.write(entry.ticks);
+	out.write(static_cast<uint8_t>(entry.player.size()));
+	out.writeBytes(entry.player.data(), entry.player.size());
+	bool written = std::fwrite(record.data(), 1, record.size(), log_) == record.size();
+
+	unsynced_++;
+	if (unsynced_ >= sync_every_) {
+		written = flush() && written;
+	}
+	return written;
+}
+
+bool Leaderboard::flush() {
+	if (log_ == nullptr) {
+		return true;
+	}
+	unsynced_ = 0;
+	if (std::fflush(log_) != 0) {
+		return false;
+	}
+#ifdef _WIN32
+	return _commit(_fileno(log_)) == 0;
+#else
+	return fsync(fileno(log_)) == 0;
+#endif
+}
+
+void Leaderboard::index(const ScoreEntry& entry) {
+	uint32_t position = static_cast<uint32_t>(entries_.size());
+	entries_.push_back(entry);
+
+	growScoreTree(entry.score);
+	entries_by_score_[entry.score].push_back(position);
+	for (size_t i = entry.score + 1; i < score_tree_.size(); i += i & (0 - i)) {
+		score_tree_[i]++;
+	}
+
+	PlayerRecord& player = players_[entry.player];
+	if (player.runs == 0 || entry.score > entries_[player.best].score) {
+		player.best = position;
+	}
+	player.runs++;
+	player.total_score += entry.score;
+}
+
+/*
+Scores only grow as far as the largest board allows, so the tree is sized to the highest score seen and doubled
+(rebuilt in linear time from the per score lists) when a higher one comes in
+*/
+void Leaderboard::growScoreTree(int score) {
+	size_t needed = static_cast<size_t>(score) + 1;
+	if (needed < score_tree_.size()) {
+		return;
+	}
+	size_t capacity = std::max(std::max(needed, 2 * entries_by_score_.size()), static_cast<size_t>(64));
+	entries_by_score_.resize(capacity);
+	score_tree_.assign(capacity + 1, 0);
+	for (size_t i = 1; i <= capacity; i++) {
+		score_tree_[i] += static_cast<long long>(entries_by_score_[i - 1].size());
+		size_t parent = i + (i & (0 - i));
+		if (parent <= capacity) {
+			score_tree_[parent] += score_tree_[i];
+		}
+	}
+}
+
+long long Leaderboard::countAtMost(int score) const {
+	long long count = 0;
+	size_t i = std::min(static_cast<size_t>(std::max(score + 1, 0)), score_tree_.size() - 1);
+	for (; i > 0; i -= i & (0 - i)) {
+		count += score_tree_[i];
+	}
+	return count;
+}
+
+size_t Leaderboard::size() const {
+	return entries_.size();
+}
+
+long long Leaderboard::getRank(int score) const {
+	if (entries_.empty()) {
+		return 1;
+	}
+	return 1 + static_cast<long long>(entries_.size()) - countAtMost(score);
+}
+
+/*
+The kth best game is game size() - 1 - k counting up from the worst, found by descending the Fenwick tree one power
+of two at a time to the score whose count takes the total past it, then picked from that score's games
+*/
+const ScoreEntry& Leaderboard::getRanked(size_t k) const {
+	long long remaining = static_cast<long long>(entries_.size() - 1 - k);
+	size_t position = 0;
+	size_t step = 1;
+	while (step * 2 < score_tree_.size()) {
+		step *= 2;
+	}
+	for (; step > 0; step /= 2) {
+		if (position + step < score_tree_.size() && score_tree_[position + step] <= remaining) {
+			position += step;
+			remaining -= score_tree_[position];
+		}
+	}
+	const std::vector<uint32_t>& tied = entries_by_score_[position];
+	return entries_[tied[tied.size() - 1 - static_cast<size_t>(remaining)]];
+}
+
+std::vector<ScoreEntry> Leaderboard::getTop(size_t count) const {
+	std::vector<ScoreEntry> top;
+	count = std::min(count, entries_.size());
+	top.reserve(count);
+	for (size_t k = 0; k < count; k++) {
+		top.push_back(getRanked(k));
+	}
+	return top;
+}
+
+bool Leaderboard::getPlayer(const std::string& player, PlayerStats& stats) const {
+	auto found = players_.find(player.substr(0, kmax_player_length));
+	if (found == players_.end()) {
+		return false;
+	}
+	stats.runs = found->second.runs;
+	stats.total_score = found->second.total_score;
+	stats.best = entries_[found->second.best];
+	stats.rank = getRank(stats.best.score);
+	return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace snakelinkedlist {
+
+// One finished game
+struct ScoreEntry {
+	int score = 0; // Food eaten
+	std::string player; // Who played, at most kmax_player_length bytes are kept
+	uint32_t seed = 0; // Seed of the game, with the replay it reproduces the run
+	int64_t time = 0; // When the game ended, seconds since the Unix epoch
+	int64_t ticks = 0; // Length of the game in ticks
+};
+
+// Totals for one player, see Leaderboard::getPlayer()
+struct PlayerStats {
+	long long runs = 0; // Games played
+	long long total_score = 0; // Sum of the scores of every game
+	ScoreEntry best; // The player's highest scoring game, the earliest one on a tie
+	long long rank = 0; // Rank of the best game, see Leaderboard::getRank()
+};
+
+/*
+Every finished game, kept on disk and indexed for ranking.
+
+The file is an append only log: a header ("SNKL", u32 version) followed by one record per game in the order they
+were added (i32 score, u32 seed, i64 time, i64 ticks, u8 player name length, the name). A log is never rewritten, so
+a crash can at worst leave a partial record at the end, which open() cuts off. A record with a score outside 0 to
+kmax_score can only be damage, and open() cuts the log off there too. Records are handed to the OS as they are added
+but only forced to disk (fsync) every sync_every records and by flush(), so adding a game doesn't wait on the disk.
+
+On open() the log is read once to rebuild the indexes:
+	a Fenwick tree counting the games with each score, so the rank of a score and the kth best game are found in
+	O(log of the highest score), however many games there are
+	the games with each score in the order they were added, which breaks ties (the earlier game ranks higher)
+	a hash map from player to their totals and best game
+*/
+class Leaderboard {
+private:
+	std::vector<ScoreEntry> entries_; // Every game in the order they were added
+	std::vector<long long> score_tree_; // Fenwick tree of game counts, index score + 1
+	std::vector<std::vector<uint32_t>> entries_by_score_; // Indexes into entries_ of the games with each score, oldest first
+	struct PlayerRecord {
+		long long runs = 0;
+		long long total_score = 0;
+		uint32_t best = 0; // Index into entries_
+	};
+	std::unordered_map<std::string, PlayerRecord> players_; // Totals per player
+
+	std::FILE* log_ = nullptr; // The open log, nullptr when the leaderboard only lives in memory
+	int sync_every_; // Records written between fsyncs
+	int unsynced_ = 0; // Records written since the last fsync
+
+	void index(const ScoreEntry& entry); // Adds a game to the in memory indexes
+	void growScoreTree(int score); // Makes room in the Fenwick tree for scores up to score
+	long long countAtMost(int score) const; // Games with a score of at most score
+	void close(); // Flushes and closes the log
+
+public:
+	static const int kmax_player_length = 255; // Longer names are cut off
+	static const int kdefault_sync_every = 16; // Games that can be lost if the machine loses power
+	static const int kmax_score = 1 << 20; // Highest score kept, a 1024x1024 board filled. The indexes grow with the highest score
+
+	explicit Leaderboard(int sync_every = kdefault_sync_every);
+	~Leaderboard(); // Flushes the log
+	Leaderboard(const Leaderboard&) = delete;
+	Leaderboard& operator=(const Leaderboard&) = delete;
+
+	bool open(const std::string& path); // Loads (or creates) a log and appends to it from then on, false if it can't be read or written
+	bool add(ScoreEntry entry); // Records a finished game with its score clamped to 0 to kmax_score, false if it couldn't be written to the log (it is still ranked)
+	bool flush(); // Forces every game added so far to disk
+
+	size_t size() const; // Number of games recorded
+	long long getRank(int score) const; // 1 + the number of games with a higher score, the rank a game with this score would have
+	const ScoreEntry& getRanked(size_t k) const; // The kth best game (0 is the best), k < size()
+	std::vector<ScoreEntry> getTop(size_t count) const; // The best count games, best first
+	bool getPlayer(const std::string& player, PlayerStats& stats) const; // Looks up a player, false if they have no games
+};
+} // namespace snakelinkedlist
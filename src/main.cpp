@@ -2,6 +2,7 @@
 #include "ofApp.h"
 
 #define DISPLAY_MODE OF_WINDOW // Can be OF_WINDOW or OF_FULLSCREEN
+#define TICK_RATE 12 // How many squares per second the snake moves, independent of the frame rate
 
 /*
 CS126 Snake
@@ -24,9 +25,8 @@ CS126 Snake
 */
 int main() {
 	ofSetupOpenGL(640, 480, DISPLAY_MODE); // setup the GL context
-	ofSetFrameRate(12); // An appropriate framerate that moves the snake at a good speed
-						// Due to the simple nature of our objects rendering things this slow should not cause visual discomfort or lage
+	ofSetVerticalSync(true); // Render at the display refresh rate, the game itself steps at TICK_RATE (see FixedTimestep)
 	
 	// this kicks off the running of my app
-	ofRunApp(new snakelinkedlist::snakeGame());
+	ofRunApp(new snakelinkedlist::snakeGame(TICK_RATE));
 }
@@ -0,0 +1,66 @@
+#include <fstream>
+#include <iterator>
+#include "mapped_file.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace snakelinkedlist;
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const std::string& path) {
+	close();
+#ifndef _WIN32
+	int descriptor = ::open(path.c_str(), O_RDONLY);
+	if (descriptor < 0) {
+		return false;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) != 0) {
+		::close(descriptor);
+		return false;
+	}
+	size_t size = static_cast<size_t>(status.st_size);
+	void* mapping = nullptr;
+	if (size > 0) {
+		mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	}
+	// The mapping stays valid after the descriptor is closed
+	::close(descriptor);
+	if (mapping == MAP_FAILED) {
+		return false;
+	}
+	data_ = static_cast<const uint8_t*>(mapping);
+	size_ = size;
+	return true;
+#else
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	copy_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	data_ = copy_.data();
+	size_ = copy_.size();
+	return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+	if (data_ != nullptr) {
+		munmap(const_cast<uint8_t*>(data_), size_);
+	}
+#else
+	copy_.clear();
+	copy_.shrink_to_fit();
+#endif
+	data_ = nullptr;
+	size_ = 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace snakelinkedlist {
+
+/*
+Read only view of a whole file. On POSIX systems the file is memory mapped, so opening costs the same however big
+the file is and only the pages that are actually read are ever loaded. Elsewhere the file is read into memory.
+*/
+class MappedFile {
+private:
+	const uint8_t* data_ = nullptr; // Start of the file contents
+	size_t size_ = 0; // Length of the file
+	std::vector<uint8_t> copy_; // Holds the contents where files can't be mapped
+
+public:
+	MappedFile() {};
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path); // Maps the file, closing any file already open. False if it can't be opened
+	void close(); // Unmaps the file
+	const uint8_t* data() const { return data_; }
+	size_t size() const { return size_; }
+};
+} // namespace snakelinkedlist
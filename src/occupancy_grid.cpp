@@ -0,0 +1,134 @@
+#include "occupancy_grid.h"
+
+using namespace snakelinkedlist;
+
+OccupancyGrid::OccupancyGrid() : columns_(0), rows_(0) {
+}
+
+void OccupancyGrid::reset(int columns, int rows) {
+	columns_ = columns;
+	rows_ = rows;
+	counts_.assign(static_cast<size_t>(columns) * rows, 0);
+
+	free_squares_.resize(counts_.size());
+	free_position_.resize(counts_.size());
+	for (size_t i = 0; i < counts_.size(); i++) {
+		free_squares_[i] = static_cast<int>(i);
+		free_position_[i] = static_cast<int>(i);
+	}
+}
+
+void OccupancyGrid::markOccupied(int index) {
+	int position = free_position_[index];
+	int last = free_squares_.back();
+	free_squares_[position] = last;
+	free_position_[last] = position;
+	free_squares_.pop_back();
+	free_position_[index] = -1;
+}
+
+void OccupancyGrid::markFree(int index) {
+	free_position_[index] = static_cast<int>(free_squares_.size());
+	free_squares_.push_back(index);
+}
+
+bool OccupancyGrid::inBounds(Cell cell) const {
+	return cell.x >= 0 && cell.y >= 0 && cell.x < columns_ && cell.y < rows_;
+}
+
+void OccupancyGrid::add(Cell cell) {
+	if (inBounds(cell)) {
+		int index = cell.y * columns_ + cell.x;
+		if (counts_[index]++ == 0) {
+			markOccupied(index);
+		}
+	}
+}
+
+void OccupancyGrid::remove(Cell cell) {
+	if (inBounds(cell)) {
+		int index = cell.y * columns_ + cell.x;
+		if (--counts_[index] == 0) {
+			markFree(index);
+		}
+	}
+}
+
+int OccupancyGrid::count(Cell cell) const {
+	if (!inBounds(cell)) {
+		return 0;
+	}
+	return counts_[cell.y * columns_ + cell.x];
+}
+
+int OccupancyGrid::getFreeCount() const {
+	return static_cast<int>(free_squares_.size());
+}
+
+Cell OccupancyGrid::getFree(int i) const {
+	Cell cell;
+	cell.x = free_squares_[i] % columns_;
+	cell.y = free_squares_[i] / columns_;
+	return cell;
+}
+
+/*
+Which empty square food lands on depends on the order of the empty squares, so restoring a saved game has to restore
+the order as well as the squares. The order is only replaced if it lists every empty square exactly once.
+*/
+bool OccupancyGrid::setFreeOrder(const std::vector<int>& squares) {
+	if (squares.size() != free_squares_.size()) {
+		return false;
+	}
+
+	std::vector<int> position(counts_.size(), -1);
+	for (size_t i = 0; i < squares.size(); i++) {
+		int square = squares[i];
+		if (square < 0 || static_cast<size_t>(square) >= counts_.size() || counts_[square] != 0 || position[square] != -1) {
+			return false;
+		}
+		position[square] = static_cast<int>(i);
+	}
+
+	free_squares_ = squares;
+	free_position_.swap(position);
+	return true;
+}
+
+int OccupancyGrid::getColumns() const {
+	return columns_;
+}
+
+int OccupancyGrid::getRows() const {
+	return rows_;
+}
+
+// The arrays are added as they are, free_squares_ holds ints which are the int32_t the format stores
+void OccupancyGrid::writeFlat(FlatWriter& out) const {
+	static_assert(sizeof(int) == sizeof(int32_t), "empty squares are saved as they are kept");
+	out.header().columns = columns_;
+	out.header().rows = rows_;
+	out.header().counts = out.add(counts_.data(), counts_.size() * sizeof(uint16_t));
+	out.header().free_count = static_cast<uint32_t>(free_squares_.size());
+	out.header().free_squares = out.add(free_squares_.data(), free_squares_.size() * sizeof(int));
+}
+
+/*
+The counts and the empty squares are copied in whole, then one pass over the empty squares rebuilds where each sits.
+An empty square off the board is left out there rather than written out of bounds, so a save that skipped
+FlatGameView::validate() can leave the game wrong but never reads or writes outside the grid
+*/
+void OccupancyGrid::readFlat(const FlatGameView& in) {
+	const FlatGameHeader& header = in.header();
+	columns_ = header.columns;
+	rows_ = header.rows;
+	size_t squares = static_cast<size_t>(columns_) * rows_;
+	counts_.assign(in.getCounts(), in.getCounts() + squares);
+	free_squares_.assign(in.getFreeSquares(), in.getFreeSquares() + header.free_count);
+	free_position_.assign(squares, -1);
+	for (size_t i = 0; i < free_squares_.size(); i++) {
+		if (static_cast<size_t>(free_squares_[i]) < squares) {
+			free_position_[free_squares_[i]] = static_cast<int>(i);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "flat_state.h"
+#include "game_types.h"
+
+namespace snakelinkedlist {
+
+/*
+Counts how many snake segments cover each square of the board.
+The snake updates it as the head enters a square and the tail leaves one, so asking
+whether a square is free (or doubly covered, which means the snake ran into itself) is a single lookup.
+Squares outside of the board are never stored, callers check inBounds() first.
+
+It also keeps every empty square in a dense array, with each square's position in that array so a square can be
+swap removed when it fills up and appended when it empties. Picking a random empty square (e.g. for food) is then
+a single uniform draw however full the board is.
+*/
+class OccupancyGrid {
+private:
+	int columns_; // Number of squares across the board
+	int rows_; // Number of squares down the board
+	std::vector<uint16_t> counts_; // Segments covering each square, stored row by row
+	std::vector<int> free_squares_; // Row by row index of every empty square, in no particular order
+	std::vector<int> free_position_; // Where each square sits in free_squares_, -1 if it is occupied
+
+	void markOccupied(int index); // Swap removes the square from free_squares_
+	void markFree(int index); // Appends the square to free_squares_
+
+public:
+	OccupancyGrid(); // Creates an empty 0x0 grid
+	void reset(int columns, int rows); // Resizes the grid and marks every square as empty
+	bool inBounds(Cell cell) const; // Whether the square lies on the board
+	void add(Cell cell); // A segment entered the square, ignored if it is off the board
+	void remove(Cell cell); // A segment left the square, ignored if it is off the board
+	int count(Cell cell) const; // The number of segments on the square, 0 when off the board
+	int getFreeCount() const; // The number of empty squares on the board
+	Cell getFree(int i) const; // The ith empty square, 0 <= i < getFreeCount(), order changes as the snake moves
+	bool setFreeOrder(const std::vector<int>& squares); // Puts the empty squares (row by row indices) in this order, false if they aren't exactly the empty squares
+	int getColumns() const; // Gets the board width in squares
+	void writeFlat(FlatWriter& out) const; // Adds the board size, the counts and the empty squares in order to a flat save
+	void readFlat(const FlatGameView& in); // Restores them from a flat save
+	int getRows() const; // Gets the board height in squares
+};
+} // namespace snakelinkedlist
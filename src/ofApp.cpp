@@ -1,46 +1,88 @@
 #include "ofApp.h"
+#include <cstdio>
 #include <iostream>
 
 using namespace snakelinkedlist;
 
+const char* snakeGame::kreplay_file_ = "last_game.replay";
+const char* snakeGame::kleaderboard_file_ = "leaderboard.log";
+const char* snakeGame::kprofile_file_ = "profile.json";
+
+// Text drawn every frame is kept in strings made once: ofDrawBitmapString() converts anything but a std::string
+// through a stringstream, and building a message per frame would allocate
+static const std::string kpause_message = "P to Unpause!";
+static const std::string khigh_scores_title = "High Scores:";
+
+snakeGame::snakeGame(double ticks_per_second, std::string player)
+	: game_thread_(ofGetWindowWidth(), ofGetWindowHeight(), ticks_per_second), player_(std::move(player)) {
+}
+
 // Setup method
 void snakeGame::setup(){
 	ofSetWindowTitle("Snake126");
 
-	srand(static_cast<unsigned>(time(0))); // Seed random with current time
+	seeds_.setSeed(static_cast<uint64_t>(time(0))); // Every game gets its own seed, drawn from a clock seeded generator
+	if (!leaderboard_.open(ofToDataPath(kleaderboard_file_))) {
+		std::cerr << "Could not open " << kleaderboard_file_ << ", scores will not be saved" << std::endl;
+	}
+	refreshHighScores();
+#ifdef SNAKE_ENABLE_PROFILING
+	profile_panel_.setup("Profile (F1, F2 saves)");
+#endif
+	game_thread_.start(seeds_.next());
+}
+
+// The thread is stopped first so no game can finish after the leaderboard is flushed
+void snakeGame::exit() {
+	game_thread_.stop();
+	GameEvent event;
+	while (game_thread_.pollEvent(event)) {
+		handleEvent(event);
+	}
+	leaderboard_.flush();
 }
 
 /* 
 Update function called before every draw
-If the function should update when it is called it will:
-1. Check to see if the game is in progress, if it is paused or over it should not update.
-2. Check to see if the current head of the snake intersects the food pellet. If so:
-    * The snake should grow by length 1 in its current direction
-    * The food should be moved to a new random location
-3. Update the snake in the current direction it is moving
-4. Check to see if the snakes new position has resulted in its death and the end of the game
+The simulation runs on its own thread at a fixed rate (see GameThread), so this only picks up the newest
+snapshot of the game and handles what the simulation reported since the last frame
 */
 void snakeGame::update() {
-	if (should_update_) {
-		if (current_state_ == IN_PROGRESS) {
-			ofVec2f snake_body_size = game_snake_.getBodySize();
-			ofVec2f head_pos = game_snake_.getHead()->position;
-			ofRectangle snake_rect(head_pos.x, head_pos.y, snake_body_size.x, snake_body_size.y);
-
-			if (snake_rect.intersects(game_food_.getFoodRect())) {
-				game_snake_.eatFood(game_food_.getColor());
-				game_food_.rebase();
-			}
-			game_snake_.update();
-			
-			if (game_snake_.isDead()) {
-				current_state_ = FINISHED;
-                addToHighScores(game_snake_.getFoodEaten());
-			}
-		}
+	SNAKE_PROFILE_SCOPE("app/update");
+	game_thread_.updateSnapshot();
+	GameEvent event;
+	while (game_thread_.pollEvent(event)) {
+		handleEvent(event);
 	}
+}
 
-	should_update_ = true;
+/*
+Events arrive in the order the simulation thread saw them, so the replay gets the turns and resizes
+against the ticks they were applied on, whenever the window thread gets around to reading them
+1. A new game starts recording and lays out the board
+2. Accepted turns and resizes are recorded
+3. A finished game records the final score and saves the replay of the game
+*/
+void snakeGame::handleEvent(const GameEvent& event) {
+	switch (event.kind) {
+		case GAME_STARTED:
+			recorder_.start(event.seed, event.width, event.height);
+			projection_ = BoardProjection(boardForWindow(event.width, event.height), ofGetWindowWidth(), ofGetWindowHeight());
+			body_mesh_.invalidate();
+			break;
+		case TURN_QUEUED:
+			recorder_.recordTurn(event.tick, event.direction);
+			break;
+		case WINDOW_RESIZED:
+			recorder_.recordResize(event.tick, event.width, event.height);
+			break;
+		case GAME_FINISHED:
+			game_over_message_ = "You Lost! Final Score: " + std::to_string(event.score);
+			addToHighScores(event);
+			recorder_.finish(event.tick);
+			recorder_.save(ofToDataPath(kreplay_file_));
+			break;
+	}
 }
 
 /*
@@ -50,129 +92,247 @@ Draws the current state of the game with the following logic
 3. Draw the current position of the food and of the snake
 */
 void snakeGame::draw(){
-	if(current_state_ == PAUSED) {
-		drawGamePaused();
-    } else if (current_state_ == HIGHSCORES) {
-        drawHighScores();
-    }
-	else if(current_state_ == FINISHED) {
-		drawGameOver();
-        drawHighScores();
+	{
+		SNAKE_PROFILE_SCOPE("app/draw");
+		draw_calls_ = 0;
+		GameState current_state = game_thread_.getSnapshot().game.getState();
+		if(current_state == PAUSED) {
+			drawGamePaused();
+		} else if (current_state == HIGHSCORES) {
+			drawHighScores();
+		}
+		else if(current_state == FINISHED) {
+			drawGameOver();
+			drawHighScores();
+		}
+		drawFood();
+		drawSnake();
+		SNAKE_PROFILE_COUNT("draw_calls", draw_calls_);
 	}
-	drawFood();
-	drawSnake();
+#ifdef SNAKE_ENABLE_PROFILING
+	drawProfilePanel();
+#endif
 }
 
 /* 
 Function that handles actions based on user key presses
 1. if key == F12, toggle fullscreen
+   F1 shows or hides the profile panel and F2 saves the figures to kprofile_file_ (profiling builds only)
 2. if key == p and game is not over, toggle pause
+   if key == b, hand the steering to the autopilot (see Autopilot) or take it back
 3. if game is in progress handle WASD action
 4. if key == r and game is over reset it
 
 WASD logic:
 Let dir be the direction that corresponds to a key
-if current direction is not dir (Prevents key spamming to rapidly update the snake)
- and current_direction is not opposite of dir (Prevents the snake turning and eating itself)
- Update direction of snake and force a game update (see ofApp.h for why)
+post a turn to dir, the simulation applies one queued turn per tick (see Simulation::queueTurn())
+turns the simulation accepted come back as events and are recorded for the replay
+Input is posted to the simulation thread rather than applied here, see GameThread
 */
 void snakeGame::keyPressed(int key){
 	if (key == OF_KEY_F12) {
 		ofToggleFullscreen();
 		return;
 	}
+#ifdef SNAKE_ENABLE_PROFILING
+	if (key == OF_KEY_F1) {
+		show_profile_ = !show_profile_;
+		return;
+	} else if (key == OF_KEY_F2) {
+		Profiler::dumpJson(ofToDataPath(kprofile_file_));
+		return;
+	}
+#endif
 
 	int upper_key = toupper(key); // Standardize on upper case
 
-	if (upper_key == 'P' && current_state_ != FINISHED) {
-		// Pause or unpause
-		current_state_ = (current_state_ == IN_PROGRESS) ? PAUSED : IN_PROGRESS;
-    } else if (upper_key == 'H' && current_state_ != FINISHED) {
-        current_state_ = (current_state_ == IN_PROGRESS) ? HIGHSCORES : IN_PROGRESS;;
-    }
-	else if (current_state_ == IN_PROGRESS)
+	GameCommand command = {TOGGLE_PAUSE, RIGHT, 0, 0, 0};
+	if (upper_key == 'P') {
+		game_thread_.post(command);
+	} else if (upper_key == 'H') {
+		command.kind = TOGGLE_HIGH_SCORES;
+		game_thread_.post(command);
+	} else if (upper_key == 'B') {
+		command.kind = TOGGLE_AUTOPILOT;
+		game_thread_.post(command);
+	}
+	else if (upper_key == 'W' || upper_key == 'A' || upper_key == 'S' || upper_key == 'D')
 	{
-		SnakeDirection current_direction = game_snake_.getDirection();
-
-		// If current direction has changed to a valid new one, force an immediate update and skip the next frame update
-		if (upper_key == 'W' && current_direction != DOWN && current_direction != UP) {
-			game_snake_.setDirection(UP);
-			update();
-			should_update_ = false;
-		}
-		else if (upper_key == 'A' && current_direction != RIGHT && current_direction != LEFT) {
-			game_snake_.setDirection(LEFT);
-			update();
-			should_update_ = false;
-		}
-		else if ((upper_key == 'S') && current_direction != UP && current_direction != DOWN) {
-			game_snake_.setDirection(DOWN);
-			update();
-			should_update_ = false;
-		}
-		else if (upper_key == 'D' && current_direction != LEFT && current_direction != RIGHT) {
-			game_snake_.setDirection(RIGHT);
-			update();
-			should_update_ = false;
+		SnakeDirection new_direction = RIGHT;
+		if (upper_key == 'W') {
+			new_direction = UP;
+		} else if (upper_key == 'A') {
+			new_direction = LEFT;
+		} else if (upper_key == 'S') {
+			new_direction = DOWN;
 		}
+
+		command.kind = QUEUE_TURN;
+		command.direction = new_direction;
+		game_thread_.post(command);
 	}
-	else if (upper_key == 'R' && current_state_ == FINISHED) {
-			reset();
+	else if (upper_key == 'R' && game_thread_.getSnapshot().game.getState() == FINISHED) {
+		command.kind = RESET_GAME;
+		command.seed = seeds_.next();
+		game_thread_.post(command);
 	}
 }
 
-void snakeGame::reset() {
-	game_snake_ = Snake();
-	game_food_.rebase();
-	current_state_ = IN_PROGRESS;
+// The game is kept in board squares, so a resize only moves and scales where the board is drawn
+void snakeGame::windowResized(int w, int h){
+	GameCommand command = {RESIZE_WINDOW, RIGHT, 0, w, h};
+	game_thread_.post(command);
+	projection_ = BoardProjection(game_thread_.getSnapshot().game.getBoardSize(), w, h);
 }
 
-void snakeGame::windowResized(int w, int h){
-	game_food_.resize(w, h);
-	game_snake_.resize(w, h);
+int snakeGame::getDrawCalls() const {
+	return draw_calls_;
 }
 
 void snakeGame::drawFood() {
-	ofSetColor(game_food_.getColor());
-	ofDrawRectangle(game_food_.getFoodRect());
+	SNAKE_PROFILE_SCOPE("draw/food");
+	const SnakeFood& food = game_thread_.getSnapshot().game.getFood();
+	Color food_color = food.getColor();
+	Vec2 food_position = projection_.toPixels(food.getCell());
+	ofSetColor(food_color.r, food_color.g, food_color.b);
+	ofDrawRectangle(food_position.x, food_position.y, projection_.square_size, projection_.square_size);
+	draw_calls_++;
 }
 
+/*
+Draws the whole body from one mesh (see BodyMesh). Only the head and the vacated tail square move between ticks:
+they are drawn part of the way between their previous and current squares so the snake glides
+even though the simulation only moves it once per tick.
+The mesh is in board squares and is scaled onto the window here, so it never changes when the window does
+*/
 void snakeGame::drawSnake() {
-	ofVec2f snake_body_size = game_snake_.getBodySize();
-	ofVec2f head_pos = game_snake_.getHead()->position;
-	ofSetColor(game_snake_.getHead()->color);
-	ofDrawRectangle(head_pos.x, head_pos.y, snake_body_size.x, snake_body_size.y);
+	SNAKE_PROFILE_SCOPE("draw/snake");
+	const GameSnapshot& snapshot = game_thread_.getSnapshot();
+	float alpha = (snapshot.game.getState() == IN_PROGRESS) ? snapshot.alpha(std::chrono::steady_clock::now()) : 1.0f;
+	body_mesh_.sync(snapshot.game.getSnake(), alpha);
+	uploadBodyMesh();
+
+	ofSetColor(255);
+	ofPushMatrix();
+	ofTranslate(projection_.origin.x, projection_.origin.y);
+	ofScale(projection_.square_size, projection_.square_size);
+	for (size_t i = 0; i < body_mesh_.getDrawRangeCount(); i++) {
+		BodyMesh::DrawRange range = body_mesh_.getDrawRange(i);
+		body_vbo_.draw(GL_TRIANGLES, range.first * BodyMesh::kvertices_per_quad, range.count * BodyMesh::kvertices_per_quad);
+		draw_calls_++;
+	}
+	ofPopMatrix();
+}
 
-	for (SnakeBody* curr = game_snake_.getHead(); curr != NULL; curr = curr->next) {
-		ofVec2f currPos = curr->position;
-		ofSetColor(curr->color);
-		ofDrawRectangle(currPos.x, currPos.y, snake_body_size.x, snake_body_size.y);
+void snakeGame::uploadBodyMesh() {
+	const std::vector<float>& vertices = body_mesh_.getVertices();
+	const std::vector<float>& colors = body_mesh_.getColors();
+	const size_t quad_bytes = BodyMesh::kvertices_per_quad * BodyMesh::kfloats_per_vertex * sizeof(float);
+	const size_t color_bytes = BodyMesh::kvertices_per_quad * BodyMesh::kfloats_per_color * sizeof(float);
+
+	if (body_mesh_.needsFullUpload()) {
+		body_vertex_buffer_.allocate(vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
+		body_color_buffer_.allocate(colors.size() * sizeof(float), colors.data(), GL_DYNAMIC_DRAW);
+		body_vbo_.setVertexBuffer(body_vertex_buffer_, BodyMesh::kfloats_per_vertex, BodyMesh::kfloats_per_vertex * sizeof(float));
+	} else {
+		for (size_t slot : body_mesh_.getDirtySlots()) {
+			body_vertex_buffer_.updateData(slot * quad_bytes, quad_bytes, &vertices[slot * quad_bytes / sizeof(float)]);
+		}
+		for (size_t entry : body_mesh_.getDirtyColors()) {
+			body_color_buffer_.updateData(entry * color_bytes, color_bytes, &colors[entry * color_bytes / sizeof(float)]);
+		}
 	}
+	body_mesh_.clearDirty();
+
+	// Rotating the colors to follow the ring is just a new attribute offset, nothing is uploaded for it
+	body_vbo_.setColorBuffer(body_color_buffer_, BodyMesh::kfloats_per_color * sizeof(float), body_mesh_.getColorOffset() * color_bytes);
 }
 
 void snakeGame::drawGameOver() {
-	string total_food = std::to_string(game_snake_.getFoodEaten());
-	string lose_message = "You Lost! Final Score: " + total_food;
+	SNAKE_PROFILE_SCOPE("draw/game_over");
 	ofSetColor(0, 0, 0);
-	ofDrawBitmapString(lose_message, ofGetWindowWidth() / 2, ofGetWindowHeight() / 2);
+	ofDrawBitmapString(game_over_message_, ofGetWindowWidth() / 2, ofGetWindowHeight() / 2);
 }
 
 void snakeGame::drawGamePaused() {
-	string pause_message = "P to Unpause!";
+	SNAKE_PROFILE_SCOPE("draw/paused");
 	ofSetColor(0, 0, 0);
-	ofDrawBitmapString(pause_message, ofGetWindowWidth() / 2, ofGetWindowHeight() / 2);
+	ofDrawBitmapString(kpause_message, ofGetWindowWidth() / 2, ofGetWindowHeight() / 2);
 }
 
-void snakeGame::addToHighScores(int score) {
-    high_scores.push_back(score);
-    std::sort(high_scores.begin(), high_scores.end());
-    high_scores.erase(high_scores.begin());
+/*
+Records the finished game in the leaderboard and refreshes the cached list of best games,
+which only changes when a game ends
+*/
+void snakeGame::addToHighScores(const GameEvent& finished) {
+	ScoreEntry entry;
+	entry.score = finished.score;
+	entry.player = player_;
+	entry.seed = finished.seed;
+	entry.time = static_cast<int64_t>(time(0));
+	entry.ticks = finished.tick;
+	leaderboard_.add(entry);
+	refreshHighScores();
+}
+
+void snakeGame::refreshHighScores() {
+	std::vector<ScoreEntry> best = leaderboard_.getTop(kshown_high_scores_);
+	high_score_lines_.resize(best.size());
+	for (size_t i = 0; i < best.size(); i++) {
+		high_score_lines_[i] = std::to_string(best[i].score) + "  " + best[i].player;
+	}
 }
 
 void snakeGame::drawHighScores() {
-    ofSetColor(0, 0, 0);
-    ofDrawBitmapString("High Scores:", ofGetWindowWidth() / 2, 20);
-    for (int i = high_scores.size() - 1; i > 0 ;i--) {
-        ofDrawBitmapString(high_scores[i], ofGetWindowWidth() / 2, 20 + 10*(10 - i));
-    }
+	SNAKE_PROFILE_SCOPE("draw/high_scores");
+	ofSetColor(0, 0, 0);
+	ofDrawBitmapString(khigh_scores_title, ofGetWindowWidth() / 2, 20);
+	for (size_t i = 0; i < high_score_lines_.size(); i++) {
+		ofDrawBitmapString(high_score_lines_[i], ofGetWindowWidth() / 2, 30 + 10 * i);
+	}
+}
+
+#ifdef SNAKE_ENABLE_PROFILING
+/*
+Shows the profiler figures in the panel. Labels are only rewritten every kprofile_refresh_seconds_ so the numbers
+stay readable and building them doesn't show up in the frames being measured; timers that appear later
+(e.g. the game over screen) get a label the first time they are seen
+*/
+void snakeGame::drawProfilePanel() {
+	uint64_t allocations = Profiler::getAllocations();
+	frame_allocations_ = allocations - last_allocations_;
+	last_allocations_ = allocations;
+	if (!show_profile_) {
+		return;
+	}
+
+	profile_refresh_elapsed_ += ofGetLastFrameTime();
+	if (profile_refresh_elapsed_ >= kprofile_refresh_seconds_ || profile_labels_.empty()) {
+		profile_refresh_elapsed_ = 0;
+		std::vector<std::string> lines;
+		char line[128];
+		for (const ProfileTimerStats& timer : Profiler::getTimers()) {
+			std::snprintf(line, sizeof(line), "%s p50 %.1f p99 %.1f max %.1f us", timer.name.c_str(), timer.p50_us, timer.p99_us, timer.max_us);
+			lines.push_back(line);
+		}
+		for (const ProfileCounterStats& counter : Profiler::getCounters()) {
+			lines.push_back(counter.name + " " + std::to_string(counter.total));
+		}
+		lines.push_back("allocations last frame " + std::to_string(frame_allocations_));
+		lines.push_back("draw calls last frame " + std::to_string(draw_calls_));
+		TickStats ticks = game_thread_.getTickStats();
+		std::snprintf(line, sizeof(line), "tick lateness mean %.1f max %.1f us, %lld dropped", ticks.mean_lateness_us,
+			ticks.max_lateness_us, ticks.dropped_ticks);
+		lines.push_back(line);
+
+		while (profile_labels_.size() < lines.size()) {
+			profile_labels_.emplace_back(new ofxLabel());
+			profile_panel_.add(profile_labels_.back()->setup("", ""));
+		}
+		for (size_t i = 0; i < lines.size(); i++) {
+			*profile_labels_[i] = lines[i];
+		}
+	}
+	profile_panel_.draw();
 }
+#endif
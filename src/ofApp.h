@@ -4,50 +4,77 @@
 #include <utility>
 #include <vector>
 #include <algorithm> 
+#include <memory>
+#include <string>
 
 #include "ofMain.h"
-#include "snake.h"
-#include "SnakeFood.h"
+#include "game_thread.h"
+#include "body_mesh.h"
+#include "random.h"
+#include "replay.h"
+#include "leaderboard.h"
+#include "profiler.h"
+#ifdef SNAKE_ENABLE_PROFILING
+#include "ofxGui.h"
+#endif
 
 namespace snakelinkedlist {
 
-// Enum to represent the current state of the game
-enum GameState {
-  IN_PROGRESS = 0,
-  PAUSED,
-  FINISHED,
-  HIGHSCORES
-};
-
 class snakeGame : public ofBaseApp {
 private:
-	GameState current_state_ = IN_PROGRESS; // The current state of the game, used to determine possible actions
-	Snake game_snake_; // The object that represents the user controlled snake
-	SnakeFood game_food_; // The object that represents the food pellet the user is attempting to eat with the snake
+	GameThread game_thread_; // Runs the game being played, this class only posts it input and draws its snapshots
+	Random seeds_; // Picks the seed of each new game, seeded from the clock in setup()
+	ReplayRecorder recorder_; // Records the seed and input of the current game, saved to kreplay_file_ when it ends
+	static const char* kreplay_file_; // Where the last finished game is saved, relative to the data folder
+
+	BoardProjection projection_; // Where the board squares are drawn in the window, recalculated when the window or board changes
+
+	BodyMesh body_mesh_; // The snake body as a single mesh, updated incrementally as the snake moves
+	ofBufferObject body_vertex_buffer_; // GPU copy of body_mesh_ vertices
+	ofBufferObject body_color_buffer_; // GPU copy of body_mesh_ colors
+	ofVbo body_vbo_; // Binds the two buffers above so the body draws in one call (two if the ring wraps)
+	int draw_calls_ = 0; // Draw calls issued by the last draw(), stays constant no matter how long the snake is
 
-	bool should_update_ = true;     // A flag boolean used in the update() function. Due to the frame dependent animation we've
-									// written, and the relatively low framerate, a bug exists where users can prefire direction 
-									// changes faster than a frame update. Our solution is to force a call to update on direction
-									// changes and then not update on the next frame to prevent the snake from skipping across the screen.
-	
-    std::vector<int> high_scores = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}; //vector used to score high score records
+	Leaderboard leaderboard_; // Every finished game, loaded from and appended to kleaderboard_file_
+	static const char* kleaderboard_file_; // Where the leaderboard is kept, relative to the data folder
+	static const int kshown_high_scores_ = 10; // Number of games listed on the high score screen
+	std::vector<std::string> high_score_lines_; // The best games as of the last finished game, formatted once instead of every frame
+	std::string game_over_message_; // Final score of the finished game, built when it ends so drawing it never allocates
+	std::string player_; // Name finished games are recorded under
+
+	static const char* kprofile_file_; // Where F2 saves the profiler figures, relative to the data folder
+#ifdef SNAKE_ENABLE_PROFILING
+	static constexpr double kprofile_refresh_seconds_ = 0.5; // How often the panel's figures are updated
+	ofxPanel profile_panel_; // Profiler figures, toggled with F1
+	std::vector<std::unique_ptr<ofxLabel>> profile_labels_; // One line per timer or counter
+	bool show_profile_ = false; // Whether the panel is drawn
+	double profile_refresh_elapsed_ = 0; // Seconds since the labels were last rewritten
+	uint64_t last_allocations_ = 0; // Profiler::getAllocations() at the end of the last frame
+	uint64_t frame_allocations_ = 0; // Allocations made during the last frame
+
+	void drawProfilePanel(); // Refreshes and draws the profiler panel if it is shown
+#endif
 
 	// Private helper methods to render various aspects of the game on screen.
 	void drawFood(); 
 	void drawSnake();
+	void uploadBodyMesh(); // Sends the parts of body_mesh_ that changed to the GPU
 	void drawGameOver();
 	void drawGamePaused();
     
     //deal with high scores
-    void addToHighScores(int score);
+    void addToHighScores(const GameEvent& finished);
+	void refreshHighScores(); // Rebuilds high_score_lines_ from the leaderboard
     void drawHighScores();
     
-	// Resets the game objects to their original state.
-	void reset();
+	void handleEvent(const GameEvent& event); // Records what the simulation thread reports (see GameThread::pollEvent())
 
 public:
+	explicit snakeGame(double ticks_per_second, std::string player = "player"); // Creates the game, the snake moves ticks_per_second squares per second
+
 	// Function used for one time setup
 	void setup();
+	void exit(); // Makes sure every finished game is on disk
 
 	// Main event loop functions called on every frame
 	void update();
@@ -56,5 +83,7 @@ public:
 	// Event driven functions, called on appropriate user action
 	void keyPressed(int key);
 	void windowResized(int w, int h);
+
+	int getDrawCalls() const; // Number of draw calls the last frame took
 };
 } // namespace snakelinkedlist
@@ -0,0 +1,231 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace snakelinkedlist {
+
+/**
+ * Allocator that hands out single objects from slabs of kslab_objects slots, for node based containers.
+ * Freed objects go on a free list and are reused before any new memory is requested, and recycle() returns
+ * every object to the pool at once without giving the slabs back, so a container that keeps filling and clearing
+ * itself stops calling malloc/free after warm up. Objects from one slab sit next to each other in memory.
+ *
+ * Each allocator owns its own pool: copies (rebound ones too) start with an empty pool and never free each
+ * other's memory, moving transfers the slabs. So unlike a standard allocator a copy doesn't compare equal to its
+ * source and can't free what the source allocated, an allocator only equals itself. It is only fit for a container
+ * that allocates and frees through the one allocator it keeps, and takes it over on move, as LinkedList and
+ * UnrolledLinkedList do. Standard containers may allocate through a temporary rebound copy, or swap allocators, so
+ * they must not be given one.
+ */
+template<typename T>
+class PoolAllocator {
+    // A slot holds either a live object or a link in the free list
+    union Slot {
+        Slot *next_free_;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+    };
+
+    // Slabs are chained through their header so the pool itself never allocates bookkeeping,
+    // the slots follow the header in the same block
+    struct Slab {
+        Slab *next_;
+    };
+
+    static const std::size_t kslab_header_ = (sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+
+    Slab *first_slab_;      // All slabs in the order they were allocated
+    Slab *current_slab_;    // Slab slots are being carved from, nullptr before the first allocation
+    std::size_t used_;      // Slots handed out from current_slab_ so far
+    Slot *free_list_;       // Slots returned by deallocate(), reused first
+
+    Slot *NextSlot();       // Carve the next untouched slot, moving on to (or allocating) the next slab if needed
+
+public:
+    typedef T value_type;
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::false_type is_always_equal;
+
+    static const std::size_t kslab_objects = 256;   // Objects per slab
+
+    template<typename U>
+    struct rebind {
+        typedef PoolAllocator<U> other;
+    };
+
+    PoolAllocator() noexcept;
+    PoolAllocator(const PoolAllocator &source) noexcept;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U> &source) noexcept;
+    PoolAllocator(PoolAllocator &&source) noexcept;
+    ~PoolAllocator();
+    PoolAllocator &operator=(const PoolAllocator &source) noexcept;
+    PoolAllocator &operator=(PoolAllocator &&source) noexcept;
+
+    T *allocate(std::size_t n);                     // Allocate room for n objects, single objects come from the pool
+    void deallocate(T *pointer, std::size_t n);     // Return memory from allocate(n)
+    void recycle() noexcept;                        // Return every object to the pool at once, keeping the slabs
+    void release() noexcept;                        // Free every slab, all pointers handed out become invalid
+
+    // Only the allocator itself can free its objects, copies have pools of their own
+    bool operator==(const PoolAllocator &rhs) const { return this == &rhs; }
+    bool operator!=(const PoolAllocator &rhs) const { return this != &rhs; }
+};
+
+template<typename T>
+PoolAllocator<T>::PoolAllocator() noexcept
+        : first_slab_(nullptr), current_slab_(nullptr), used_(0), free_list_(nullptr) {
+}
+
+template<typename T>
+PoolAllocator<T>::PoolAllocator(const PoolAllocator &) noexcept : PoolAllocator() {
+}
+
+template<typename T>
+template<typename U>
+PoolAllocator<T>::PoolAllocator(const PoolAllocator<U> &) noexcept : PoolAllocator() {
+}
+
+template<typename T>
+PoolAllocator<T>::PoolAllocator(PoolAllocator &&source) noexcept
+        : first_slab_(source.first_slab_), current_slab_(source.current_slab_), used_(source.used_),
+          free_list_(source.free_list_) {
+    source.first_slab_ = nullptr;
+    source.current_slab_ = nullptr;
+    source.used_ = 0;
+    source.free_list_ = nullptr;
+}
+
+template<typename T>
+PoolAllocator<T>::~PoolAllocator() {
+    release();
+}
+
+/**
+ * Copy assigning keeps our own pool, the memory we handed out is still ours to free
+ */
+template<typename T>
+PoolAllocator<T> &PoolAllocator<T>::operator=(const PoolAllocator &) noexcept {
+    return *this;
+}
+
+/**
+ * Move assigning frees our slabs and takes over the source's, the caller must be done with our objects
+ */
+template<typename T>
+PoolAllocator<T> &PoolAllocator<T>::operator=(PoolAllocator &&source) noexcept {
+    if (this == &source) {
+        return *this;
+    }
+
+    release();
+    first_slab_ = source.first_slab_;
+    current_slab_ = source.current_slab_;
+    used_ = source.used_;
+    free_list_ = source.free_list_;
+    source.first_slab_ = nullptr;
+    source.current_slab_ = nullptr;
+    source.used_ = 0;
+    source.free_list_ = nullptr;
+    return *this;
+}
+
+template<typename T>
+typename PoolAllocator<T>::Slot *PoolAllocator<T>::NextSlot() {
+    if (current_slab_ == nullptr || used_ == kslab_objects) {
+        Slab *next = (current_slab_ == nullptr) ? first_slab_ : current_slab_->next_;
+        if (next == nullptr) {
+            std::size_t bytes = kslab_header_ + kslab_objects * sizeof(Slot);
+            next = static_cast<Slab *>(::operator new(bytes));
+            next->next_ = nullptr;
+            if (current_slab_ == nullptr) {
+                first_slab_ = next;
+            } else {
+                current_slab_->next_ = next;
+            }
+        }
+        current_slab_ = next;
+        used_ = 0;
+    }
+    Slot *slots = reinterpret_cast<Slot *>(reinterpret_cast<char *>(current_slab_) + kslab_header_);
+    return &slots[used_++];
+}
+
+/**
+ * Single objects are taken from the free list, or carved from the current slab when the free list is empty.
+ * Arrays are rare for node based containers and go straight to the global heap.
+ * @param n number of objects to make room for
+ * @return uninitialized memory for n objects
+ */
+template<typename T>
+T *PoolAllocator<T>::allocate(std::size_t n) {
+    if (n != 1) {
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    Slot *slot = free_list_;
+    if (slot != nullptr) {
+        free_list_ = slot->next_free_;
+    } else {
+        slot = NextSlot();
+    }
+    return reinterpret_cast<T *>(slot);
+}
+
+/**
+ * Single objects are pushed on the free list, their slab is kept for reuse
+ * @param pointer memory returned by allocate(n)
+ * @param n the count passed to allocate
+ */
+template<typename T>
+void PoolAllocator<T>::deallocate(T *pointer, std::size_t n) {
+    if (n != 1) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    Slot *slot = reinterpret_cast<Slot *>(pointer);
+    slot->next_free_ = free_list_;
+    free_list_ = slot;
+}
+
+/**
+ * Marks every slot of every slab as unused in O(1). Objects still alive are not destroyed,
+ * so this is only safe once the owner has destroyed them or they are trivially destructible.
+ */
+template<typename T>
+void PoolAllocator<T>::recycle() noexcept {
+    current_slab_ = nullptr;
+    used_ = 0;
+    free_list_ = nullptr;
+}
+
+template<typename T>
+void PoolAllocator<T>::release() noexcept {
+    while (first_slab_ != nullptr) {
+        Slab *next = first_slab_->next_;
+        ::operator delete(first_slab_);
+        first_slab_ = next;
+    }
+    current_slab_ = nullptr;
+    used_ = 0;
+    free_list_ = nullptr;
+}
+
+/**
+ * Detects allocators that can take back all of their objects at once (see PoolAllocator::recycle())
+ */
+template<typename Allocator, typename = void>
+struct CanRecycle : std::false_type {
+};
+
+template<typename Allocator>
+struct CanRecycle<Allocator, decltype(std::declval<Allocator &>().recycle(), void())> : std::true_type {
+};
+
+} // namespace snakelinkedlist
+#endif //POOL_ALLOCATOR_H
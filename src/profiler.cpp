@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include "profiler.h"
+
+using namespace snakelinkedlist;
+
+namespace {
+
+enum SiteKind {
+	TIMER,
+	COUNTER
+};
+
+struct Site {
+	std::string name;
+	SiteKind kind;
+};
+
+/*
+Everything one thread has recorded. Only the owning thread writes to it, readers load written[] with acquire
+ordering and then read the samples before it, so neither side ever locks
+*/
+struct ThreadBuffer {
+	std::atomic<uint32_t> samples[Profiler::kmax_sites][Profiler::kwindow]; // Ring of the latest durations per timer, in nanoseconds
+	std::atomic<uint64_t> written[Profiler::kmax_sites]; // Samples ever written per timer, the ring position is this mod kwindow
+	std::atomic<uint64_t> totals[Profiler::kmax_sites]; // Running total per counter
+	std::atomic<bool> in_use; // Owned by a live thread, buffers of finished threads are handed to new ones
+};
+
+std::mutex registry_mutex; // Guards sites and buffers, only taken when registering and when reading figures
+std::vector<Site> sites;
+std::vector<ThreadBuffer*> buffers; // Never freed, so figures survive the threads that recorded them
+
+ThreadBuffer* acquireBuffer() {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	for (ThreadBuffer* buffer : buffers) {
+		if (!buffer->in_use.load(std::memory_order_acquire)) {
+			buffer->in_use.store(true, std::memory_order_relaxed);
+			return buffer;
+		}
+	}
+	ThreadBuffer* buffer = new ThreadBuffer(); // Value initialized, so every count starts at zero
+	buffer->in_use.store(true, std::memory_order_relaxed);
+	buffers.push_back(buffer);
+	return buffer;
+}
+
+// Gives the thread's buffer back when the thread exits
+struct BufferHolder {
+	ThreadBuffer* buffer = nullptr;
+	~BufferHolder() {
+		if (buffer != nullptr) {
+			buffer->in_use.store(false, std::memory_order_release);
+		}
+	}
+};
+
+thread_local BufferHolder local_buffer;
+
+ThreadBuffer& localBuffer() {
+	if (local_buffer.buffer == nullptr) {
+		local_buffer.buffer = acquireBuffer();
+	}
+	return *local_buffer.buffer;
+}
+
+int registerSite(const char* name, SiteKind kind) {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	for (size_t i = 0; i < sites.size(); i++) {
+		if (sites[i].kind == kind && sites[i].name == name) {
+			return static_cast<int>(i);
+		}
+	}
+	if (sites.size() == static_cast<size_t>(Profiler::kmax_sites)) {
+		return -1;
+	}
+	sites.push_back(Site{name, kind});
+	return static_cast<int>(sites.size() - 1);
+}
+
+std::atomic<uint64_t> allocations(0);
+thread_local uint64_t thread_allocations = 0; // A plain integer, so it is usable from operator new at any point in a thread's life
+
+// Characters that would end or break a JSON string are escaped, names are plain ASCII identifiers in practice
+std::string jsonString(const std::string& text) {
+	std::string quoted = "\"";
+	for (char c : text) {
+		if (c == '"' || c == '\\') {
+			quoted += '\\';
+		}
+		quoted += c;
+	}
+	return quoted + "\"";
+}
+
+} // namespace
+
+#ifdef SNAKE_ENABLE_PROFILING
+// Counts every allocation in the process, the figure the allocation counter reports
+void* operator new(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	thread_allocations++;
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+	std::free(memory);
+}
+#endif
+
+bool Profiler::enabled() {
+#ifdef SNAKE_ENABLE_PROFILING
+	return true;
+#else
+	return false;
+#endif
+}
+
+int Profiler::timer(const char* name) {
+	return registerSite(name, TIMER);
+}
+
+int Profiler::counter(const char* name) {
+	return registerSite(name, COUNTER);
+}
+
+void Profiler::record(int timer, uint64_t nanoseconds) {
+	if (timer < 0) {
+		return;
+	}
+	ThreadBuffer& buffer = localBuffer();
+	uint64_t written = buffer.written[timer].load(std::memory_order_relaxed);
+	uint32_t sample = static_cast<uint32_t>(std::min<uint64_t>(nanoseconds, UINT32_MAX));
+	buffer.samples[timer][written & (kwindow - 1)].store(sample, std::memory_order_relaxed);
+	buffer.written[timer].store(written + 1, std::memory_order_release);
+}
+
+void Profiler::count(int counter, uint64_t amount) {
+	if (counter < 0) {
+		return;
+	}
+	std::atomic<uint64_t>& total = localBuffer().totals[counter];
+	total.store(total.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/*
+Merges the latest samples of every thread. A thread can overwrite the oldest sample of its ring while it is being
+read, which only ever swaps one recent sample for a newer one
+*/
+std::vector<ProfileTimerStats> Profiler::getTimers() {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	std::vector<ProfileTimerStats> timers;
+	std::vector<uint32_t> samples;
+	for (size_t site = 0; site < sites.size(); site++) {
+		if (sites[site].kind != TIMER) {
+			continue;
+		}
+		ProfileTimerStats stats = {sites[site].name, 0, 0, 0, 0};
+		samples.clear();
+		for (ThreadBuffer* buffer : buffers) {
+			uint64_t written = buffer->written[site].load(std::memory_order_acquire);
+			uint64_t kept = std::min<uint64_t>(written, kwindow);
+			for (uint64_t i = written - kept; i < written; i++) {
+				samples.push_back(buffer->samples[site][i & (kwindow - 1)].load(std::memory_order_relaxed));
+			}
+			stats.calls += written;
+		}
+		if (!samples.empty()) {
+			std::sort(samples.begin(), samples.end());
+			stats.p50_us = samples[(samples.size() - 1) / 2] / 1000.0;
+			stats.p99_us = samples[(samples.size() - 1) * 99 / 100] / 1000.0;
+			stats.max_us = samples.back() / 1000.0;
+		}
+		timers.push_back(stats);
+	}
+	return timers;
+}
+
+std::vector<ProfileCounterStats> Profiler::getCounters() {
+	std::lock_guard<std::mutex> lock(registry_mutex);
+	std::vector<ProfileCounterStats> counters;
+	for (size_t site = 0; site < sites.size(); site++) {
+		if (sites[site].kind != COUNTER) {
+			continue;
+		}
+		ProfileCounterStats stats = {sites[site].name, 0};
+		for (ThreadBuffer* buffer : buffers) {
+			stats.total += buffer->totals[site].load(std::memory_order_relaxed);
+		}
+		counters.push_back(stats);
+	}
+	return counters;
+}
+
+uint64_t Profiler::getAllocations() {
+	return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::getThreadAllocations() {
+	return thread_allocations;
+}
+
+std::string Profiler::toJson() {
+	char number[64];
+	std::string json = "{\n  \"timers\": [";
+	std::vector<ProfileTimerStats> timers = getTimers();
+	for (size_t i = 0; i < timers.size(); i++) {
+		std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(timers[i].calls));
+		json += (i > 0 ? ",\n    {" : "\n    {");
+		json += "\"name\": " + jsonString(timers[i].name) + ", \"calls\": " + number;
+		std::snprintf(number, sizeof(number), ", \"p50_us\": %.3f", timers[i].p50_us);
+		json += number;
+		std::snprintf(number, sizeof(number), ", \"p99_us\": %.3f", timers[i].p99_us);
+		json += number;
+		std::snprintf(number, sizeof(number), ", \"max_us\": %.3f}", timers[i].max_us);
+		json += number;
+	}
+	json += timers.empty() ? "],\n" : "\n  ],\n";
+
+	json += "  \"counters\": [";
+	std::vector<ProfileCounterStats> counters = getCounters();
+	for (size_t i = 0; i < counters.size(); i++) {
+		std::snprintf(number, sizeof(number), "%llu}", static_cast<unsigned long long>(counters[i].total));
+		json += (i > 0 ? ",\n    {" : "\n    {");
+		json += "\"name\": " + jsonString(counters[i].name) + ", \"total\": " + number;
+	}
+	json += counters.empty() ? "],\n" : "\n  ],\n";
+
+	std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(getAllocations()));
+	json += std::string("  \"allocations\": ") + number + "\n}\n";
+	return json;
+}
+
+bool Profiler::dumpJson(const std::string& path) {
+	std::ofstream file(path, std::ios::trunc);
+	file << toJson();
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+Instrumentation for finding where frame time goes. Wrap a block in SNAKE_PROFILE_SCOPE("group/name") to time it and
+use SNAKE_PROFILE_COUNT("name", amount) to count events. SNAKE_PROFILE_ALLOCATIONS("name") counts the allocations the
+calling thread makes until the end of the block, e.g. to check a loop that should never allocate. All three compile
+to nothing unless the build defines SNAKE_ENABLE_PROFILING, so they can stay in the hottest code.
+
+With profiling on, each thread writes its samples into its own buffers, a ring of the last kwindow durations per
+timer, so recording never takes a lock or shares a cache line with another thread. Profiler::getTimers() merges the
+rings of every thread into rolling p50/p99/max figures, and with profiling on every allocation made through
+operator new is counted as well.
+*/
+#ifdef SNAKE_ENABLE_PROFILING
+#define SNAKE_PROFILE_CONCAT_(a, b) a##b
+#define SNAKE_PROFILE_NAME_(a, b) SNAKE_PROFILE_CONCAT_(a, b)
+#define SNAKE_PROFILE_SCOPE(name) \
+	static const int SNAKE_PROFILE_NAME_(snake_profile_site_, __LINE__) = ::snakelinkedlist::Profiler::timer(name); \
+	::snakelinkedlist::ProfileScope SNAKE_PROFILE_NAME_(snake_profile_scope_, __LINE__)(SNAKE_PROFILE_NAME_(snake_profile_site_, __LINE__))
+#define SNAKE_PROFILE_COUNT(name, amount) \
+	do { \
+		static const int snake_profile_counter_ = ::snakelinkedlist::Profiler::counter(name); \
+		::snakelinkedlist::Profiler::count(snake_profile_counter_, static_cast<uint64_t>(amount)); \
+	} while (0)
+#define SNAKE_PROFILE_ALLOCATIONS(name) \
+	static const int SNAKE_PROFILE_NAME_(snake_profile_site_, __LINE__) = ::snakelinkedlist::Profiler::counter(name); \
+	::snakelinkedlist::AllocationScope SNAKE_PROFILE_NAME_(snake_profile_scope_, __LINE__)(SNAKE_PROFILE_NAME_(snake_profile_site_, __LINE__))
+#else
+#define SNAKE_PROFILE_SCOPE(name) do {} while (0)
+#define SNAKE_PROFILE_COUNT(name, amount) do {} while (0)
+#define SNAKE_PROFILE_ALLOCATIONS(name) do {} while (0)
+#endif
+
+namespace snakelinkedlist {
+
+// Rolling figures for one timer, over the last kwindow samples of every thread
+struct ProfileTimerStats {
+	std::string name;
+	uint64_t calls; // Times the scope ran since startup
+	double p50_us; // Median duration
+	double p99_us;
+	double max_us;
+};
+
+struct ProfileCounterStats {
+	std::string name;
+	uint64_t total; // Sum of every amount counted since startup
+};
+
+class Profiler {
+public:
+	static const int kmax_sites = 64; // Timers plus counters, sites past this are ignored
+	static const int kwindow = 512; // Samples kept per timer per thread, a power of two
+
+	static bool enabled(); // Whether this build was compiled with SNAKE_ENABLE_PROFILING
+	static int timer(const char* name); // Registers a timer (once per call site), returns its id, -1 if there is no room
+	static int counter(const char* name); // Registers a counter (once per call site), returns its id, -1 if there is no room
+	static void record(int timer, uint64_t nanoseconds); // Adds a sample to the calling thread's ring for the timer
+	static void count(int counter, uint64_t amount); // Adds to the calling thread's total for the counter
+
+	static std::vector<ProfileTimerStats> getTimers(); // Current figures for every timer, safe to call while other threads record
+	static std::vector<ProfileCounterStats> getCounters(); // Current totals for every counter
+	static uint64_t getAllocations(); // Allocations made through operator new since startup, 0 when profiling is compiled out
+	static uint64_t getThreadAllocations(); // Allocations the calling thread has made since it started, 0 when profiling is compiled out
+	static std::string toJson(); // Timers, counters and allocations as a JSON object
+	static bool dumpJson(const std::string& path); // Writes toJson() to a file, false if it couldn't be written
+};
+
+// Times its own lifetime into a timer, see SNAKE_PROFILE_SCOPE
+class ProfileScope {
+private:
+	int timer_;
+	std::chrono::steady_clock::time_point start_;
+
+public:
+	explicit ProfileScope(int timer) : timer_(timer), start_(std::chrono::steady_clock::now()) {};
+	~ProfileScope() {
+		std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start_;
+		Profiler::record(timer_, static_cast<uint64_t>(elapsed.count()));
+	}
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
+// Counts the allocations the calling thread makes during its own lifetime into a counter, see SNAKE_PROFILE_ALLOCATIONS
+class AllocationScope {
+private:
+	int counter_;
+	uint64_t start_;
+
+public:
+	explicit AllocationScope(int counter) : counter_(counter), start_(Profiler::getThreadAllocations()) {};
+	~AllocationScope() {
+		Profiler::count(counter_, Profiler::getThreadAllocations() - start_);
+	}
+	AllocationScope(const AllocationScope&) = delete;
+	AllocationScope& operator=(const AllocationScope&) = delete;
+};
+} // namespace snakelinkedlist
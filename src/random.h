@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+namespace snakelinkedlist {
+
+/*
+Small seeded random number generator (PCG32, XSH RR variant) used for everything random in a game.
+The standard library distributions are allowed to differ between compilers, so a replay recorded on one machine
+could place food differently on another. Every draw here is fully specified, a seed gives the same game everywhere.
+The whole state is one 64 bit word, so thousands of games can each keep their own generator.
+*/
+class Random {
+private:
+	static const uint64_t kmultiplier_ = 6364136223846793005ULL;
+	static const uint64_t kincrement_ = 1442695040888963407ULL;
+	uint64_t state_; // Advanced by a linear congruential step on every draw
+
+public:
+	explicit Random(uint64_t seed = 0) { setSeed(seed); }
+
+	// Restarts the sequence, the same seed always gives the same sequence
+	void setSeed(uint64_t seed) {
+		state_ = 0;
+		next();
+		state_ += seed;
+		next();
+	}
+
+	// The whole state, restoring it with setState() continues the sequence from the same point
+	uint64_t getState() const { return state_; }
+	void setState(uint64_t state) { state_ = state; }
+
+	// Uniform 32 bit value
+	uint32_t next() {
+		uint64_t old_state = state_;
+		state_ = old_state * kmultiplier_ + kincrement_;
+		uint32_t xorshifted = static_cast<uint32_t>(((old_state >> 18u) ^ old_state) >> 27u);
+		uint32_t rotation = static_cast<uint32_t>(old_state >> 59u);
+		return (xorshifted >> rotation) | (xorshifted << ((32u - rotation) & 31u));
+	}
+
+	// Uniform integer in [0, bound), bound must be positive. Draws that would favour the low values are rejected
+	int below(int bound) {
+		uint32_t range = static_cast<uint32_t>(bound);
+		uint32_t threshold = (0u - range) % range;
+		while (true) {
+			uint32_t value = next();
+			if (value >= threshold) {
+				return static_cast<int>(value % range);
+			}
+		}
+	}
+};
+} // namespace snakelinkedlist
@@ -1,34 +1,71 @@
-#include <utility>
-
 //basic functions
 
 /**
  * default constructor
  */
-template<typename ElementType>
-LinkedList<ElementType>::LinkedList() : head_(nullptr) {
+template<typename ElementType, typename Allocator>
+LinkedList<ElementType, Allocator>::LinkedList() : head_(nullptr), tail_(nullptr), size_(0), node_allocator_() {
+
+}
+
+/**
+ * Allocate a node that is not linked into the list yet
+ * @param value data to store in the node
+ * @return the new node
+ */
+template<typename ElementType, typename Allocator>
+typename LinkedList<ElementType, Allocator>::Node *LinkedList<ElementType, Allocator>::NewNode(const ElementType &value) {
+    Node *node = NodeTraits::allocate(node_allocator_, 1);
+    NodeTraits::construct(node_allocator_, node);
+    node->next_ = nullptr;
+    node->prev_ = nullptr;
+    node->data_ = value;
+    return node;
+}
+
+/**
+ * Destroy a node that is no longer linked into the list and give its memory back to the allocator
+ * @param node the node to free
+ */
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::DeleteNode(Node *node) {
+    NodeTraits::destroy(node_allocator_, node);
+    NodeTraits::deallocate(node_allocator_, node, 1);
+}
 
+/**
+ * The elements need no destructor calls, so every node can be returned to the pool in one shot
+ */
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::FreeNodes(std::true_type) {
+    node_allocator_.recycle();
+    head_ = nullptr;
+}
+
+/**
+ * Walk the list destroying and freeing nodes one at a time
+ */
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::FreeNodes(std::false_type) {
+    Node *runner = head_;
+    while (head_ != nullptr) {
+        head_ = head_->next_;
+        DeleteNode(runner);
+        runner = head_;
+    }
 }
 
 /**
  * This constructor will create a linked list containing in order the elements from the value vector
  * @tparam ElementType the template type
+ * @tparam Allocator allocator the nodes come from
  * @param values vector contains data to be stored in LinkedList
  */
-template<typename ElementType>
-LinkedList<ElementType>::LinkedList(const std::vector<ElementType> &values) {
-    if (values.empty()) {
-        return;
-    }
-
-    head_ = new Node();
-    head_->data_ = values[0];
-    Node *runner = head_;
-    for (int i = 1; i < values.size(); i++) {
-        Node *current = new Node();
-        current->data_ = values[i];
-        runner->next_ = current;
-        runner = runner->next_;
+template<typename ElementType, typename Allocator>
+LinkedList<ElementType, Allocator>::LinkedList(const std::vector<ElementType> &values)
+        : head_(nullptr), tail_(nullptr), size_(0), node_allocator_() {
+    for (const ElementType &value : values) {
+        push_back(value);
     }
 }
 
@@ -37,23 +74,12 @@ LinkedList<ElementType>::LinkedList(const std::vector<ElementType> &values) {
  * This function will create a new linked list that is a deep copy of the source
  * @param source LinkedList to be copied
  */
-template<typename ElementType>
-LinkedList<ElementType>::LinkedList(const LinkedList<ElementType> &source) {
-    head_ = nullptr;
-    if (source.head_ == nullptr) {
-        return;
-    }
-
-    head_ = new Node();
-    head_->data_ = source.head_->data_;
-    Node *local_runner = head_;
-    Node *source_runner = source.head_;
-    while (source_runner->next_ != nullptr) {
-        Node *current = new Node();
-        current->data_ = source_runner->next_->data_;
-        local_runner->next_ = current;
-        local_runner = local_runner->next_;
-        source_runner = source_runner->next_;
+template<typename ElementType, typename Allocator>
+LinkedList<ElementType, Allocator>::LinkedList(const LinkedList<ElementType, Allocator> &source)
+        : head_(nullptr), tail_(nullptr), size_(0),
+          node_allocator_(NodeTraits::select_on_container_copy_construction(source.node_allocator_)) {
+    for (Node *source_runner = source.head_; source_runner != nullptr; source_runner = source_runner->next_) {
+        push_back(source_runner->data_);
     }
 }
 
@@ -63,18 +89,21 @@ LinkedList<ElementType>::LinkedList(const LinkedList<ElementType> &source) {
  * elements from the source
  * @param source LinkedList to be moved from
  */
-template<typename ElementType>
-LinkedList<ElementType>::LinkedList(LinkedList<ElementType> &&source) noexcept {
-    head_ = source.head_;
+template<typename ElementType, typename Allocator>
+LinkedList<ElementType, Allocator>::LinkedList(LinkedList<ElementType, Allocator> &&source) noexcept
+        : head_(source.head_), tail_(source.tail_), size_(source.size_),
+          node_allocator_(std::move(source.node_allocator_)) {
     source.head_ = nullptr;
+    source.tail_ = nullptr;
+    source.size_ = 0;
 }
 
 // Destructor
 /**
  * This destructor function will delete all the allocated data in the linked list class.
  */
-template<typename ElementType>
-LinkedList<ElementType>::~LinkedList() {
+template<typename ElementType, typename Allocator>
+LinkedList<ElementType, Allocator>::~LinkedList() {
     this->clear();
 }
 
@@ -85,17 +114,16 @@ LinkedList<ElementType>::~LinkedList() {
  * @param source Linked list to be copied from
  * @return pointer to a new Linked list
  */
-template<typename ElementType>
-LinkedList<ElementType> &LinkedList<ElementType>::operator=(const LinkedList<ElementType> &source) {
+template<typename ElementType, typename Allocator>
+LinkedList<ElementType, Allocator> &LinkedList<ElementType, Allocator>::operator=(const LinkedList<ElementType, Allocator> &source) {
     if (this == &source) {
         return *this;
     }
 
     this->clear();
-    LinkedList *temp_list = new LinkedList(source);
-    this->head_ = temp_list->head_;
-    temp_list->head_ = nullptr;
-    delete temp_list;
+    for (Node *source_runner = source.head_; source_runner != nullptr; source_runner = source_runner->next_) {
+        push_back(source_runner->data_);
+    }
 
     return *this;
 }
@@ -107,15 +135,20 @@ LinkedList<ElementType> &LinkedList<ElementType>::operator=(const LinkedList<Ele
  * @param source Linked list to be moved from
  * @return a pointer to the new Linked list
  */
-template<typename ElementType>
-LinkedList<ElementType> &LinkedList<ElementType>::operator=(LinkedList<ElementType> &&source) noexcept {
+template<typename ElementType, typename Allocator>
+LinkedList<ElementType, Allocator> &LinkedList<ElementType, Allocator>::operator=(LinkedList<ElementType, Allocator> &&source) noexcept {
     if (this == &source) {
         return *this;
     }
 
     this->clear();
     this->head_ = source.head_;
+    this->tail_ = source.tail_;
+    this->size_ = source.size_;
+    this->node_allocator_ = std::move(source.node_allocator_);
     source.head_ = nullptr;
+    source.tail_ = nullptr;
+    source.size_ = 0;
     return *this;
 }
 
@@ -125,33 +158,34 @@ LinkedList<ElementType> &LinkedList<ElementType>::operator=(LinkedList<ElementTy
  *This function will add a new element to the linked list at the front of the list
  * @param value data to be added
  */
-template<typename ElementType>
-void LinkedList<ElementType>::push_front(ElementType value) {
-    Node *old_ptr = head_;
-    head_ = new Node;
-    head_->data_ = value;
-    head_->next_ = old_ptr;
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::push_front(ElementType value) {
+    Node *node = NewNode(value);
+    node->next_ = head_;
+    if (head_ == nullptr) {
+        tail_ = node;
+    } else {
+        head_->prev_ = node;
+    }
+    head_ = node;
+    size_++;
 }
 
 /**
  *  This function will add a new element to the linked list at the back of the list
  * @param value data to be added
  */
-template<typename ElementType>
-void LinkedList<ElementType>::push_back(ElementType value) {
-    if (head_ == nullptr) {
-        head_ = new Node();
-        head_->data_ = value;
-        return;
-    }
-
-    Node *runner = head_;
-    while (runner->next_ != nullptr) {
-        runner = runner->next_;
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::push_back(ElementType value) {
+    Node *node = NewNode(value);
+    node->prev_ = tail_;
+    if (tail_ == nullptr) {
+        head_ = node;
+    } else {
+        tail_->next_ = node;
     }
-    runner->next_ = new Node();
-    runner = runner->next_;
-    runner->data_ = value;
+    tail_ = node;
+    size_++;
 }
 
 /**
@@ -159,8 +193,8 @@ void LinkedList<ElementType>::push_back(ElementType value) {
  * any items from the list.
  * @return a copy of the data in the head, or the default ElementType if the list is empty
  */
-template<typename ElementType>
-ElementType LinkedList<ElementType>::front() const {
+template<typename ElementType, typename Allocator>
+ElementType LinkedList<ElementType, Allocator>::front() const {
     if (head_ == nullptr) {
         return ElementType();
     }
@@ -172,100 +206,78 @@ ElementType LinkedList<ElementType>::front() const {
  * This does not remove any items from the list.
  * @return a copy of the data in the last node, or the default ElementType if the list is empty
  */
-template<typename ElementType>
-ElementType LinkedList<ElementType>::back() const {
-    if (head_ == nullptr) {
+template<typename ElementType, typename Allocator>
+ElementType LinkedList<ElementType, Allocator>::back() const {
+    if (tail_ == nullptr) {
         return ElementType();
     }
 
-    Node *runner = head_;
-    while (runner->next_ != nullptr) {
-        runner = runner->next_;
-    }
-
-    return runner->data_;
+    return tail_->data_;
 }
 
 /**
  * This will remove the front element from the linked list and delete the allocated data.
  * If the list is empty it will do nothing
  */
-template<typename ElementType>
-void LinkedList<ElementType>::pop_front() {
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::pop_front() {
     if (head_ == nullptr) {
         return;
     }
 
     Node *old_head = head_;
     head_ = head_->next_;
-    delete old_head;
+    if (head_ == nullptr) {
+        tail_ = nullptr;
+    } else {
+        head_->prev_ = nullptr;
+    }
+    DeleteNode(old_head);
+    size_--;
 }
 
 /**
  * This will remove the back element from the linked list and delete the allocated data.
  * If the list is empty it will do nothing
  */
-template<typename ElementType>
-void LinkedList<ElementType>::pop_back() {
-    if (head_ == nullptr) {
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::pop_back() {
+    if (tail_ == nullptr) {
         return;
     }
 
-    if (this->size() == 1) {
-        this->clear();
-        return;
+    Node *old_tail = tail_;
+    tail_ = tail_->prev_;
+    if (tail_ == nullptr) {
+        head_ = nullptr;
+    } else {
+        tail_->next_ = nullptr;
     }
-
-    Node *runner = head_;
-    Node *previous = runner;
-    while (runner->next_ != nullptr) {
-        previous = runner;
-        runner = runner->next_;
-    }
-
-    delete runner;
-    previous->next_ = nullptr;
+    DeleteNode(old_tail);
+    size_--;
 }
 
 /**
  * Return the number of elements in the list
  * @return the number of elements in the list
  */
-template<typename ElementType>
-int LinkedList<ElementType>::size() const {
-    if (head_ == nullptr) {
-        return 0;
-    }
-
-    int sum = 1;
-    Node *runner = head_;
-    while (runner->next_ != nullptr) {
-        sum++;
-        runner = runner->next_;
-    }
-    return sum;
+template<typename ElementType, typename Allocator>
+int LinkedList<ElementType, Allocator>::size() const {
+    return size_;
 }
 
 /**
  * Return a vector that contains all the elements in the list
  * @return vector contains all the data in the list in order
  */
-template<typename ElementType>
-std::vector<ElementType> LinkedList<ElementType>::GetVector() const {
-    if (head_ == nullptr) {
-        return std::vector<ElementType>();
-    }
-
+template<typename ElementType, typename Allocator>
+std::vector<ElementType> LinkedList<ElementType, Allocator>::GetVector() const {
     std::vector<ElementType> element_type_seg_list;
-    Node *runner = head_;
-
-    while (runner->next_ != nullptr) {
+    element_type_seg_list.reserve(size_);
+    for (Node *runner = head_; runner != nullptr; runner = runner->next_) {
         element_type_seg_list.push_back(runner->data_);
-        runner = runner->next_;
     }
 
-    element_type_seg_list.push_back(back());
-
     return element_type_seg_list;
 }
 
@@ -273,8 +285,8 @@ std::vector<ElementType> LinkedList<ElementType>::GetVector() const {
  * This function determines whether the list is empty
  * @return true true if the list is empty otherwise returns false
  */
-template<typename ElementType>
-bool LinkedList<ElementType>::empty() const {
+template<typename ElementType, typename Allocator>
+bool LinkedList<ElementType, Allocator>::empty() const {
     if (head_ == nullptr) {
         return true;
     }
@@ -284,18 +296,15 @@ bool LinkedList<ElementType>::empty() const {
 /**
  * Delete all data in the linked list returning the list to the same state as the default constructor
  */
-template<typename ElementType>
-void LinkedList<ElementType>::clear() {
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::clear() {
     if (head_ == nullptr) {
         return;
     }
 
-    Node *runner = head_;
-    while (head_ != nullptr) {
-        head_ = head_->next_;
-        delete runner;
-        runner = head_;
-    }
+    FreeNodes(RecycleNodes());
+    tail_ = nullptr;
+    size_ = 0;
 }
 
 /**
@@ -305,8 +314,8 @@ void LinkedList<ElementType>::clear() {
  * @param list the list to print
  * @return the output stream
  */
-template<typename ElementType>
-std::ostream &operator<<(std::ostream &os, const LinkedList<ElementType> &list) {
+template<typename ElementType, typename Allocator>
+std::ostream &operator<<(std::ostream &os, const LinkedList<ElementType, Allocator> &list) {
     if (list.empty()) {
         os << "" << std::endl;
         return os;
@@ -327,41 +336,58 @@ std::ostream &operator<<(std::ostream &os, const LinkedList<ElementType> &list)
  * RemoveNth(1) will remove the second element in the list
  * @param n index of the element to be removed
  */
-template<typename ElementType>
-void LinkedList<ElementType>::RemoveNth(int n) {
-    if (n == 0) {
-        pop_front();
+template<typename ElementType, typename Allocator>
+void LinkedList<ElementType, Allocator>::RemoveNth(int n) {
+    if (n < 0 || n > size_ - 1) {
         return;
     }
 
-    if (n == size() - 1) {
-        pop_back();
+    if (n == 0) {
+        pop_front();
         return;
     }
 
-    if (n > size() - 1) {
+    if (n == size_ - 1) {
+        pop_back();
         return;
     }
 
-    Node *runner = head_;
-    for (int i = 0; i < n - 1; i++) {
-        runner = runner->next_;
+    // Walk in from whichever end is closer
+    Node *node_to_remove;
+    if (n < size_ / 2) {
+        node_to_remove = head_;
+        for (int i = 0; i < n; i++) {
+            node_to_remove = node_to_remove->next_;
+        }
+    } else {
+        node_to_remove = tail_;
+        for (int i = size_ - 1; i > n; i--) {
+            node_to_remove = node_to_remove->prev_;
+        }
     }
 
-    Node *node_to_remove = runner->next_;
-    Node *next_node = node_to_remove->next_;
-    delete node_to_remove;
-    runner->next_ = next_node;
+    node_to_remove->prev_->next_ = node_to_remove->next_;
+    node_to_remove->next_->prev_ = node_to_remove->prev_;
+    DeleteNode(node_to_remove);
+    size_--;
 }
 
 /**
- * This function will compare the list element by element
+ * This function will compare the list element by element, walking both lists at once so neither is copied
  * @param rhs the right hand side of the operator
  * @return true if they are all equal otherwise it will return false
  */
-template<typename ElementType>
-bool LinkedList<ElementType>::operator==(const LinkedList<ElementType> &rhs) const {
-    return (this->GetVector() == rhs.GetVector());
+template<typename ElementType, typename Allocator>
+bool LinkedList<ElementType, Allocator>::operator==(const LinkedList<ElementType, Allocator> &rhs) const {
+    if (size_ != rhs.size_) {
+        return false;
+    }
+    for (Node *left = head_, *right = rhs.head_; left != nullptr; left = left->next_, right = right->next_) {
+        if (!(left->data_ == right->data_)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 /**
@@ -370,8 +396,8 @@ bool LinkedList<ElementType>::operator==(const LinkedList<ElementType> &rhs) con
  * @param rhs right hand side of the operator
  * @return false if they are all equal otherwise it will return true
  */
-template<typename ElementType>
-bool operator!=(const LinkedList<ElementType> &lhs, const LinkedList<ElementType> &rhs) {
+template<typename ElementType, typename Allocator>
+bool operator!=(const LinkedList<ElementType, Allocator> &lhs, const LinkedList<ElementType, Allocator> &rhs) {
     return !(lhs == rhs);
 }
 
@@ -380,8 +406,8 @@ bool operator!=(const LinkedList<ElementType> &lhs, const LinkedList<ElementType
  * @tparam ElementType template type
  * @return next iterator
  */
-template<typename ElementType>
-typename LinkedList<ElementType>::Iterator &LinkedList<ElementType>::Iterator::operator++() {
+template<typename ElementType, typename Allocator>
+typename LinkedList<ElementType, Allocator>::Iterator &LinkedList<ElementType, Allocator>::Iterator::operator++() {
     if (current_) {
         current_ = current_->next_;
     }
@@ -393,8 +419,8 @@ typename LinkedList<ElementType>::Iterator &LinkedList<ElementType>::Iterator::o
  * @tparam ElementType template type
  * @return the data that node pointed by the iterator stored
  */
-template<typename ElementType>
-ElementType &LinkedList<ElementType>::Iterator::operator*() {
+template<typename ElementType, typename Allocator>
+ElementType &LinkedList<ElementType, Allocator>::Iterator::operator*() {
     return current_->data_;
 }
 
@@ -404,8 +430,8 @@ ElementType &LinkedList<ElementType>::Iterator::operator*() {
  * @param other the iterator to compare with
  * @return true if not equal, false otherwise
  */
-template<typename ElementType>
-bool LinkedList<ElementType>::Iterator::operator!=(const LinkedList<ElementType>::Iterator &other) {
+template<typename ElementType, typename Allocator>
+bool LinkedList<ElementType, Allocator>::Iterator::operator!=(const LinkedList<ElementType, Allocator>::Iterator &other) {
     return (current_ != other.current_);
 }
 
@@ -414,8 +440,8 @@ bool LinkedList<ElementType>::Iterator::operator!=(const LinkedList<ElementType>
  * @tparam ElementType template type
  * @return the begin iterator
  */
-template<typename ElementType>
-typename LinkedList<ElementType>::Iterator LinkedList<ElementType>::begin() const {
+template<typename ElementType, typename Allocator>
+typename LinkedList<ElementType, Allocator>::Iterator LinkedList<ElementType, Allocator>::begin() const {
     Iterator start;
     start.current_ = head_;
     return start;
@@ -426,8 +452,8 @@ typename LinkedList<ElementType>::Iterator LinkedList<ElementType>::begin() cons
  * @tparam ElementType template type
  * @return the end iterator
  */
-template<typename ElementType>
-typename LinkedList<ElementType>::Iterator LinkedList<ElementType>::end() const {
+template<typename ElementType, typename Allocator>
+typename LinkedList<ElementType, Allocator>::Iterator LinkedList<ElementType, Allocator>::end() const {
     Iterator stop;
     stop.current_ = nullptr;
     return stop;
@@ -2,23 +2,45 @@
 #define LL_H
 
 #include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "pool_allocator.h"
 
 namespace snakelinkedlist {
 
 // Template linked list class
-template<typename ElementType>
+// Nodes come from Allocator (rebound to the node type), e.g. LinkedList<int, PoolAllocator<int>> recycles nodes
+// from slabs instead of calling new/delete for every push and pop
+template<typename ElementType, typename Allocator = std::allocator<ElementType>>
 class LinkedList {
 
     /**
-     * internal nodes
+     * internal nodes, linked both ways so the back of the list can be removed without a walk
      */
     struct Node {
         Node *next_;
+        Node *prev_;
         ElementType data_;
     };
 
-    Node *head_;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeTraits;
+
+    // Whether clear() can hand every node back to the allocator at once instead of one by one
+    typedef std::integral_constant<bool, CanRecycle<NodeAllocator>::value
+            && std::is_trivially_destructible<ElementType>::value> RecycleNodes;
+
+    Node *head_;    // first node, nullptr when empty
+    Node *tail_;    // last node, nullptr when empty
+    int size_;      // number of nodes, kept up to date by every modifier so size() never walks the list
+    NodeAllocator node_allocator_;  // where nodes are allocated from
+
+    Node *NewNode(const ElementType &value);    // allocate a detached node holding value
+    void DeleteNode(Node *node);                // destroy and free a node that has been unlinked
+    void FreeNodes(std::true_type);             // free every node in one shot through the allocator
+    void FreeNodes(std::false_type);            // free every node one at a time
 
 public:
     LinkedList();                                                   // Default constructor
@@ -28,13 +50,13 @@ public:
     LinkedList(const LinkedList& source);                                           // Copy constructor
     LinkedList(LinkedList&& source) noexcept;                                       // Move constructor
     ~LinkedList();                                                                  // Destructor
-    LinkedList<ElementType>& operator=(const LinkedList<ElementType>& source);      // Copy assignment operator
-    LinkedList<ElementType>& operator=(LinkedList<ElementType>&& source) noexcept;  // Move assignment operator
+    LinkedList& operator=(const LinkedList& source);                            // Copy assignment operator
+    LinkedList& operator=(LinkedList&& source) noexcept;                       // Move assignment operator
 
     void push_front(ElementType value);         // Push value on front
     void push_back(ElementType value);          // Push value on back
     ElementType front() const;                  // Access the front value
-    ElementType back() const;                   // Access the back valueW
+    ElementType back() const;                   // Access the back value
     void pop_front();                           // remove front element
     void pop_back();                            // remove back element
     int size() const;                           // return number of elements
@@ -42,12 +64,12 @@ public:
     bool empty() const;                         // check if empty
     void clear();                               // clear the contents
     void RemoveNth(int n);                      // remove the Nth element from the front 0 indexed
-    bool operator==(const LinkedList<ElementType> &rhs) const;
+    bool operator==(const LinkedList &rhs) const;
 
     // Iterator
     class Iterator : std::iterator<std::forward_iterator_tag, ElementType> {
         Node *current_;
-        friend LinkedList<ElementType>;
+        friend LinkedList;
     public:
         Iterator() : current_(nullptr) {};
         Iterator& operator++();
@@ -59,8 +81,8 @@ public:
     Iterator end() const;
 };
 
-template<typename ElementType>
-std::ostream& operator<<(std::ostream& os, const LinkedList<ElementType>& list);
+template<typename ElementType, typename Allocator>
+std::ostream& operator<<(std::ostream& os, const LinkedList<ElementType, Allocator>& list);
 
 // needed for template instantiation
 #include "ref_ll.cpp"
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include "replay.h"
+
+using namespace snakelinkedlist;
+
+static const char kmagic[4] = {'S', 'N', 'K', 'R'};
+
+// The direction a quarter turn clockwise from direction
+static SnakeDirection clockwiseFrom(SnakeDirection direction) {
+	switch (direction) {
+		case UP:
+			return RIGHT;
+		case RIGHT:
+			return DOWN;
+		case DOWN:
+			return LEFT;
+		case LEFT:
+			return UP;
+	}
+	return direction;
+}
+
+// The direction a quarter turn counter clockwise from direction
+static SnakeDirection counterClockwiseFrom(SnakeDirection direction) {
+	return clockwiseFrom(clockwiseFrom(clockwiseFrom(direction)));
+}
+
+ReplayEventReader::ReplayEventReader(const uint8_t* data, size_t size, size_t position, long long tick, SnakeDirection last_turn)
+	: data_(data), size_(size), position_(position), tick_(tick), last_turn_(last_turn) {
+}
+
+bool ReplayEventReader::readVarint(const uint8_t* data, size_t size, size_t& position, uint64_t& value) {
+	value = 0;
+	for (int shift = 0; shift < 64 && position < size; shift += 7) {
+		uint8_t byte = data[position++];
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ReplayEventReader::readVarint(uint64_t& value) {
+	return readVarint(data_, size_, position_, value);
+}
+
+bool ReplayEventReader::next(ReplayEvent& event) {
+	uint64_t record;
+	if (!readVarint(record)) {
+		return false;
+	}
+
+	event.tick = tick_ + static_cast<long long>(record >> 2);
+	event.kind = static_cast<ReplayEventKind>(record & 3);
+	if (event.kind == TURN_CLOCKWISE || event.kind == TURN_COUNTER_CLOCKWISE) {
+		event.direction = (event.kind == TURN_CLOCKWISE) ? clockwiseFrom(last_turn_) : counterClockwiseFrom(last_turn_);
+		last_turn_ = event.direction;
+	} else if (event.kind == RESIZE) {
+		uint64_t board_width, board_height;
+		if (!readVarint(board_width) || !readVarint(board_height)) {
+			return false;
+		}
+		event.board_width = static_cast<int>(board_width);
+		event.board_height = static_cast<int>(board_height);
+	}
+	tick_ = event.tick;
+	return true;
+}
+
+size_t ReplayEventReader::getPosition() const {
+	return position_;
+}
+
+long long ReplayEventReader::getTick() const {
+	return tick_;
+}
+
+SnakeDirection ReplayEventReader::getLastTurn() const {
+	return last_turn_;
+}
+
+void ReplayEventReader::apply(Simulation& game, const ReplayEvent& event) {
+	if (event.kind == TURN_CLOCKWISE || event.kind == TURN_COUNTER_CLOCKWISE) {
+		game.queueTurn(event.direction);
+	} else if (event.kind == RESIZE) {
+		game.resize(event.board_width, event.board_height);
+	}
+}
+
+void ReplayRecorder::writeVarint(uint64_t value) {
+	while (value >= 0x80) {
+		bytes_.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	bytes_.push_back(static_cast<uint8_t>(value));
+}
+
+void ReplayRecorder::writeEvent(long long tick, int kind) {
+	writeVarint((static_cast<uint64_t>(tick - last_tick_) << 2) | static_cast<uint64_t>(kind));
+	last_tick_ = tick;
+}
+
+void ReplayRecorder::start(uint32_t seed, int board_width, int board_height) {
+	bytes_.assign(kmagic, kmagic + sizeof(kmagic));
+	writeVarint(kversion);
+	writeVarint(seed);
+	writeVarint(static_cast<uint64_t>(board_width));
+	writeVarint(static_cast<uint64_t>(board_height));
+	last_tick_ = 0;
+	last_turn_ = RIGHT;
+}
+
+/*
+Only turns the simulation accepted are recorded, and those are always onto the other axis,
+so the turn is stored as clockwise or counter clockwise from the last one
+*/
+void ReplayRecorder::recordTurn(long long tick, SnakeDirection direction) {
+	writeEvent(tick, direction == clockwiseFrom(last_turn_) ? TURN_CLOCKWISE : TURN_COUNTER_CLOCKWISE);
+	last_turn_ = direction;
+}
+
+void ReplayRecorder::recordResize(long long tick, int board_width, int board_height) {
+	writeEvent(tick, RESIZE);
+	writeVarint(static_cast<uint64_t>(board_width));
+	writeVarint(static_cast<uint64_t>(board_height));
+}
+
+void ReplayRecorder::finish(long long tick) {
+	writeEvent(tick, END);
+}
+
+const std::vector<uint8_t>& ReplayRecorder::getBytes() const {
+	return bytes_;
+}
+
+bool ReplayRecorder::save(const std::string& path) const {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(bytes_.data()), bytes_.size());
+	return static_cast<bool>(file);
+}
+
+ReplayPlayer::ReplayPlayer(std::vector<uint8_t> bytes) : bytes_(std::move(bytes)) {
+	if (bytes_.size() < sizeof(kmagic) || !std::equal(kmagic, kmagic + sizeof(kmagic), bytes_.begin())) {
+		return;
+	}
+
+	size_t position = sizeof(kmagic);
+	const uint8_t* data = bytes_.data();
+	uint64_t version, seed, board_width, board_height;
+	if (!ReplayEventReader::readVarint(data, bytes_.size(), position, version) || version != ReplayRecorder::kversion
+		|| !ReplayEventReader::readVarint(data, bytes_.size(), position, seed)
+		|| !ReplayEventReader::readVarint(data, bytes_.size(), position, board_width)
+		|| !ReplayEventReader::readVarint(data, bytes_.size(), position, board_height)) {
+		return;
+	}
+
+	seed_ = static_cast<uint32_t>(seed);
+	board_width_ = static_cast<int>(board_width);
+	board_height_ = static_cast<int>(board_height);
+	events_begin_ = position;
+	valid_ = true;
+}
+
+bool ReplayPlayer::load(const std::string& path, std::vector<uint8_t>& bytes) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+/*
+Each event is applied once the game has run as many ticks as it had when the event was recorded.
+Pausing stops the tick count, so pauses in the recording need no records of their own and the replay never pauses
+*/
+Simulation ReplayPlayer::play() const {
+	Simulation game(board_width_, board_height_, seed_);
+	if (!valid_) {
+		return game;
+	}
+
+	ReplayEventReader events(bytes_.data(), bytes_.size(), events_begin_);
+	ReplayEvent event;
+	while (events.next(event) && event.kind != END) {
+		while (game.getTickCount() < event.tick && game.getState() == IN_PROGRESS) {
+			game.tick();
+		}
+		ReplayEventReader::apply(game, event);
+	}
+	if (event.kind == END) {
+		while (game.getTickCount() < event.tick && game.getState() == IN_PROGRESS) {
+			game.tick();
+		}
+	}
+	return game;
+}
+
+bool ReplayPlayer::isValid() const {
+	return valid_;
+}
+
+uint32_t ReplayPlayer::getSeed() const {
+	return seed_;
+}
+
+int ReplayPlayer::getBoardWidth() const {
+	return board_width_;
+}
+
+int ReplayPlayer::getBoardHeight() const {
+	return board_height_;
+}
+
+const std::vector<uint8_t>& ReplayPlayer::getBytes() const {
+	return bytes_;
+}
+
+size_t ReplayPlayer::getEventsBegin() const {
+	return events_begin_;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "game_types.h"
+#include "simulation.h"
+
+namespace snakelinkedlist {
+
+/*
+Replays store only what a game can't work out for itself: the seed and board it started on, and the input the player
+gave it, each stamped with Simulation::getTickCount() at the time. Everything else is recomputed, so a replay of a
+whole game is a few bytes per turn and plays back exactly as it was played.
+
+Format, every number is an unsigned LEB128 varint (7 bits per byte, high bit set on all but the last byte):
+	magic bytes "SNKR", format version, seed, board width, board height
+	then one record per event: (ticks since the previous event << 2) | kind
+		kind 0: turn clockwise from the previous turn (the first turn is measured from RIGHT, the starting direction)
+		kind 1: turn counter clockwise from the previous turn
+		kind 2: window resized, followed by the new width and height. Since version 2 the board keeps its size in
+		        squares for the whole game, so this only changes how the board is drawn
+		kind 3: end of the recording
+Accepted turns always switch axis, so each one is one of two directions and the record of a turn made within 31 ticks
+of the previous event is a single byte.
+*/
+enum ReplayEventKind {
+	TURN_CLOCKWISE = 0,
+	TURN_COUNTER_CLOCKWISE,
+	RESIZE,
+	END
+};
+
+// One decoded event record
+struct ReplayEvent {
+	long long tick = 0; // Simulation::getTickCount() when the event happened
+	ReplayEventKind kind = END;
+	SnakeDirection direction = RIGHT; // The direction turned to, for turns
+	int board_width = 0; // The new window size, for resizes
+	int board_height = 0;
+};
+
+/*
+Decodes event records one at a time. Records are stored relative to the previous one, so a reader started in the
+middle of a recording needs the tick and turn direction of the event before it (see ReplayArchive keyframes)
+*/
+class ReplayEventReader {
+private:
+	const uint8_t* data_; // The recording
+	size_t size_;
+	size_t position_; // Offset of the next record
+	long long tick_; // Tick of the previous event
+	SnakeDirection last_turn_; // Direction of the previous turn
+
+	bool readVarint(uint64_t& value); // Reads a varint and moves past it, false if the data ends first
+
+public:
+	ReplayEventReader(const uint8_t* data, size_t size, size_t position, long long tick = 0, SnakeDirection last_turn = RIGHT);
+	bool next(ReplayEvent& event); // Decodes the next event, false at the end of the data or at a damaged record
+	size_t getPosition() const; // Gets the offset of the next record
+	long long getTick() const; // Gets the tick of the last decoded event
+	SnakeDirection getLastTurn() const; // Gets the direction of the last decoded turn
+
+	static bool readVarint(const uint8_t* data, size_t size, size_t& position, uint64_t& value); // Reads a varint at position and moves past it
+	static void apply(Simulation& game, const ReplayEvent& event); // Feeds an event to a game that has reached the event's tick
+};
+
+class ReplayRecorder {
+private:
+	std::vector<uint8_t> bytes_; // The recording so far
+	long long last_tick_ = 0; // Tick of the last recorded event, records store the difference
+	SnakeDirection last_turn_ = RIGHT; // Direction of the last recorded turn, turns are stored relative to it
+
+	void writeVarint(uint64_t value); // Appends a varint
+	void writeEvent(long long tick, int kind); // Appends the record header of an event
+
+public:
+	static const uint32_t kversion = 2; // Format version written by this recorder
+
+	void start(uint32_t seed, int board_width, int board_height); // Drops any previous recording and starts a new game
+	void recordTurn(long long tick, SnakeDirection direction); // A turn Simulation::queueTurn() accepted when tick ticks had run
+	void recordResize(long long tick, int board_width, int board_height); // The window was resized when tick ticks had run
+	void finish(long long tick); // Marks the end of the recording after tick ticks
+	const std::vector<uint8_t>& getBytes() const; // The encoded recording
+	bool save(const std::string& path) const; // Writes the recording to a file, returns false if it couldn't be written
+};
+
+/*
+Plays a recording back by starting a Simulation from the recorded seed and feeding it the recorded input on the
+recorded ticks. Nothing waits on a clock, so a game is re-simulated as fast as Simulation::tick() runs.
+*/
+class ReplayPlayer {
+private:
+	std::vector<uint8_t> bytes_; // The encoded recording
+	bool valid_ = false; // Whether the header could be read
+	uint32_t seed_ = 0; // Seed of the recorded game
+	int board_width_ = 0; // Board size the recorded game started on
+	int board_height_ = 0;
+	size_t events_begin_ = 0; // Offset of the first event record
+
+public:
+	explicit ReplayPlayer(std::vector<uint8_t> bytes); // Reads the header of a recording
+	static bool load(const std::string& path, std::vector<uint8_t>& bytes); // Reads a recording from a file, false if it couldn't be read
+
+	bool isValid() const; // Whether the data starts with a header this player understands
+	uint32_t getSeed() const; // Gets the seed of the recorded game
+	int getBoardWidth() const; // Gets the board width the recorded game started with
+	int getBoardHeight() const; // Gets the board height the recorded game started with
+	const std::vector<uint8_t>& getBytes() const; // Gets the whole recording
+	size_t getEventsBegin() const; // Gets the offset of the first event record
+
+	// Re-simulates the recorded game up to the end of the recording, or up to the first damaged record
+	Simulation play() const;
+};
+} // namespace snakelinkedlist
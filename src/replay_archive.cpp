@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include "binary_io.h"
+#include "replay_archive.h"
+
+using namespace snakelinkedlist;
+
+static const char kmagic[4] = {'S', 'N', 'K', 'A'};
+static const size_t kheader_size = sizeof(kmagic) + sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+// Fixed size part of a game, before its keyframe entries
+struct GameHeader {
+	uint32_t seed;
+	int32_t board_width;
+	int32_t board_height;
+	uint32_t keyframe_interval;
+	int64_t ticks;
+	int32_t food_eaten;
+	int32_t final_state;
+	uint32_t keyframe_count;
+	uint32_t recording_size;
+};
+static const size_t kgame_header_size = 4 + 4 + 4 + 4 + 8 + 4 + 4 + 4 + 4;
+
+// Where to restart a game from, and where its recording continues from
+struct Keyframe {
+	int64_t tick;
+	uint64_t state_offset;
+	uint32_t state_size;
+	uint32_t events_position;
+	int64_t events_tick;
+	int32_t last_turn;
+};
+static const size_t kkeyframe_size = 8 + 8 + 4 + 4 + 8 + 4;
+
+static void writeGameHeader(BinaryWriter& out, const GameHeader& header) {
+	out.write(header.seed);
+	out.write(header.board_width);
+	out.write(header.board_height);
+	out.write(header.keyframe_interval);
+	out.write(header.ticks);
+	out.write(header.food_eaten);
+	out.write(header.final_state);
+	out.write(header.keyframe_count);
+	out.write(header.recording_size);
+}
+
+static bool readGameHeader(BinaryReader& in, GameHeader& header) {
+	in.read(header.seed);
+	in.read(header.board_width);
+	in.read(header.board_height);
+	in.read(header.keyframe_interval);
+	in.read(header.ticks);
+	in.read(header.food_eaten);
+	in.read(header.final_state);
+	in.read(header.keyframe_count);
+	in.read(header.recording_size);
+	return in.ok() && header.keyframe_interval > 0 && header.keyframe_count > 0 && header.ticks >= 0
+		&& header.keyframe_count - 1 == static_cast<uint64_t>(header.ticks) / header.keyframe_interval;
+}
+
+static void writeKeyframe(BinaryWriter& out, const Keyframe& keyframe) {
+	out.write(keyframe.tick);
+	out.write(keyframe.state_offset);
+	out.write(keyframe.state_size);
+	out.write(keyframe.events_position);
+	out.write(keyframe.events_tick);
+	out.write(keyframe.last_turn);
+}
+
+static bool readKeyframe(BinaryReader& in, Keyframe& keyframe) {
+	in.read(keyframe.tick);
+	in.read(keyframe.state_offset);
+	in.read(keyframe.state_size);
+	in.read(keyframe.events_position);
+	in.read(keyframe.events_tick);
+	in.read(keyframe.last_turn);
+	return in.ok() && keyframe.last_turn >= UP && keyframe.last_turn <= LEFT;
+}
+
+ReplayArchiveWriter::~ReplayArchiveWriter() {
+	if (file_.is_open()) {
+		finish();
+	}
+}
+
+bool ReplayArchiveWriter::open(const std::string& path, int keyframe_interval) {
+	if (file_.is_open()) {
+		file_.close();
+	}
+	file_.clear();
+	file_.open(path, std::ios::binary | std::ios::trunc);
+	keyframe_interval_ = std::max(keyframe_interval, 1);
+	game_offsets_.clear();
+
+	// The game count and index offset are filled in by finish()
+	std::vector<uint8_t> header;
+	BinaryWriter out(header);
+	out.writeBytes(kmagic, sizeof(kmagic));
+	out.write(static_cast<uint32_t>(kversion));
+	out.write(static_cast<uint64_t>(0));
+	out.write(static_cast<uint64_t>(0));
+	file_.write(reinterpret_cast<const char*>(header.data()), header.size());
+	file_size_ = header.size();
+	return static_cast<bool>(file_);
+}
+
+/*
+Plays the recording through once, saving the game's state whenever the tick count reaches a multiple of the keyframe
+interval. A keyframe is taken before the input of its tick is applied, and stores the position of the first event
+not yet applied, so seeking from it applies exactly the events the full replay would have applied after that tick
+*/
+bool ReplayArchiveWriter::addGame(const ReplayPlayer& recording) {
+	if (!file_.is_open() || !file_ || !recording.isValid()) {
+		return false;
+	}
+
+	const std::vector<uint8_t>& input = recording.getBytes();
+	Simulation game(recording.getBoardWidth(), recording.getBoardHeight(), recording.getSeed());
+	ReplayEventReader events(input.data(), input.size(), recording.getEventsBegin());
+	std::vector<Keyframe> keyframes;
+	std::vector<uint8_t> states;
+	BinaryWriter state_out(states);
+	long long next_keyframe = 0;
+
+	while (true) {
+		Keyframe resume;
+		resume.events_position = static_cast<uint32_t>(events.getPosition());
+		resume.events_tick = events.getTick();
+		resume.last_turn = events.getLastTurn();
+
+		ReplayEvent event;
+		bool has_event = events.next(event);
+		long long target = has_event ? event.tick : game.getTickCount();
+		while (true) {
+			if (game.getTickCount() == next_keyframe) {
+				Keyframe keyframe = resume;
+				keyframe.tick = next_keyframe;
+				keyframe.state_offset = states.size();
+				if (next_keyframe > 0) {
+					game.writeState(state_out);
+				}
+				keyframe.state_size = static_cast<uint32_t>(states.size() - keyframe.state_offset);
+				keyframes.push_back(keyframe);
+				next_keyframe += keyframe_interval_;
+			}
+			if (game.getTickCount() >= target || game.getState() != IN_PROGRESS) {
+				break;
+			}
+			game.tick();
+		}
+		if (!has_event || event.kind == END) {
+			break;
+		}
+		ReplayEventReader::apply(game, event);
+	}
+
+	GameHeader header;
+	header.seed = recording.getSeed();
+	header.board_width = recording.getBoardWidth();
+	header.board_height = recording.getBoardHeight();
+	header.keyframe_interval = static_cast<uint32_t>(keyframe_interval_);
+	header.ticks = game.getTickCount();
+	header.food_eaten = game.getSnake().getFoodEaten();
+	header.final_state = game.getState();
+	header.keyframe_count = static_cast<uint32_t>(keyframes.size());
+	header.recording_size = static_cast<uint32_t>(input.size());
+
+	// States are stored after the entries and the recording, entries point at them by absolute offset
+	uint64_t states_begin = file_size_ + kgame_header_size + keyframes.size() * kkeyframe_size + input.size();
+	std::vector<uint8_t> block;
+	block.reserve(states_begin - file_size_ + states.size());
+	BinaryWriter out(block);
+	writeGameHeader(out, header);
+	for (Keyframe keyframe : keyframes) {
+		keyframe.state_offset = (keyframe.state_size > 0) ? states_begin + keyframe.state_offset : 0;
+		writeKeyframe(out, keyframe);
+	}
+	out.writeBytes(input.data(), input.size());
+	out.writeBytes(states.data(), states.size());
+
+	file_.write(reinterpret_cast<const char*>(block.data()), block.size());
+	if (!file_) {
+		return false;
+	}
+	game_offsets_.push_back(file_size_);
+	file_size_ += block.size();
+	return true;
+}
+
+bool ReplayArchiveWriter::finish() {
+	if (!file_.is_open()) {
+		return false;
+	}
+
+	std::vector<uint8_t> index;
+	BinaryWriter out(index);
+	for (uint64_t offset : game_offsets_) {
+		out.write(offset);
+	}
+	file_.write(reinterpret_cast<const char*>(index.data()), index.size());
+
+	std::vector<uint8_t> counts;
+	BinaryWriter count_out(counts);
+	count_out.write(static_cast<uint64_t>(game_offsets_.size()));
+	count_out.write(file_size_);
+	file_.seekp(sizeof(kmagic) + sizeof(kversion));
+	file_.write(reinterpret_cast<const char*>(counts.data()), counts.size());
+
+	file_.close();
+	return static_cast<bool>(file_);
+}
+
+bool ReplayArchive::open(const std::string& path) {
+	game_count_ = 0;
+	index_offset_ = 0;
+	if (!file_.open(path) || file_.size() < kheader_size || std::memcmp(file_.data(), kmagic, sizeof(kmagic)) != 0) {
+		file_.close();
+		return false;
+	}
+
+	BinaryReader in(file_.data() + sizeof(kmagic), file_.size() - sizeof(kmagic));
+	uint32_t version;
+	uint64_t game_count, index_offset;
+	in.read(version);
+	in.read(game_count);
+	in.read(index_offset);
+	if (version != ReplayArchiveWriter::kversion || index_offset > file_.size()
+		|| game_count > (file_.size() - index_offset) / sizeof(uint64_t)) {
+		file_.close();
+		return false;
+	}
+	game_count_ = game_count;
+	index_offset_ = index_offset;
+	return true;
+}
+
+size_t ReplayArchive::getGameCount() const {
+	return static_cast<size_t>(game_count_);
+}
+
+bool ReplayArchive::gameOffset(size_t game, uint64_t& offset) const {
+	if (game >= game_count_) {
+		return false;
+	}
+	BinaryReader in(file_.data() + index_offset_ + game * sizeof(uint64_t), sizeof(uint64_t));
+	return in.read(offset) && offset < file_.size();
+}
+
+bool ReplayArchive::getGame(size_t game, ArchivedGame& info) const {
+	uint64_t offset;
+	GameHeader header;
+	if (!gameOffset(game, offset)) {
+		return false;
+	}
+	BinaryReader in(file_.data() + offset, file_.size() - offset);
+	if (!readGameHeader(in, header)) {
+		return false;
+	}
+
+	info.seed = header.seed;
+	info.board_width = header.board_width;
+	info.board_height = header.board_height;
+	info.ticks = header.ticks;
+	info.food_eaten = header.food_eaten;
+	info.final_state = static_cast<GameState>(header.final_state);
+	return true;
+}
+
+bool ReplayArchive::getRecording(size_t game, std::vector<uint8_t>& bytes) const {
+	uint64_t offset;
+	GameHeader header;
+	if (!gameOffset(game, offset)) {
+		return false;
+	}
+	BinaryReader in(file_.data() + offset, file_.size() - offset);
+	if (!readGameHeader(in, header) || in.remaining() / kkeyframe_size < header.keyframe_count) {
+		return false;
+	}
+	size_t recording_begin = in.getPosition() + header.keyframe_count * kkeyframe_size;
+	if (in.remaining() - header.keyframe_count * kkeyframe_size < header.recording_size) {
+		return false;
+	}
+	const uint8_t* recording = file_.data() + offset + recording_begin;
+	bytes.assign(recording, recording + header.recording_size);
+	return true;
+}
+
+/*
+Only the game's header, one keyframe entry, the keyframe's state and the recording from that keyframe on are read,
+so seeking costs the same anywhere in any game: one state decode and at most one keyframe interval of ticks
+*/
+bool ReplayArchive::seek(size_t game, long long tick, Simulation& out) const {
+	uint64_t offset;
+	GameHeader header;
+	if (!gameOffset(game, offset)) {
+		return false;
+	}
+	BinaryReader in(file_.data() + offset, file_.size() - offset);
+	if (!readGameHeader(in, header) || in.remaining() / kkeyframe_size < header.keyframe_count
+		|| in.remaining() - header.keyframe_count * kkeyframe_size < header.recording_size) {
+		return false;
+	}
+	tick = std::max(0LL, std::min(tick, static_cast<long long>(header.ticks)));
+	const uint8_t* entries = file_.data() + offset + in.getPosition();
+	const uint8_t* recording = entries + header.keyframe_count * kkeyframe_size;
+
+	size_t keyframe_index = static_cast<size_t>(tick / header.keyframe_interval);
+	Keyframe keyframe;
+	BinaryReader entry(entries + keyframe_index * kkeyframe_size, kkeyframe_size);
+	if (!readKeyframe(entry, keyframe) || keyframe.events_position > header.recording_size) {
+		return false;
+	}
+
+	Simulation restored(header.board_width, header.board_height, header.seed);
+	if (keyframe.state_offset != 0) {
+		if (keyframe.state_offset > file_.size() || keyframe.state_size > file_.size() - keyframe.state_offset) {
+			return false;
+		}
+		BinaryReader state(file_.data() + keyframe.state_offset, keyframe.state_size);
+		if (!restored.readState(state)) {
+			return false;
+		}
+	}
+
+	ReplayEventReader events(recording, header.recording_size, keyframe.events_position, keyframe.events_tick,
+		static_cast<SnakeDirection>(keyframe.last_turn));
+	ReplayEvent event;
+	while (events.next(event) && event.kind != END && event.tick < tick) {
+		while (restored.getTickCount() < event.tick && restored.getState() == IN_PROGRESS) {
+			restored.tick();
+		}
+		ReplayEventReader::apply(restored, event);
+	}
+	while (restored.getTickCount() < tick && restored.getState() == IN_PROGRESS) {
+		restored.tick();
+	}
+	out = std::move(restored);
+	return true;
+}
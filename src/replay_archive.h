@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "game_types.h"
+#include "mapped_file.h"
+#include "replay.h"
+#include "simulation.h"
+
+namespace snakelinkedlist {
+
+// The summary of one game in an archive, readable without decoding the game
+struct ArchivedGame {
+	uint32_t seed = 0; // Seed the game started with
+	int board_width = 0; // Board size the game started with
+	int board_height = 0;
+	long long ticks = 0; // Length of the game in ticks
+	int food_eaten = 0; // Final score
+	GameState final_state = IN_PROGRESS; // FINISHED if the snake died, IN_PROGRESS if the recording stopped first
+};
+
+/*
+An archive is a single file holding any number of recorded games, built for seeking to any tick of any game
+without reading the rest of the file.
+
+Each game stores its recording (see ReplayRecorder) plus a keyframe every keyframe interval ticks: the complete
+state of the game at that tick (Simulation::writeState()) and where the recording continues from. Seeking to tick T
+decodes the keyframe at or before T and re-simulates at most one interval of ticks from it. The keyframe for tick 0
+is the seed itself and takes no space.
+
+Layout, all values little endian:
+	header: "SNKA", u32 version, u64 game count, u64 offset of the game index
+	per game: u32 seed, i32 board width, i32 board height, u32 keyframe interval, i64 ticks, i32 food eaten,
+	          i32 final GameState, u32 keyframe count, u32 recording size,
+	          keyframe count entries of: i64 tick, u64 state offset in the file (0 for the seed), u32 state size,
+	                                     u32 offset of the next event in the recording, i64 tick of the previous event,
+	                                     i32 direction of the previous turn
+	          the recording, then the keyframe states
+	game index: u64 file offset of each game
+The index comes last so games can be streamed into the file, and opening only reads the header.
+*/
+class ReplayArchiveWriter {
+private:
+	std::ofstream file_; // The archive being written
+	uint64_t file_size_ = 0; // Bytes written so far, the offset of the next game
+	std::vector<uint64_t> game_offsets_; // Where each game starts, written out as the index by finish()
+	int keyframe_interval_ = 0; // Ticks between keyframes
+
+public:
+	static const uint32_t kversion = 2; // Format version written by this writer, keyframes from version 1 hold pixel positions
+	static const int kdefault_keyframe_interval = 600; // 50 seconds at the game's tick rate
+
+	~ReplayArchiveWriter(); // Finishes the archive if finish() wasn't called
+	bool open(const std::string& path, int keyframe_interval = kdefault_keyframe_interval); // Creates (or replaces) an archive, false if it can't be written
+	bool addGame(const ReplayPlayer& recording); // Re-simulates a recording to build its keyframes and appends the game, false if the recording is invalid or the write failed
+	bool finish(); // Writes the game index and closes the file, false if the write failed
+};
+
+/*
+Reads an archive written by ReplayArchiveWriter. The file is mapped (see MappedFile), so opening an archive takes
+the same time whether it holds one game or millions, and reading a game only touches that game's part of the file.
+*/
+class ReplayArchive {
+private:
+	MappedFile file_; // The archive
+	uint64_t game_count_ = 0; // Number of games in the archive
+	uint64_t index_offset_ = 0; // Where the game index starts
+
+	bool gameOffset(size_t game, uint64_t& offset) const; // Reads where a game starts from the index, false if out of range
+
+public:
+	bool open(const std::string& path); // Opens an archive, false if it can't be read or isn't an archive
+	size_t getGameCount() const; // Gets the number of games in the archive
+	bool getGame(size_t game, ArchivedGame& info) const; // Reads the summary of a game, false if the game is out of range or damaged
+	bool seek(size_t game, long long tick, Simulation& out) const; // Rebuilds the game as it was after tick ticks (before that tick's input), false if the game is damaged
+	bool getRecording(size_t game, std::vector<uint8_t>& bytes) const; // Copies out a game's original recording
+};
+} // namespace snakelinkedlist
@@ -0,0 +1,248 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace snakelinkedlist {
+
+/**
+ * Contiguous circular buffer indexed from the front. Elements live in a single power of two sized block so
+ * pushing on the front and popping off the back are O(1) and never touch the rest of the elements.
+ * The buffer always keeps at least one free slot, so the slot of the most recently popped back element stays
+ * intact until the next push.
+ */
+template<typename ElementType>
+class RingBuffer {
+    std::vector<ElementType> slots_;    // Backing storage, size is always a power of two
+    std::size_t mask_;                  // slots_.size() - 1, used to wrap indices
+    std::size_t head_;                  // Slot index of the front element
+    std::size_t size_;                  // Number of elements currently stored
+
+    void grow(std::size_t slots);       // Moves to storage of the given size and unwraps the elements to start at slot 0
+
+public:
+    explicit RingBuffer(std::size_t capacity = 16);     // Creates an empty buffer with room for capacity elements
+
+    void push_front(const ElementType& value);  // Push value on front
+    void push_back(const ElementType& value);   // Push value on back
+    void pop_front();                           // Remove front element, does nothing if empty
+    void pop_back();                            // Remove back element, does nothing if empty
+    void clear();                               // Remove all elements, keeping the allocated storage
+    void reserve(std::size_t capacity);         // Make room for capacity elements so pushes up to that size never allocate
+    void assign(const ElementType* values, std::size_t count);  // Replace the contents with count values from front to back
+
+    ElementType& front();                       // Access the front value, buffer must not be empty
+    const ElementType& front() const;
+    ElementType& back();                        // Access the back value, buffer must not be empty
+    const ElementType& back() const;
+    ElementType& operator[](std::size_t i);     // Access the ith value from the front
+    const ElementType& operator[](std::size_t i) const;
+
+    std::size_t size() const { return size_; }              // Number of elements stored
+    bool empty() const { return size_ == 0; }               // Check if empty
+    std::size_t capacity() const { return slots_.size(); }  // Number of slots allocated
+
+    std::size_t slotOf(std::size_t i) const { return (head_ + i) & mask_; } // Storage slot of the ith element
+    const ElementType* data() const { return slots_.data(); }              // Raw slots, in storage order
+
+    // Read only iterator over the elements from front to back
+    class const_iterator {
+        const RingBuffer* ring_;
+        std::size_t index_;
+        friend RingBuffer;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef ElementType value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const ElementType* pointer;
+        typedef const ElementType& reference;
+
+        const_iterator() : ring_(nullptr), index_(0) {}
+        const_iterator& operator++() { ++index_; return *this; }
+        reference operator*() const { return (*ring_)[index_]; }
+        pointer operator->() const { return &(*ring_)[index_]; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+    };
+
+    const_iterator begin() const;
+    const_iterator end() const;
+};
+
+/**
+ * Creates an empty buffer, the capacity is rounded up to the next power of two
+ * @param capacity the number of elements to reserve room for
+ */
+template<typename ElementType>
+RingBuffer<ElementType>::RingBuffer(std::size_t capacity) : head_(0), size_(0) {
+    std::size_t slots = 2;
+    while (slots < capacity + 1) {
+        slots <<= 1;
+    }
+    slots_.resize(slots);
+    mask_ = slots - 1;
+}
+
+/**
+ * Replaces the backing storage with a bigger block. The elements are copied over in order so the front ends up in slot 0.
+ * @param slots the new number of slots, a power of two
+ */
+template<typename ElementType>
+void RingBuffer<ElementType>::grow(std::size_t slots) {
+    std::vector<ElementType> bigger(slots);
+    for (std::size_t i = 0; i < size_; i++) {
+        bigger[i] = slots_[slotOf(i)];
+    }
+    slots_.swap(bigger);
+    mask_ = slots_.size() - 1;
+    head_ = 0;
+}
+
+/**
+ * Adds an element before the current front, this never moves the existing elements unless storage has to grow
+ * @param value data to be added
+ */
+template<typename ElementType>
+void RingBuffer<ElementType>::push_front(const ElementType &value) {
+    if (size_ + 1 >= slots_.size()) {
+        grow(slots_.size() * 2);
+    }
+    head_ = (head_ - 1) & mask_;
+    slots_[head_] = value;
+    size_++;
+}
+
+/**
+ * Adds an element after the current back
+ * @param value data to be added
+ */
+template<typename ElementType>
+void RingBuffer<ElementType>::push_back(const ElementType &value) {
+    if (size_ + 1 >= slots_.size()) {
+        grow(slots_.size() * 2);
+    }
+    slots_[slotOf(size_)] = value;
+    size_++;
+}
+
+/**
+ * Removes the front element by advancing the head slot
+ */
+template<typename ElementType>
+void RingBuffer<ElementType>::pop_front() {
+    if (size_ == 0) {
+        return;
+    }
+    head_ = (head_ + 1) & mask_;
+    size_--;
+}
+
+/**
+ * Removes the back element. The slot is left untouched until the next push reuses it.
+ */
+template<typename ElementType>
+void RingBuffer<ElementType>::pop_back() {
+    if (size_ == 0) {
+        return;
+    }
+    size_--;
+}
+
+/**
+ * Grows the storage up front, e.g. to the largest size the buffer will ever reach, so pushes never allocate.
+ * Does nothing if there is already room
+ * @param capacity the number of elements to make room for
+ */
+template<typename ElementType>
+void RingBuffer<ElementType>::reserve(std::size_t capacity) {
+    std::size_t slots = slots_.size();
+    while (slots < capacity + 1) {
+        slots <<= 1;
+    }
+    if (slots != slots_.size()) {
+        grow(slots);
+    }
+}
+
+/**
+ * Copies the values in as one block starting at slot 0, instead of pushing them one at a time
+ * @param values the new contents from front to back
+ * @param count the number of values
+ */
+template<typename ElementType>
+void RingBuffer<ElementType>::assign(const ElementType* values, std::size_t count) {
+    head_ = 0;
+    size_ = 0;
+    reserve(count);
+    std::copy(values, values + count, slots_.begin());
+    size_ = count;
+}
+
+/**
+ * Empties the buffer without releasing its storage so it can be refilled without allocating
+ */
+template<typename ElementType>
+void RingBuffer<ElementType>::clear() {
+    head_ = 0;
+    size_ = 0;
+}
+
+template<typename ElementType>
+ElementType &RingBuffer<ElementType>::front() {
+    return slots_[head_];
+}
+
+template<typename ElementType>
+const ElementType &RingBuffer<ElementType>::front() const {
+    return slots_[head_];
+}
+
+template<typename ElementType>
+ElementType &RingBuffer<ElementType>::back() {
+    return slots_[slotOf(size_ - 1)];
+}
+
+template<typename ElementType>
+const ElementType &RingBuffer<ElementType>::back() const {
+    return slots_[slotOf(size_ - 1)];
+}
+
+template<typename ElementType>
+ElementType &RingBuffer<ElementType>::operator[](std::size_t i) {
+    return slots_[slotOf(i)];
+}
+
+template<typename ElementType>
+const ElementType &RingBuffer<ElementType>::operator[](std::size_t i) const {
+    return slots_[slotOf(i)];
+}
+
+/**
+ * start iterator
+ * @return iterator at the front element
+ */
+template<typename ElementType>
+typename RingBuffer<ElementType>::const_iterator RingBuffer<ElementType>::begin() const {
+    const_iterator start;
+    start.ring_ = this;
+    start.index_ = 0;
+    return start;
+}
+
+/**
+ * end iterator
+ * @return iterator one past the back element
+ */
+template<typename ElementType>
+typename RingBuffer<ElementType>::const_iterator RingBuffer<ElementType>::end() const {
+    const_iterator stop;
+    stop.ring_ = this;
+    stop.index_ = size_;
+    return stop;
+}
+
+} // namespace snakelinkedlist
+#endif //RING_BUFFER_H
@@ -0,0 +1,258 @@
+#include <utility>
+#include "profiler.h"
+#include "simulation.h"
+
+using namespace snakelinkedlist;
+
+Simulation::Simulation(int board_width, int board_height, uint32_t seed)
+	: board_width_(board_width),
+	  board_height_(board_height),
+	  board_(boardForWindow(board_width, board_height)),
+	  seed_(seed),
+	  game_snake_(board_),
+	  game_food_(game_snake_.getOccupancy(), seed) {
+}
+
+/*
+Advances the game by one step. If the game is in progress it will:
+0. Apply the oldest queued turn, if any
+1. Check to see if the current head of the snake is on the food pellet's square. If so:
+    * The snake should grow by length 1 in its current direction
+2. Update the snake in the current direction it is moving
+    * If the snake ate, move the food to a new random empty square
+3. Check to see if the snakes new position has resulted in its death and the end of the game
+*/
+bool Simulation::tick() {
+	if (current_state_ != IN_PROGRESS) {
+		return false;
+	}
+	SNAKE_PROFILE_ALLOCATIONS("simulation/tick_allocations");
+	tick_count_++;
+
+	if (queued_turn_count_ > 0) {
+		turn(queued_turns_[0]);
+		for (int i = 1; i < queued_turn_count_; i++) {
+			queued_turns_[i - 1] = queued_turns_[i];
+		}
+		queued_turn_count_--;
+	}
+
+	bool ate_food;
+	{
+		SNAKE_PROFILE_SCOPE("simulation/food_check");
+		ate_food = game_snake_.getHeadCell() == game_food_.getCell();
+		if (ate_food) {
+			game_snake_.eatFood(game_food_.getColor());
+		}
+	}
+	game_snake_.update();
+
+	// Place the new food once the snake has moved so it can't land on the square the head just entered
+	if (ate_food) {
+		game_food_.rebase(game_snake_.getOccupancy());
+	}
+
+	if (game_snake_.isDead()) {
+		current_state_ = FINISHED;
+		return true;
+	}
+	return false;
+}
+
+/*
+A turn is only legal if the snake is not already moving along that axis,
+turning to the current direction does nothing and turning back on itself would eat the snake
+*/
+bool Simulation::turn(SnakeDirection new_direction) {
+	if (current_state_ != IN_PROGRESS) {
+		return false;
+	}
+
+	SnakeDirection current_direction = game_snake_.getDirection();
+	bool current_vertical = (current_direction == UP || current_direction == DOWN);
+	bool new_vertical = (new_direction == UP || new_direction == DOWN);
+	if (current_vertical == new_vertical) {
+		return false;
+	}
+
+	game_snake_.setDirection(new_direction);
+	return true;
+}
+
+/*
+Turns are checked against the direction the snake will have once every turn already waiting has been applied,
+so quickly pressing two keys (e.g. up then left while moving right) performs both turns on consecutive ticks
+instead of the second one being lost or reversing the snake into itself
+*/
+bool Simulation::queueTurn(SnakeDirection new_direction) {
+	if (current_state_ != IN_PROGRESS || queued_turn_count_ == kmax_queued_turns_) {
+		return false;
+	}
+
+	SnakeDirection last_direction = (queued_turn_count_ > 0)
+		? queued_turns_[queued_turn_count_ - 1]
+		: game_snake_.getDirection();
+	bool last_vertical = (last_direction == UP || last_direction == DOWN);
+	bool new_vertical = (new_direction == UP || new_direction == DOWN);
+	if (last_vertical == new_vertical) {
+		return false;
+	}
+
+	queued_turns_[queued_turn_count_++] = new_direction;
+	return true;
+}
+
+void Simulation::togglePause() {
+	if (current_state_ != FINISHED) {
+		current_state_ = (current_state_ == IN_PROGRESS) ? PAUSED : IN_PROGRESS;
+	}
+}
+
+void Simulation::toggleHighScores() {
+	if (current_state_ != FINISHED) {
+		current_state_ = (current_state_ == IN_PROGRESS) ? HIGHSCORES : IN_PROGRESS;
+	}
+}
+
+void Simulation::reset(uint32_t seed) {
+	seed_ = seed;
+	board_ = boardForWindow(board_width_, board_height_);
+	game_snake_.reset(board_);
+	game_food_ = SnakeFood(game_snake_.getOccupancy(), seed);
+	current_state_ = IN_PROGRESS;
+	tick_count_ = 0;
+	queued_turn_count_ = 0;
+}
+
+// Game state is kept in board squares, so only the window size used for drawing changes. A minimised window (no
+// pixels either way) keeps the last size, so the next game isn't laid out for a window with nothing in it
+void Simulation::resize(int w, int h) {
+	if (w <= 0 || h <= 0) {
+		return;
+	}
+	board_width_ = w;
+	board_height_ = h;
+}
+
+GameState Simulation::getState() const {
+	return current_state_;
+}
+
+uint32_t Simulation::getSeed() const {
+	return seed_;
+}
+
+long long Simulation::getTickCount() const {
+	return tick_count_;
+}
+
+const Snake& Simulation::getSnake() const {
+	return game_snake_;
+}
+
+const SnakeFood& Simulation::getFood() const {
+	return game_food_;
+}
+
+int Simulation::getBoardWidth() const {
+	return board_width_;
+}
+
+int Simulation::getBoardHeight() const {
+	return board_height_;
+}
+
+BoardSize Simulation::getBoardSize() const {
+	return board_;
+}
+
+void Simulation::writeState(BinaryWriter& out) const {
+	out.write(static_cast<int32_t>(board_width_));
+	out.write(static_cast<int32_t>(board_height_));
+	out.write(static_cast<int32_t>(current_state_));
+	out.write(seed_);
+	out.write(static_cast<int64_t>(tick_count_));
+	out.write(static_cast<int32_t>(queued_turn_count_));
+	for (int i = 0; i < queued_turn_count_; i++) {
+		out.write(static_cast<int32_t>(queued_turns_[i]));
+	}
+	game_snake_.writeState(out);
+	game_food_.writeState(out);
+}
+
+bool Simulation::readState(BinaryReader& in) {
+	int32_t board_width, board_height, state, queued_count;
+	uint32_t seed;
+	int64_t tick_count;
+	in.read(board_width);
+	in.read(board_height);
+	in.read(state);
+	in.read(seed);
+	in.read(tick_count);
+	in.read(queued_count);
+	if (!in.ok() || state < IN_PROGRESS || state > HIGHSCORES || queued_count < 0 || queued_count > kmax_queued_turns_) {
+		return false;
+	}
+
+	Simulation restored = *this;
+	for (int i = 0; i < queued_count; i++) {
+		int32_t turn;
+		in.read(turn);
+		if (turn < UP || turn > LEFT) {
+			return false;
+		}
+		restored.queued_turns_[i] = static_cast<SnakeDirection>(turn);
+	}
+	if (!in.ok() || !restored.game_snake_.readState(in) || !restored.game_food_.readState(in)) {
+		return false;
+	}
+
+	restored.board_width_ = board_width;
+	restored.board_height_ = board_height;
+	restored.current_state_ = static_cast<GameState>(state);
+	restored.board_.columns = restored.game_snake_.getOccupancy().getColumns();
+	restored.board_.rows = restored.game_snake_.getOccupancy().getRows();
+	restored.seed_ = seed;
+	restored.tick_count_ = tick_count;
+	restored.queued_turn_count_ = queued_count;
+	*this = std::move(restored);
+	return true;
+}
+
+void Simulation::writeFlat(FlatWriter& out) const {
+	FlatGameHeader& header = out.header();
+	header.board_width = board_width_;
+	header.board_height = board_height_;
+	header.state = current_state_;
+	header.seed = seed_;
+	header.tick_count = tick_count_;
+	header.queued_turn_count = queued_turn_count_;
+	for (int i = 0; i < queued_turn_count_; i++) {
+		header.queued_turns[i] = queued_turns_[i];
+	}
+	game_snake_.writeFlat(out);
+	game_food_.writeFlat(out);
+}
+
+/*
+FlatGameView has already checked every scalar in the header and where each array is, so a restore is only the block
+copies. Whether the arrays agree with each other is FlatGameView::validate()'s job, for saves that may be damaged
+*/
+void Simulation::readFlat(const FlatGameView& in) {
+	SNAKE_PROFILE_SCOPE("simulation/read_flat");
+	const FlatGameHeader& header = in.header();
+	game_snake_.readFlat(in);
+	game_food_.readFlat(in);
+
+	board_width_ = header.board_width;
+	board_height_ = header.board_height;
+	board_.columns = header.columns;
+	board_.rows = header.rows;
+	current_state_ = static_cast<GameState>(header.state);
+	seed_ = header.seed;
+	tick_count_ = header.tick_count;
+	queued_turn_count_ = header.queued_turn_count;
+	for (int i = 0; i < queued_turn_count_; i++) {
+		queued_turns_[i] = static_cast<SnakeDirection>(header.queued_turns[i]);
+	}
+}
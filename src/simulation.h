@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include "game_types.h"
+#include "snake.h"
+#include "SnakeFood.h"
+#include "flat_state.h"
+
+namespace snakelinkedlist {
+
+/*
+The complete rules of the game with no dependency on openFrameworks or a window.
+It owns the board, the snake, the food and the GameState, and advances them one step at a time.
+snakeGame is only an adapter around it that turns key presses into calls on this class and draws the result,
+so the same code can run headless (tests, batch runs, servers) as fast as the CPU allows.
+Everything random comes from the game's seed, so a seed and the turns made on each tick reproduce a game exactly.
+*/
+class Simulation {
+private:
+	int board_width_; // Width of the window the board is drawn in, in pixels
+	int board_height_; // Height of the window the board is drawn in, in pixels
+	BoardSize board_; // Size of the board in squares, fixed for the whole game (see boardForWindow())
+	GameState current_state_ = IN_PROGRESS; // The current state of the game, used to determine possible actions
+	uint32_t seed_; // Seed the current game was started with
+	long long tick_count_ = 0; // Steps the current game has taken
+	Snake game_snake_; // The object that represents the user controlled snake
+	SnakeFood game_food_; // The object that represents the food pellet the user is attempting to eat with the snake
+
+	static const int kmax_queued_turns_ = 3; // Turns requested faster than the game steps wait here, extra ones are dropped
+	SnakeDirection queued_turns_[kmax_queued_turns_] = {}; // Pending turns in the order they were requested, one is applied per tick
+	int queued_turn_count_ = 0; // Number of entries in queued_turns_
+
+public:
+	Simulation(int board_width, int board_height, uint32_t seed); // Starts a new game on the board that fits a window of the given size in pixels
+
+	bool tick(); // Advances an in progress game by one step, returns true if this step ended the game
+	bool turn(SnakeDirection new_direction); // Turns the snake if the game is in progress and the turn is legal, returns whether it turned
+	bool queueTurn(SnakeDirection new_direction); // Requests a turn on a later tick, returns false if it was dropped
+	void togglePause(); // Pauses or unpauses the game, does nothing once the game is over
+	void toggleHighScores(); // Shows or hides the high scores, does nothing once the game is over
+	void reset(uint32_t seed); // Starts a new game with a new seed on the board that fits the current window, reusing the memory of the last game
+	void resize(int w, int h); // The window was resized, the game carries on on the same board, ignored for a minimised window
+
+	GameState getState() const; // Gets the current state of the game
+	uint32_t getSeed() const; // Gets the seed the current game was started with
+	long long getTickCount() const; // Gets the number of steps the current game has taken, turns are recorded against it
+	const Snake& getSnake() const; // Gets the snake for rendering and scoring
+	const SnakeFood& getFood() const; // Gets the food pellet for rendering
+	int getBoardWidth() const; // Gets the width of the window the board is drawn in, in pixels
+	int getBoardHeight() const; // Gets the height of the window the board is drawn in, in pixels
+	BoardSize getBoardSize() const; // Gets the size of the board in squares
+
+	void writeState(BinaryWriter& out) const; // Writes the complete state of the game, the game carries on identically from it
+	bool readState(BinaryReader& in); // Restores a state written by writeState(), false (leaving the game unchanged) if it is damaged
+	void writeFlat(FlatWriter& out) const; // Collects the complete state for a flat save (see flat_state.h), the game must not change until it is written
+	void readFlat(const FlatGameView& in); // Restores a flat save in block copies, check one that may be damaged with FlatGameView::validate() first
+};
+} // namespace snakelinkedlist
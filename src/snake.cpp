@@ -1,175 +1,111 @@
+#include <algorithm>
+#include <utility>
+#include "profiler.h"
 #include "snake.h"
 
 using namespace snakelinkedlist;
 
-const float Snake::kbody_size_modifier_ = 0.02;
-
-SnakeBody* Snake::getHead() const {
-	return head_;
+const RingBuffer<Cell>& Snake::getBody() const {
+	return body_;
 };
 
-ofVec2f Snake::getBodySize() const {
-	return body_size_;
+const std::vector<Color>& Snake::getBodyColors() const {
+	return body_colors_;
 };
 
-Snake::Snake() {
-	int width = ofGetWindowWidth();
-	int height = ofGetWindowHeight();
-	screen_dims_.set(width, height);
+const OccupancyGrid& Snake::getOccupancy() const {
+	return occupancy_;
+};
 
-	float body_d = kbody_size_modifier_ * width;
-	body_size_.set(body_d, body_d);
+// Each segment moved into the place of the one in front of it, so the old position of a segment is the current
+// position of the segment behind it. Only the tail's old square has been vacated and has to be remembered.
+Cell Snake::getPreviousPosition(size_t i) const {
+	if (i + 1 < body_.size()) {
+		return body_[i + 1];
+	}
+	return previous_tail_;
+};
 
-	current_direction_ = RIGHT; // Snake starts out moving right
+Cell Snake::getHeadCell() const {
+	return body_.front();
+};
 
-	head_ = new SnakeBody();
-	head_->position.set(0, 2 * body_d);
-	head_->color = ofColor(0, 100, 0);
-	head_->next = nullptr;
+Snake::Snake(BoardSize board) {
+	reset(board);
 }
 
-Snake& Snake::operator=(const Snake& other) {
-	screen_dims_ = other.screen_dims_;
-	body_size_ = other.body_size_;
-
-	// Copy linked list over by creating new links
-	head_ = new SnakeBody();
-
-	SnakeBody* curr = head_;
-	SnakeBody* other_body = other.head_;
-	while (other_body) {
-		curr->position = other_body->position;
-		curr->color = other_body->color;
-		if (other_body->next)
-		{
-			curr->next = new SnakeBody();
-		}
-
-		curr = curr->next;
-		other_body = other_body->next;
-	}
-    
-    snake_body.clear();
-    current_direction_ = RIGHT;
-
-	return *this;
+/*
+The body can never be longer than the board has squares, so room for that many segments is reserved up front and
+kept from game to game. Once the first game on a board size has started, moving and eating never allocate
+*/
+void Snake::reset(BoardSize board) {
+	current_direction_ = RIGHT; // Snake starts out moving right
+
+	size_t squares = static_cast<size_t>(board.columns) * board.rows;
+	body_.clear();
+	body_.reserve(squares);
+	body_colors_.clear();
+	body_colors_.reserve(squares);
+	food_eaten_ = 0;
+
+	body_.push_front(Cell{0, 2});
+	body_colors_.push_back(Color(0, 100, 0));
+	previous_tail_ = body_.front();
+	rebuildOccupancy(board.columns, board.rows);
 }
 
-Snake::~Snake() {
-	SnakeBody* curr = head_;
-	while (curr) {
-		SnakeBody* next = curr->next;
-		delete curr;
-		curr = next;
+void Snake::rebuildOccupancy(int columns, int rows) {
+	occupancy_.reset(columns, rows);
+	for (const Cell& position : body_) {
+		occupancy_.add(position);
 	}
 }
 
 void Snake::update() { 
-	// Move the rest of the snake up one position
-	SnakeBody* prev = head_;
-	SnakeBody* curr = head_->next;
-	ofVec2f curr_old_pos = head_->position;
-	while (curr) {
-		ofVec2f old_pos_temp = curr->position;
-		curr->position = curr_old_pos;
-		curr_old_pos = old_pos_temp;
-
-		prev = curr;
-		curr = curr->next;
-	}
-
+	SNAKE_PROFILE_SCOPE("snake/update");
 	// Move the head one body square in the direction the snake is moving
-	switch (current_direction_) {
-		case UP:
-			head_->position.set(head_->position.x, head_->position.y - body_size_.y);
-			break;
-		case DOWN:
-			head_->position.set(head_->position.x, head_->position.y + body_size_.y);
-			break;
-		case LEFT:
-			head_->position.set(head_->position.x - body_size_.x, head_->position.y);
-			break;
-		case RIGHT:
-			head_->position.set(head_->position.x + body_size_.x, head_->position.y);
-			break;
-	}
+	Cell head_position = neighbour(body_.front(), current_direction_);
+
+	// Every other segment takes the place of the one in front of it, which is the same as dropping the tail
+	// and adding the new head, so the rest of the body does not have to move
+	previous_tail_ = body_.back();
+	occupancy_.remove(previous_tail_);
+	body_.pop_back();
+	body_.push_front(head_position);
+	occupancy_.add(head_position);
 }
 
 bool Snake::isDead() const {
+	SNAKE_PROFILE_SCOPE("snake/is_dead");
 	// Snake is dead if the head is off screen
-	if (head_->position.x < 0
-		|| head_->position.y < 0
-		|| head_->position.x > screen_dims_.x - body_size_.x
-		|| head_->position.y > screen_dims_.y - body_size_.y) {
+	Cell head_cell = body_.front();
+	if (!occupancy_.inBounds(head_cell)) {
 		return true;
 	}
 
-	// If the snake's head is intersecting with any piece of its body it is dead
-	ofRectangle head_rect(head_->position.x, head_->position.y, body_size_.x, body_size_.y);
-	for (SnakeBody* curr = head_->next; curr; curr = curr->next) {
-		ofRectangle body_rect(curr->position.x, curr->position.y, body_size_.x, body_size_.y);
-		if (head_rect.intersects(body_rect)) {
-			return true;
-		}
+	// If the snake's head shares its square with any piece of its body it is dead
+	if (occupancy_.count(head_cell) > 1) {
+		return true;
 	}
 	
 	// Snake is not dead yet :D
 	return false;
 }
 
-void Snake::eatFood(ofColor newBodyColor) {
-	// Add a new link to our naive linked list
-	snake_body.push_back(SnakeBodySegment(1));
-
-	// Set up our new body piece
-	SnakeBody* new_body = new SnakeBody();
-	new_body->color = newBodyColor;
-	new_body->next = nullptr;
-
-	// find the current tail of the snake
-	SnakeBody* last_body = head_;
-	while (last_body->next) {
-		last_body = last_body->next;
-	}
+void Snake::eatFood(Color newBodyColor) {
+	food_eaten_++;
 
 	// The current position of the new tail is one unit in the opposite direction of the snakes current movement
-	switch (current_direction_) {
-		case UP:
-			new_body->position.set(last_body->position.x, last_body->position.y + body_size_.y);
-			break;
-		case DOWN:
-			new_body->position.set(last_body->position.x, last_body->position.y - body_size_.y);
-			break;
-		case LEFT:
-			new_body->position.set(last_body->position.x + body_size_.x, last_body->position.y);
-			break;
-		case RIGHT:
-			new_body->position.set(last_body->position.x - body_size_.x, last_body->position.y);
-			break;
-	}
+	Cell new_position = neighbour(body_.back(), kopposite[current_direction_]);
 
 	// Attach a new tail to the snake
-	last_body->next = new_body;
-}
-
-// Resize the snake based on the ratio of old to new position
-void Snake::resize(int w, int h) {
-	int width = ofGetWindowWidth();
-	int height = ofGetWindowHeight();
-
-	for (SnakeBody* curr = head_; curr != NULL; curr = curr->next) {
-		float new_x = ((curr->position.x / screen_dims_.x) * w);
-		float new_y = ((curr->position.y / screen_dims_.y) * h);
-		curr->position.set(new_x, new_y);
-	}
-	screen_dims_.set(width, height);
-
-	float body_d = kbody_size_modifier_ * width;
-	body_size_.set(body_d, body_d);
+	body_.push_back(new_position);
+	body_colors_.push_back(newBodyColor);
+	occupancy_.add(new_position);
 }
 
 int Snake::getFoodEaten() const {
-	return snake_body.size();
+	return food_eaten_;
 }
 
 SnakeDirection Snake::getDirection() const {
@@ -179,3 +115,115 @@ SnakeDirection Snake::getDirection() const {
 void Snake::setDirection(SnakeDirection newDirection) {
 	current_direction_ = newDirection;
 }
+
+/*
+Writes the direction, the board size, every segment with its color, the old tail position, the score
+and the order of the empty squares, which decides where the next food lands
+*/
+void Snake::writeState(BinaryWriter& out) const {
+	out.write(static_cast<int32_t>(current_direction_));
+	out.write(static_cast<int32_t>(occupancy_.getColumns()));
+	out.write(static_cast<int32_t>(occupancy_.getRows()));
+	out.write(static_cast<uint32_t>(body_.size()));
+	for (const Cell& position : body_) {
+		out.write(position);
+	}
+	out.writeBytes(body_colors_.data(), body_colors_.size() * sizeof(Color));
+	out.write(previous_tail_);
+	out.write(static_cast<uint32_t>(food_eaten_));
+
+	out.write(static_cast<uint32_t>(occupancy_.getFreeCount()));
+	for (int i = 0; i < occupancy_.getFreeCount(); i++) {
+		Cell square = occupancy_.getFree(i);
+		out.write(static_cast<int32_t>(square.y * occupancy_.getColumns() + square.x));
+	}
+}
+
+bool Snake::readState(BinaryReader& in) {
+	int32_t direction, columns, rows;
+	uint32_t length;
+	Snake restored = *this;
+	in.read(direction);
+	in.read(columns);
+	in.read(rows);
+	in.read(length);
+	if (!in.ok() || direction < UP || direction > LEFT || columns < 0 || rows < 0 || length == 0
+		|| length > in.remaining() / (sizeof(Cell) + sizeof(Color))) {
+		return false;
+	}
+	restored.current_direction_ = static_cast<SnakeDirection>(direction);
+
+	restored.body_.clear();
+	for (uint32_t i = 0; i < length; i++) {
+		Cell position;
+		in.read(position);
+		restored.body_.push_back(position);
+	}
+	restored.body_colors_.resize(length);
+	in.readBytes(restored.body_colors_.data(), length * sizeof(Color));
+	in.read(restored.previous_tail_);
+
+	uint32_t food_eaten;
+	in.read(food_eaten);
+	if (!in.ok() || food_eaten >= length) {
+		return false;
+	}
+	restored.food_eaten_ = static_cast<int>(food_eaten);
+
+	uint32_t free_count;
+	in.read(free_count);
+	// Every square is either empty or under the body, which also bounds the grid a damaged state could ask for
+	if (!in.ok() || free_count > in.remaining() / sizeof(int32_t)
+		|| static_cast<int64_t>(columns) * rows > static_cast<int64_t>(free_count) + length) {
+		return false;
+	}
+	std::vector<int> free_squares(free_count);
+	for (uint32_t i = 0; i < free_count; i++) {
+		int32_t square;
+		in.read(square);
+		free_squares[i] = square;
+	}
+	restored.rebuildOccupancy(columns, rows);
+	if (!restored.occupancy_.setFreeOrder(free_squares)) {
+		return false;
+	}
+	restored.body_.reserve(static_cast<size_t>(columns) * rows); // Same room as reset() gives a new game
+	restored.body_colors_.reserve(static_cast<size_t>(columns) * rows);
+
+	*this = std::move(restored);
+	return true;
+}
+
+// The ring is saved from head to tail, in two pieces when it wraps around the end of its storage
+void Snake::writeFlat(FlatWriter& out) const {
+	FlatGameHeader& header = out.header();
+	header.direction = current_direction_;
+	header.food_eaten = food_eaten_;
+	header.previous_tail = previous_tail_;
+	header.body_length = static_cast<uint32_t>(body_.size());
+
+	// The ring may wrap around the end of its slots, then the body is saved in two pieces
+	size_t head = body_.slotOf(0);
+	size_t first = std::min(body_.size(), body_.capacity() - head);
+	header.body = out.add(body_.data() + head, first * sizeof(Cell), body_.data(), (body_.size() - first) * sizeof(Cell));
+	header.body_colors = out.add(body_colors_.data(), body_colors_.size() * sizeof(Color));
+	occupancy_.writeFlat(out);
+}
+
+/*
+Every array is one block copy, nothing is read a segment at a time. Room for a body the size of the board is reserved
+like reset() does, so restoring into a snake that already played on the same board doesn't allocate
+*/
+void Snake::readFlat(const FlatGameView& in) {
+	const FlatGameHeader& header = in.header();
+	size_t squares = static_cast<size_t>(header.columns) * header.rows;
+	current_direction_ = static_cast<SnakeDirection>(header.direction);
+	food_eaten_ = header.food_eaten;
+	previous_tail_ = header.previous_tail;
+
+	body_.reserve(squares);
+	body_.assign(in.getBody(), header.body_length);
+	body_colors_.reserve(squares);
+	body_colors_.assign(in.getBodyColors(), in.getBodyColors() + header.body_length);
+	occupancy_.readFlat(in);
+}
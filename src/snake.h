@@ -1,58 +1,45 @@
-#include "ref_ll.h"
-#include "ofMain.h"
-#include "snakebody.h"
+#include <vector>
+#include "ring_buffer.h"
+#include "occupancy_grid.h"
+#include "game_types.h"
+#include "binary_io.h"
+#include "flat_state.h"
 #pragma once
 
 namespace snakelinkedlist {
 
-// Enum that represents all possible directions that the snake can be moving
-typedef enum {
-	UP = 0,
-	DOWN,
-	RIGHT,
-	LEFT
-} SnakeDirection;
-
-/* 
-Node that represents a segment of the snake body. 
-This is due to the limitations of ll
-1. We can only place a specific type of node in the ll
-2. ll provides no convenient way to update the data in a list
-    We could expose the internal structure of the list but 
-    the underlying data and implementation of a data structure
-    is meant to be private and exposing it is a critical sin.
-    A linked list that had an iterator interface would remedy this issue
-*/
-struct SnakeBody { // TODO replace with templated ll
-	SnakeBody* next;
-	ofVec2f position;
-	ofColor color;
-};
-
 class Snake {
 private:
 	SnakeDirection current_direction_; // The current direction of the snake
-	ofVec2f screen_dims_; // The current screen dimensions (needed to calculate values on resize()
-	static const float kbody_size_modifier_; // The proportion of the screen width a body square is
-	ofVec2f body_size_; // the size of a snake body piece based on kbody_size_modifier_
-	SnakeBody* head_; // The head of the linked list, we are forced to do this because snakebody 
-	                  // does not support all of the data we must keep track of
-    
-	LinkedList<SnakeBodySegment> snake_body; // our linked list implementation, we might as well use it to keep track of score
-	                       // But ideally it should store all of the information of our snake once it is improved
+	RingBuffer<Cell> body_; // Squares of every body segment, the head is at the front and the tail at the back.
+	                          // Moving writes a new head and drops the tail so the rest of the body is never touched
+	std::vector<Color> body_colors_; // The color of each body segment, indexed from the head. Colors belong to a
+	                                   // place in the body rather than a position so they don't move on update()
+
+	Cell previous_tail_; // Where the tail was before the last update(), used to animate the step between ticks
+	OccupancyGrid occupancy_; // How many segments cover each board square, kept in step with body_ so collisions are a lookup
+
+	int food_eaten_ = 0; // The score. Kept as a count rather than a list node per meal so copying a snake is a few block copies
+
+	void rebuildOccupancy(int columns, int rows); // Sizes the grid and fills it from the current body
 
 public:
-	SnakeBody* getHead() const; //TODO remove this once iterators are added (publicly exposes snakes internal structure :'()
-	Snake(); // Default constructor, initializes and places length 1 snake
-	Snake& operator=(const Snake& other); // copy constructor
-	~Snake(); // destructor
-	ofVec2f getBodySize() const; // gets the size of a body segment, used for rendering
+	explicit Snake(BoardSize board); // Initializes and places a length 1 snake on a board of the given size in squares
+	void reset(BoardSize board); // Puts a length 1 snake back at the start, reusing the memory of the last game
+	const RingBuffer<Cell>& getBody() const; // Read only view of the body squares from head to tail
+	const std::vector<Color>& getBodyColors() const; // The colors of the body segments from head to tail
+	const OccupancyGrid& getOccupancy() const; // The squares currently covered by the body
+	Cell getPreviousPosition(size_t i) const; // Where segment i was before the last update(), for interpolated drawing
+	Cell getHeadCell() const; // The board square the head is on
 	bool isDead() const; // Determines if the current state of the snake is dead
 	void update(); // updates the snake one body square in the current direction
-	void eatFood(ofColor new_body_color); // the snake has eaten a food while travelling in a certain direction.
-	void resize(int w, int h); // Resizes the snake to a new width and height
+	void eatFood(Color new_body_color); // the snake has eaten a food while travelling in a certain direction.
 	int getFoodEaten() const; // Gets the number of food items the snake has eaten
 	SnakeDirection getDirection() const; // Gets the Snake's current direction
 	void setDirection(SnakeDirection new_direction); // Sets the Snake's direction
+	void writeState(BinaryWriter& out) const; // Writes everything needed to carry on from this exact state
+	bool readState(BinaryReader& in); // Restores a state written by writeState(), false (leaving the snake unchanged) if it is damaged
+	void writeFlat(FlatWriter& out) const; // Adds the snake and its grid to a flat save, pointing at the snake's own memory
+	void readFlat(const FlatGameView& in); // Restores the snake and its grid from a flat save
 };
 } // namespace snakelinkedlist
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "profiler.h"
+#include "software_renderer.h"
+
+using namespace snakelinkedlist;
+
+// Colors are kept packed in pixel byte order (r, g, b, a) so comparing and filling deal with one word
+static uint32_t pack(Color color) {
+	const uint8_t bytes[4] = {color.r, color.g, color.b, 255};
+	uint32_t packed;
+	std::memcpy(&packed, bytes, sizeof(packed));
+	return packed;
+}
+
+SoftwareRenderer::SoftwareRenderer(int square_pixels, Color background)
+	: square_pixels_(std::max(square_pixels, 1)), background_(background) {
+}
+
+int SoftwareRenderer::indexOf(Cell square) const {
+	if (square.x < 0 || square.y < 0 || square.x >= board_.columns || square.y >= board_.rows) {
+		return -1;
+	}
+	return square.y * board_.columns + square.x;
+}
+
+// The first row of the square is filled pixel by pixel and copied down to the rest
+void SoftwareRenderer::paint(int square, uint32_t color) {
+	if (painted_[square] == color) {
+		return;
+	}
+	painted_[square] = color;
+	repainted_squares_++;
+
+	size_t row_bytes = static_cast<size_t>(getWidth()) * 4;
+	size_t square_bytes = static_cast<size_t>(square_pixels_) * 4;
+	int x = square % board_.columns;
+	int y = square / board_.columns;
+	uint8_t* top = &pixels_[static_cast<size_t>(y) * square_pixels_ * row_bytes + x * square_bytes];
+	for (int i = 0; i < square_pixels_; i++) {
+		std::memcpy(top + i * 4, &color, 4);
+	}
+	for (int row = 1; row < square_pixels_; row++) {
+		std::memcpy(top + row * row_bytes, top, square_bytes);
+	}
+}
+
+void SoftwareRenderer::layout(BoardSize board) {
+	board_ = board;
+	uint32_t background = pack(background_);
+	pixels_.resize(static_cast<size_t>(getWidth()) * getHeight() * 4);
+	for (size_t i = 0; i < pixels_.size(); i += 4) {
+		std::memcpy(&pixels_[i], &background, 4);
+	}
+	painted_.assign(static_cast<size_t>(board.columns) * board.rows, background);
+	painted_body_.clear();
+	painted_food_ = -1;
+	repainted_squares_ = painted_.size();
+}
+
+void SoftwareRenderer::render(const Simulation& game) {
+	render(game.getSnake(), game.getFood());
+}
+
+/*
+Brings the buffer up to date in four passes, each of which skips squares that already have the right color:
+1. Squares the body covered last time and doesn't now go back to the background (the tail moved, or a new game)
+2. So does the old food square, unless something else is on it now
+3. The food is painted unless the snake covers it (the head has just reached it)
+4. The body is painted from the tail to the head, so the head is on top if the snake ran into itself
+*/
+void SoftwareRenderer::render(const Snake& snake, const SnakeFood& food) {
+	SNAKE_PROFILE_SCOPE("renderer/render");
+	const OccupancyGrid& occupancy = snake.getOccupancy();
+	BoardSize board = {occupancy.getColumns(), occupancy.getRows()};
+	repainted_squares_ = 0;
+	if (board.columns != board_.columns || board.rows != board_.rows || painted_.empty()) {
+		layout(board);
+	}
+
+	uint32_t background = pack(background_);
+	for (int square : painted_body_) {
+		if (occupancy.count(Cell{square % board_.columns, square / board_.columns}) == 0) {
+			paint(square, background);
+		}
+	}
+
+	int food_square = indexOf(food.getCell());
+	bool food_covered = occupancy.count(food.getCell()) > 0;
+	if (painted_food_ >= 0 && painted_food_ != food_square &&
+		occupancy.count(Cell{painted_food_ % board_.columns, painted_food_ / board_.columns}) == 0) {
+		paint(painted_food_, background);
+	}
+	if (food_square >= 0 && !food_covered) {
+		paint(food_square, pack(food.getColor()));
+	}
+	painted_food_ = food_square;
+
+	const RingBuffer<Cell>& body = snake.getBody();
+	const std::vector<Color>& colors = snake.getBodyColors();
+	painted_body_.clear();
+	for (size_t i = body.size(); i-- > 0;) {
+		int square = indexOf(body[i]);
+		if (square >= 0) {
+			paint(square, pack(colors[i]));
+			painted_body_.push_back(square);
+		}
+	}
+	SNAKE_PROFILE_COUNT("renderer/repainted_squares", repainted_squares_);
+}
+
+void SoftwareRenderer::invalidate() {
+	painted_.clear();
+}
+
+int SoftwareRenderer::getWidth() const {
+	return board_.columns * square_pixels_;
+}
+
+int SoftwareRenderer::getHeight() const {
+	return board_.rows * square_pixels_;
+}
+
+const std::vector<uint8_t>& SoftwareRenderer::getPixels() const {
+	return pixels_;
+}
+
+size_t SoftwareRenderer::getRepaintedSquares() const {
+	return repainted_squares_;
+}
+
+void SoftwareRenderer::writeRaw(std::ostream& out) const {
+	out.write(reinterpret_cast<const char*>(pixels_.data()), static_cast<std::streamsize>(pixels_.size()));
+}
+
+static void writeBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+	out.push_back(static_cast<uint8_t>(value >> 24));
+	out.push_back(static_cast<uint8_t>(value >> 16));
+	out.push_back(static_cast<uint8_t>(value >> 8));
+	out.push_back(static_cast<uint8_t>(value));
+}
+
+static std::vector<uint32_t> crcTable() {
+	std::vector<uint32_t> table(256);
+	for (uint32_t i = 0; i < 256; i++) {
+		uint32_t crc = i;
+		for (int bit = 0; bit < 8; bit++) {
+			crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+		}
+		table[i] = crc;
+	}
+	return table;
+}
+
+static uint32_t crc32(const uint8_t* data, size_t size) {
+	static const std::vector<uint32_t> table = crcTable();
+	uint32_t crc = 0xFFFFFFFFu;
+	for (size_t i = 0; i < size; i++) {
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFFu;
+}
+
+// A PNG chunk is its length, type, data and a CRC of the type and data
+static void writeChunk(std::vector<uint8_t>& png, const char type[4], const std::vector<uint8_t>& data) {
+	writeBigEndian(png, static_cast<uint32_t>(data.size()));
+	size_t start = png.size();
+	png.insert(png.end(), type, type + 4);
+	png.insert(png.end(), data.begin(), data.end());
+	writeBigEndian(png, crc32(&png[start], png.size() - start));
+}
+
+/*
+The image data is a zlib stream of stored (uncompressed) deflate blocks, which any decoder reads and which costs no
+more than a copy to write. Frames are mostly flat color so they compress very well, run them through a real encoder
+(e.g. optipng, or ffmpeg for videos) if size matters
+*/
+void SoftwareRenderer::encodePng(std::vector<uint8_t>& png) const {
+	static const uint8_t ksignature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+	static const size_t kmax_block = 65535;
+	png.assign(ksignature, ksignature + sizeof(ksignature));
+
+	std::vector<uint8_t> header;
+	writeBigEndian(header, static_cast<uint32_t>(getWidth()));
+	writeBigEndian(header, static_cast<uint32_t>(getHeight()));
+	const uint8_t format[5] = {8, 6, 0, 0, 0}; // 8 bit RGBA, deflate, no filtering, not interlaced
+	header.insert(header.end(), format, format + sizeof(format));
+	writeChunk(png, "IHDR", header);
+
+	// Every row starts with a filter type byte, 0 keeps the row as it is
+	size_t row_bytes = static_cast<size_t>(getWidth()) * 4;
+	std::vector<uint8_t> rows;
+	rows.reserve((row_bytes + 1) * getHeight());
+	for (int y = 0; y < getHeight(); y++) {
+		rows.push_back(0);
+		rows.insert(rows.end(), pixels_.begin() + y * row_bytes, pixels_.begin() + (y + 1) * row_bytes);
+	}
+
+	std::vector<uint8_t> stream = {0x78, 0x01};
+	size_t offset = 0;
+	do {
+		size_t block = std::min(kmax_block, rows.size() - offset);
+		bool last = offset + block == rows.size();
+		stream.push_back(last ? 1 : 0);
+		stream.push_back(static_cast<uint8_t>(block));
+		stream.push_back(static_cast<uint8_t>(block >> 8));
+		stream.push_back(static_cast<uint8_t>(~block));
+		stream.push_back(static_cast<uint8_t>(~block >> 8));
+		stream.insert(stream.end(), rows.begin() + offset, rows.begin() + offset + block);
+		offset += block;
+	} while (offset < rows.size());
+
+	uint32_t a = 1;
+	uint32_t b = 0;
+	for (uint8_t byte : rows) {
+		a = (a + byte) % 65521;
+		b = (b + a) % 65521;
+	}
+	writeBigEndian(stream, (b << 16) | a);
+	writeChunk(png, "IDAT", stream);
+	writeChunk(png, "IEND", std::vector<uint8_t>());
+}
+
+bool SoftwareRenderer::writePng(const std::string& path) const {
+	std::vector<uint8_t> png;
+	encodePng(png);
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+	return static_cast<bool>(file);
+}
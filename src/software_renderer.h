@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "game_types.h"
+#include "simulation.h"
+#include "snake.h"
+#include "SnakeFood.h"
+
+namespace snakelinkedlist {
+
+/*
+Draws the board into an RGBA pixel buffer on the CPU, for frames where there is no GPU (thumbnails, videos of
+replays, image comparisons in tests). Each board square is square_pixels across, the image is exactly the board.
+
+Only squares whose content changed since the last render() are repainted: the squares the head entered, the ones
+the tail left, the old and new food, and body squares whose color changed. The renderer keeps what it painted on
+every square, so it never repaints the whole board, but a render() is O(length) however little changed: it walks
+the body and the squares the body covered last time, and painting costs square_pixels^2 per changed square. Segment
+colors belong to a place in the body (see Snake::getBodyColors()) and slide one square towards the tail with every
+move, so a many colored body repaints most of its squares each tick and a single colored one only the head and the
+tail. render/tick_length in the benchmarks measures this for snakes of 10 to 100,000 segments.
+*/
+class SoftwareRenderer {
+private:
+	BoardSize board_ = {0, 0}; // Board the buffer was laid out for, a different board repaints everything
+	int square_pixels_; // Size of a board square in pixels
+	Color background_; // Color of empty squares
+	std::vector<uint8_t> pixels_; // RGBA, row by row from the top left
+	std::vector<uint32_t> painted_; // Packed color last painted on each square, row by row
+	std::vector<int> painted_body_; // Squares the body covered at the last render, checked for squares the tail left
+	int painted_food_ = -1; // Square the food was on at the last render
+	size_t repainted_squares_ = 0; // Squares painted by the last render()
+
+	int indexOf(Cell square) const; // Row by row index of a square, -1 if it is off the board
+	void paint(int square, uint32_t color); // Fills a square if it doesn't already have that color
+	void layout(BoardSize board); // Sizes the buffers for a board and paints it empty
+
+public:
+	explicit SoftwareRenderer(int square_pixels, Color background = Color(200, 200, 200));
+
+	void render(const Simulation& game); // Brings the buffer up to date with the game
+	void render(const Snake& snake, const SnakeFood& food); // Brings the buffer up to date with a snake and food on the snake's board
+	void invalidate(); // Repaints every square on the next render
+
+	int getWidth() const; // Image width in pixels
+	int getHeight() const; // Image height in pixels
+	const std::vector<uint8_t>& getPixels() const; // The image, 4 bytes per pixel (r, g, b, a) row by row
+	size_t getRepaintedSquares() const; // Squares painted by the last render(), the work it did
+
+	void writeRaw(std::ostream& out) const; // Appends the pixels as they are, e.g. to pipe frames into a video encoder
+	void encodePng(std::vector<uint8_t>& png) const; // Encodes the image as a PNG (uncompressed, no external libraries)
+	bool writePng(const std::string& path) const; // Saves the image as a PNG, false if it couldn't be written
+};
+} // namespace snakelinkedlist
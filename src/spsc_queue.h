@@ -0,0 +1,87 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace snakelinkedlist {
+
+/**
+ * Bounded lock free queue for exactly one producer thread and one consumer thread, e.g. key presses going from the
+ * window thread to the simulation thread. Neither side ever waits: push() fails when the queue is full and pop()
+ * fails when it is empty.
+ *
+ * The producer only writes tail_ and the consumer only writes head_, each on its own cache line. Each side also
+ * keeps a copy of the other side's index and only reloads it when the copy says the queue is full (or empty), so
+ * most calls touch no shared cache line at all.
+ */
+template<typename ElementType, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static const std::size_t kcache_line_ = 64;
+
+    ElementType slots_[Capacity];
+
+    alignas(kcache_line_) std::atomic<std::size_t> head_;  // Next slot to pop, written by the consumer
+    std::size_t cached_tail_;                               // Consumer's copy of tail_
+    alignas(kcache_line_) std::atomic<std::size_t> tail_;  // Next slot to push, written by the producer
+    std::size_t cached_head_;                               // Producer's copy of head_
+
+public:
+    SpscQueue() : head_(0), cached_tail_(0), tail_(0), cached_head_(0) {};
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    bool push(const ElementType& value);    // Producer only, false (dropping nothing) if the queue is full
+    bool pop(ElementType& value);           // Consumer only, false if the queue is empty
+    std::size_t size() const;               // Elements waiting, exact from either side's own thread and a snapshot from others
+    static std::size_t capacity() { return Capacity; }
+};
+
+/**
+ * Copies the value into the next free slot and then publishes it with a release store, so the consumer sees the
+ * whole element once it sees the new tail
+ * @param value element to add
+ * @return false if the queue is full
+ */
+template<typename ElementType, std::size_t Capacity>
+bool SpscQueue<ElementType, Capacity>::push(const ElementType &value) {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == Capacity) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        if (tail - cached_head_ == Capacity) {
+            return false;
+        }
+    }
+    slots_[tail & (Capacity - 1)] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Copies the oldest element out and then frees its slot with a release store, so the producer never overwrites
+ * a slot that is still being read
+ * @param value receives the element
+ * @return false if the queue is empty
+ */
+template<typename ElementType, std::size_t Capacity>
+bool SpscQueue<ElementType, Capacity>::pop(ElementType &value) {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head == cached_tail_) {
+            return false;
+        }
+    }
+    value = slots_[head & (Capacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename ElementType, std::size_t Capacity>
+std::size_t SpscQueue<ElementType, Capacity>::size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+}
+
+} // namespace snakelinkedlist
+#endif //SPSC_QUEUE_H
@@ -0,0 +1,71 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace snakelinkedlist {
+
+/**
+ * Hands the latest version of a value from one writer thread to one reader thread without either waiting.
+ * There are three copies: the writer fills its back copy and publish() swaps it with the shared middle one,
+ * the reader's acquire() swaps its front copy with the middle one if something new was published. The writer can
+ * publish as often as it likes (a version the reader never picked up is simply overwritten) and the reader keeps a
+ * stable copy for as long as it wants.
+ *
+ * Copies are reused, so a value type that reuses its storage on assignment (e.g. std::vector) makes updates
+ * allocation free once every copy has grown to size.
+ */
+template<typename ElementType>
+class TripleBuffer {
+    static const uint8_t kfresh_ = 4;   // Set in shared_ when the middle copy hasn't been picked up yet
+
+    ElementType copies_[3];
+    std::atomic<uint8_t> shared_;   // Index of the middle copy, plus kfresh_
+    uint8_t back_;                  // Writer's copy
+    uint8_t front_;                 // Reader's copy
+
+public:
+    explicit TripleBuffer(const ElementType& initial);
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    ElementType& back() { return copies_[back_]; }                  // Writer only, the copy to fill in before publish()
+    void publish();                                                 // Writer only, makes back() the latest version
+    bool acquire();                                                 // Reader only, moves to the latest version, false if there was none newer
+    const ElementType& front() const { return copies_[front_]; }    // Reader only, the version picked up by the last acquire()
+};
+
+/**
+ * Every copy starts out as initial, so the reader has a valid value before anything is published
+ * @param initial the starting value
+ */
+template<typename ElementType>
+TripleBuffer<ElementType>::TripleBuffer(const ElementType &initial)
+        : copies_{initial, initial, initial}, shared_(1), back_(0), front_(2) {
+}
+
+/**
+ * Swaps the filled back copy into the middle. Release ordering makes the writes to it visible to the reader that
+ * picks it up, acquire ordering makes sure the reader is done with the copy the writer gets back
+ */
+template<typename ElementType>
+void TripleBuffer<ElementType>::publish() {
+    back_ = shared_.exchange(static_cast<uint8_t>(back_ | kfresh_), std::memory_order_acq_rel) & 3;
+}
+
+/**
+ * Swaps the front copy for the middle one if a new version has been published since the last call
+ * @return true if front() changed
+ */
+template<typename ElementType>
+bool TripleBuffer<ElementType>::acquire() {
+    if ((shared_.load(std::memory_order_relaxed) & kfresh_) == 0) {
+        return false;
+    }
+    front_ = shared_.exchange(front_, std::memory_order_acq_rel) & 3;
+    return true;
+}
+
+} // namespace snakelinkedlist
+#endif //TRIPLE_BUFFER_H
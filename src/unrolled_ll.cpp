@@ -0,0 +1,538 @@
+//basic functions
+
+/**
+ * default constructor
+ */
+template<typename ElementType, typename Allocator>
+UnrolledLinkedList<ElementType, Allocator>::UnrolledLinkedList()
+        : head_(nullptr), tail_(nullptr), size_(0), node_allocator_() {
+
+}
+
+/**
+ * Allocate a node that is not linked into the list yet
+ * @param begin where the node's first element will go, the end of the block for nodes that grow towards the front
+ * @return the new node
+ */
+template<typename ElementType, typename Allocator>
+typename UnrolledLinkedList<ElementType, Allocator>::Node *UnrolledLinkedList<ElementType, Allocator>::NewNode(int begin) {
+    Node *node = NodeTraits::allocate(node_allocator_, 1);
+    NodeTraits::construct(node_allocator_, node);
+    node->next_ = nullptr;
+    node->prev_ = nullptr;
+    node->begin_ = begin;
+    node->count_ = 0;
+    return node;
+}
+
+/**
+ * Destroy a node that is no longer linked into the list and give its memory back to the allocator
+ * @param node the node to free
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::DeleteNode(Node *node) {
+    NodeTraits::destroy(node_allocator_, node);
+    NodeTraits::deallocate(node_allocator_, node, 1);
+}
+
+/**
+ * Take a node whose last element has been removed out of the list
+ * @param node the empty node
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::Unlink(Node *node) {
+    if (node->prev_ == nullptr) {
+        head_ = node->next_;
+    } else {
+        node->prev_->next_ = node->next_;
+    }
+    if (node->next_ == nullptr) {
+        tail_ = node->prev_;
+    } else {
+        node->next_->prev_ = node->prev_;
+    }
+    DeleteNode(node);
+}
+
+/**
+ * Removing from the middle leaves nodes part full, so once a node is under half full it takes in the elements of
+ * the next node when they fit together. This keeps the list at least about half as dense as a full one however
+ * elements are removed
+ * @param node a node that just lost an element
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::MergeNext(Node *node) {
+    Node *next = node->next_;
+    if (next == nullptr || node->count_ * 2 >= knode_elements_ || node->count_ + next->count_ > knode_elements_) {
+        return;
+    }
+
+    std::move(node->data_ + node->begin_, node->data_ + node->begin_ + node->count_, node->data_);
+    std::move(next->data_ + next->begin_, next->data_ + next->begin_ + next->count_, node->data_ + node->count_);
+    for (int i = node->count_ + next->count_; i < knode_elements_; i++) {
+        node->data_[i] = ElementType();
+    }
+    node->begin_ = 0;
+    node->count_ += next->count_;
+    next->count_ = 0;
+    Unlink(next);
+}
+
+/**
+ * The elements need no destructor calls, so every node can be returned to the pool in one shot
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::FreeNodes(std::true_type) {
+    node_allocator_.recycle();
+    head_ = nullptr;
+}
+
+/**
+ * Walk the list destroying and freeing nodes one at a time
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::FreeNodes(std::false_type) {
+    Node *runner = head_;
+    while (head_ != nullptr) {
+        head_ = head_->next_;
+        DeleteNode(runner);
+        runner = head_;
+    }
+}
+
+/**
+ * This constructor will create a list containing in order the elements from the value vector
+ * @param values vector contains data to be stored in the list
+ */
+template<typename ElementType, typename Allocator>
+UnrolledLinkedList<ElementType, Allocator>::UnrolledLinkedList(const std::vector<ElementType> &values)
+        : head_(nullptr), tail_(nullptr), size_(0), node_allocator_() {
+    for (const ElementType &value : values) {
+        push_back(value);
+    }
+}
+
+// Copy constructor
+/**
+ * This function will create a new list that is a deep copy of the source, with every node but the last full
+ * @param source list to be copied
+ */
+template<typename ElementType, typename Allocator>
+UnrolledLinkedList<ElementType, Allocator>::UnrolledLinkedList(const UnrolledLinkedList<ElementType, Allocator> &source)
+        : head_(nullptr), tail_(nullptr), size_(0),
+          node_allocator_(NodeTraits::select_on_container_copy_construction(source.node_allocator_)) {
+    for (Node *source_runner = source.head_; source_runner != nullptr; source_runner = source_runner->next_) {
+        for (int i = 0; i < source_runner->count_; i++) {
+            push_back(source_runner->data_[source_runner->begin_ + i]);
+        }
+    }
+}
+
+// Move constructor
+/**
+ * This function will make a new list using the already allocated nodes from the source
+ * @param source list to be moved from
+ */
+template<typename ElementType, typename Allocator>
+UnrolledLinkedList<ElementType, Allocator>::UnrolledLinkedList(UnrolledLinkedList<ElementType, Allocator> &&source) noexcept
+        : head_(source.head_), tail_(source.tail_), size_(source.size_),
+          node_allocator_(std::move(source.node_allocator_)) {
+    source.head_ = nullptr;
+    source.tail_ = nullptr;
+    source.size_ = 0;
+}
+
+// Destructor
+/**
+ * This destructor function will delete all the allocated data in the list.
+ */
+template<typename ElementType, typename Allocator>
+UnrolledLinkedList<ElementType, Allocator>::~UnrolledLinkedList() {
+    this->clear();
+}
+
+// Copy assignment operator
+/**
+ * Makes a deep copy of the source after freeing this list's nodes, assigning a list to itself does nothing
+ * @param source list to be copied from
+ * @return this list
+ */
+template<typename ElementType, typename Allocator>
+UnrolledLinkedList<ElementType, Allocator> &UnrolledLinkedList<ElementType, Allocator>::operator=(const UnrolledLinkedList<ElementType, Allocator> &source) {
+    if (this == &source) {
+        return *this;
+    }
+
+    this->clear();
+    for (Node *source_runner = source.head_; source_runner != nullptr; source_runner = source_runner->next_) {
+        for (int i = 0; i < source_runner->count_; i++) {
+            push_back(source_runner->data_[source_runner->begin_ + i]);
+        }
+    }
+
+    return *this;
+}
+
+// Move assignment operator
+/**
+ * Frees this list's nodes and takes over the source's, assigning a list to itself does nothing
+ * @param source list to be moved from
+ * @return this list
+ */
+template<typename ElementType, typename Allocator>
+UnrolledLinkedList<ElementType, Allocator> &UnrolledLinkedList<ElementType, Allocator>::operator=(UnrolledLinkedList<ElementType, Allocator> &&source) noexcept {
+    if (this == &source) {
+        return *this;
+    }
+
+    this->clear();
+    this->head_ = source.head_;
+    this->tail_ = source.tail_;
+    this->size_ = source.size_;
+    this->node_allocator_ = std::move(source.node_allocator_);
+    source.head_ = nullptr;
+    source.tail_ = nullptr;
+    source.size_ = 0;
+    return *this;
+}
+
+// Modifiers
+
+/**
+ * Add a new element at the front of the list. It goes in front of the first node's elements if there is room,
+ * otherwise in a new node that fills from its end so the following pushes land in it
+ * @param value data to be added
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::push_front(ElementType value) {
+    if (head_ == nullptr || head_->begin_ == 0) {
+        Node *node = NewNode(knode_elements_);
+        node->next_ = head_;
+        if (head_ == nullptr) {
+            tail_ = node;
+        } else {
+            head_->prev_ = node;
+        }
+        head_ = node;
+    }
+    head_->begin_--;
+    head_->data_[head_->begin_] = std::move(value);
+    head_->count_++;
+    size_++;
+}
+
+/**
+ * Add a new element at the back of the list, after the last node's elements if there is room, otherwise in a new node
+ * @param value data to be added
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::push_back(ElementType value) {
+    if (tail_ == nullptr || tail_->begin_ + tail_->count_ == knode_elements_) {
+        Node *node = NewNode(0);
+        node->prev_ = tail_;
+        if (tail_ == nullptr) {
+            head_ = node;
+        } else {
+            tail_->next_ = node;
+        }
+        tail_ = node;
+    }
+    tail_->data_[tail_->begin_ + tail_->count_] = std::move(value);
+    tail_->count_++;
+    size_++;
+}
+
+/**
+ * Return a copy of the first element of the list. This does not remove any items from the list.
+ * @return a copy of the first element, or the default ElementType if the list is empty
+ */
+template<typename ElementType, typename Allocator>
+ElementType UnrolledLinkedList<ElementType, Allocator>::front() const {
+    if (head_ == nullptr) {
+        return ElementType();
+    }
+    return head_->data_[head_->begin_];
+}
+
+/**
+ * Return a copy of the last element of the list. This does not remove any items from the list.
+ * @return a copy of the last element, or the default ElementType if the list is empty
+ */
+template<typename ElementType, typename Allocator>
+ElementType UnrolledLinkedList<ElementType, Allocator>::back() const {
+    if (tail_ == nullptr) {
+        return ElementType();
+    }
+    return tail_->data_[tail_->begin_ + tail_->count_ - 1];
+}
+
+/**
+ * Remove the front element, freeing its node once the node is empty. If the list is empty it will do nothing
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::pop_front() {
+    if (head_ == nullptr) {
+        return;
+    }
+
+    head_->data_[head_->begin_] = ElementType();
+    head_->begin_++;
+    head_->count_--;
+    if (head_->count_ == 0) {
+        Unlink(head_);
+    }
+    size_--;
+}
+
+/**
+ * Remove the back element, freeing its node once the node is empty. If the list is empty it will do nothing
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::pop_back() {
+    if (tail_ == nullptr) {
+        return;
+    }
+
+    tail_->count_--;
+    tail_->data_[tail_->begin_ + tail_->count_] = ElementType();
+    if (tail_->count_ == 0) {
+        Unlink(tail_);
+    }
+    size_--;
+}
+
+/**
+ * Return the number of elements in the list
+ * @return the number of elements in the list
+ */
+template<typename ElementType, typename Allocator>
+int UnrolledLinkedList<ElementType, Allocator>::size() const {
+    return size_;
+}
+
+/**
+ * Return a vector that contains all the elements in the list, copied a node at a time
+ * @return vector contains all the data in the list in order
+ */
+template<typename ElementType, typename Allocator>
+std::vector<ElementType> UnrolledLinkedList<ElementType, Allocator>::GetVector() const {
+    std::vector<ElementType> elements;
+    elements.reserve(size_);
+    for (Node *runner = head_; runner != nullptr; runner = runner->next_) {
+        elements.insert(elements.end(), runner->data_ + runner->begin_, runner->data_ + runner->begin_ + runner->count_);
+    }
+
+    return elements;
+}
+
+/**
+ * This function determines whether the list is empty
+ * @return true if the list is empty otherwise returns false
+ */
+template<typename ElementType, typename Allocator>
+bool UnrolledLinkedList<ElementType, Allocator>::empty() const {
+    return head_ == nullptr;
+}
+
+/**
+ * Delete all data in the list returning it to the same state as the default constructor
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::clear() {
+    if (head_ == nullptr) {
+        return;
+    }
+
+    FreeNodes(RecycleNodes());
+    tail_ = nullptr;
+    size_ = 0;
+}
+
+/**
+ * Print the elements stored in the list with a comma and a space separating each element
+ * @param os output stream
+ * @param list the list to print
+ * @return the output stream
+ */
+template<typename ElementType, typename Allocator>
+std::ostream &operator<<(std::ostream &os, const UnrolledLinkedList<ElementType, Allocator> &list) {
+    int printed = 0;
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        os << *it;
+        if (++printed < list.size()) {
+            os << ", ";
+        }
+    }
+
+    os << std::endl;
+    return os;
+}
+
+/**
+ * Remove the Nth element from the list. If the list does not contain a Nth element this function will do nothing.
+ * This function is zero indexed so RemoveNth(0) removes the head. The walk to the element skips whole nodes, and
+ * within its node the shorter side of the element is shifted over the gap
+ * @param n index of the element to be removed
+ */
+template<typename ElementType, typename Allocator>
+void UnrolledLinkedList<ElementType, Allocator>::RemoveNth(int n) {
+    if (n < 0 || n > size_ - 1) {
+        return;
+    }
+
+    if (n == 0) {
+        pop_front();
+        return;
+    }
+
+    if (n == size_ - 1) {
+        pop_back();
+        return;
+    }
+
+    // Walk in from whichever end is closer, index ends up as the position within node
+    Node *node;
+    int index;
+    if (n < size_ / 2) {
+        node = head_;
+        index = n;
+        while (index >= node->count_) {
+            index -= node->count_;
+            node = node->next_;
+        }
+    } else {
+        node = tail_;
+        index = size_ - 1 - n;
+        while (index >= node->count_) {
+            index -= node->count_;
+            node = node->prev_;
+        }
+        index = node->count_ - 1 - index;
+    }
+
+    ElementType *first = node->data_ + node->begin_;
+    if (index < node->count_ / 2) {
+        std::move_backward(first, first + index, first + index + 1);
+        *first = ElementType();
+        node->begin_++;
+    } else {
+        std::move(first + index + 1, first + node->count_, first + index);
+        first[node->count_ - 1] = ElementType();
+    }
+    node->count_--;
+    size_--;
+
+    if (node->count_ == 0) {
+        Unlink(node);
+    } else {
+        MergeNext(node);
+    }
+}
+
+/**
+ * Compare the lists element by element, walking both at once a run of elements at a time (as far as the nearer end
+ * of a node on either side) so neither list is copied
+ * @param rhs the right hand side of the operator
+ * @return true if they are all equal otherwise it will return false
+ */
+template<typename ElementType, typename Allocator>
+bool UnrolledLinkedList<ElementType, Allocator>::operator==(const UnrolledLinkedList<ElementType, Allocator> &rhs) const {
+    if (size_ != rhs.size_) {
+        return false;
+    }
+
+    Node *left = head_;
+    Node *right = rhs.head_;
+    int left_index = left == nullptr ? 0 : left->begin_;
+    int right_index = right == nullptr ? 0 : right->begin_;
+    while (left != nullptr) {
+        int left_end = left->begin_ + left->count_;
+        int right_end = right->begin_ + right->count_;
+        int run = std::min(left_end - left_index, right_end - right_index);
+        if (!std::equal(left->data_ + left_index, left->data_ + left_index + run, right->data_ + right_index)) {
+            return false;
+        }
+
+        left_index += run;
+        right_index += run;
+        if (left_index == left_end) {
+            left = left->next_;
+            left_index = left == nullptr ? 0 : left->begin_;
+        }
+        if (right_index == right_end) {
+            right = right->next_;
+            right_index = right == nullptr ? 0 : right->begin_;
+        }
+    }
+    return true;
+}
+
+/**
+ * This function will compare the list element by element
+ * @param lhs left hand side of the operator
+ * @param rhs right hand side of the operator
+ * @return false if they are all equal otherwise it will return true
+ */
+template<typename ElementType, typename Allocator>
+bool operator!=(const UnrolledLinkedList<ElementType, Allocator> &lhs, const UnrolledLinkedList<ElementType, Allocator> &rhs) {
+    return !(lhs == rhs);
+}
+
+/**
+ * define ++ for the iterator, moving on to the next node after the last element of a node
+ * @return next iterator
+ */
+template<typename ElementType, typename Allocator>
+typename UnrolledLinkedList<ElementType, Allocator>::Iterator &UnrolledLinkedList<ElementType, Allocator>::Iterator::operator++() {
+    if (current_) {
+        index_++;
+        if (index_ == current_->begin_ + current_->count_) {
+            current_ = current_->next_;
+            index_ = current_ == nullptr ? 0 : current_->begin_;
+        }
+    }
+    return *this;
+}
+
+/**
+ * define * for the iterator
+ * @return the element the iterator is on
+ */
+template<typename ElementType, typename Allocator>
+ElementType &UnrolledLinkedList<ElementType, Allocator>::Iterator::operator*() {
+    return current_->data_[index_];
+}
+
+/**
+ * define != for the iterator
+ * @param other the iterator to compare with
+ * @return true if not equal, false otherwise
+ */
+template<typename ElementType, typename Allocator>
+bool UnrolledLinkedList<ElementType, Allocator>::Iterator::operator!=(const UnrolledLinkedList<ElementType, Allocator>::Iterator &other) {
+    return current_ != other.current_ || index_ != other.index_;
+}
+
+/**
+ * start iterator
+ * @return the begin iterator
+ */
+template<typename ElementType, typename Allocator>
+typename UnrolledLinkedList<ElementType, Allocator>::Iterator UnrolledLinkedList<ElementType, Allocator>::begin() const {
+    Iterator start;
+    start.current_ = head_;
+    start.index_ = head_ == nullptr ? 0 : head_->begin_;
+    return start;
+}
+
+/**
+ * end iterator
+ * @return the end iterator
+ */
+template<typename ElementType, typename Allocator>
+typename UnrolledLinkedList<ElementType, Allocator>::Iterator UnrolledLinkedList<ElementType, Allocator>::end() const {
+    Iterator stop;
+    stop.current_ = nullptr;
+    stop.index_ = 0;
+    return stop;
+}
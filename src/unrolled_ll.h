@@ -0,0 +1,106 @@
+#ifndef UNROLLED_LL_H
+#define UNROLLED_LL_H
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "pool_allocator.h"
+
+namespace snakelinkedlist {
+
+// Unrolled linked list, a drop in for LinkedList with the same interface
+// Each node holds a cache line worth of elements (kblock_bytes) instead of one, so walking the list takes one pointer
+// hop and one cache miss per block rather than per element, and a node is allocated once per block of pushes.
+// Nodes come from Allocator (rebound to the node type) exactly like LinkedList, e.g.
+// UnrolledLinkedList<int, PoolAllocator<int>>
+template<typename ElementType, typename Allocator = std::allocator<ElementType>>
+class UnrolledLinkedList {
+public:
+    static const std::size_t kblock_bytes = 64;     // Bytes of elements per node, one cache line
+
+private:
+    static const int knode_elements_ = sizeof(ElementType) >= kblock_bytes
+            ? 1 : static_cast<int>(kblock_bytes / sizeof(ElementType));    // Elements that fit in a node
+
+    /**
+     * internal nodes, linked both ways so the back of the list can be removed without a walk.
+     * The elements in use are data_[begin_] to data_[begin_ + count_ - 1], so both ends of a node can grow and shrink
+     */
+    struct Node {
+        Node *next_;
+        Node *prev_;
+        int begin_;
+        int count_;
+        ElementType data_[knode_elements_];
+    };
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeTraits;
+
+    // Whether clear() can hand every node back to the allocator at once instead of one by one
+    typedef std::integral_constant<bool, CanRecycle<NodeAllocator>::value
+            && std::is_trivially_destructible<ElementType>::value> RecycleNodes;
+
+    Node *head_;    // first node, nullptr when empty
+    Node *tail_;    // last node, nullptr when empty
+    int size_;      // number of elements, kept up to date by every modifier so size() never walks the list
+    NodeAllocator node_allocator_;  // where nodes are allocated from
+
+    Node *NewNode(int begin);                   // allocate a detached empty node whose elements start at begin
+    void DeleteNode(Node *node);                // destroy and free a node that has been unlinked
+    void Unlink(Node *node);                    // take an empty node out of the list and free it
+    void MergeNext(Node *node);                 // move the next node's elements into node if they fit together
+    void FreeNodes(std::true_type);             // free every node in one shot through the allocator
+    void FreeNodes(std::false_type);            // free every node one at a time
+
+public:
+    UnrolledLinkedList();                                                   // Default constructor
+    explicit UnrolledLinkedList(const std::vector<ElementType> &values);   // Initilize from vector
+
+    // Big 5
+    UnrolledLinkedList(const UnrolledLinkedList& source);                   // Copy constructor
+    UnrolledLinkedList(UnrolledLinkedList&& source) noexcept;               // Move constructor
+    ~UnrolledLinkedList();                                                  // Destructor
+    UnrolledLinkedList& operator=(const UnrolledLinkedList& source);        // Copy assignment operator
+    UnrolledLinkedList& operator=(UnrolledLinkedList&& source) noexcept;    // Move assignment operator
+
+    void push_front(ElementType value);         // Push value on front
+    void push_back(ElementType value);          // Push value on back
+    ElementType front() const;                  // Access the front value
+    ElementType back() const;                   // Access the back value
+    void pop_front();                           // remove front element
+    void pop_back();                            // remove back element
+    int size() const;                           // return number of elements
+    std::vector<ElementType> GetVector() const; // return a vector of the values
+    bool empty() const;                         // check if empty
+    void clear();                               // clear the contents
+    void RemoveNth(int n);                      // remove the Nth element from the front 0 indexed
+    bool operator==(const UnrolledLinkedList &rhs) const;  // compares block by block without copying either list
+
+    // Iterator
+    class Iterator : std::iterator<std::forward_iterator_tag, ElementType> {
+        Node *current_;
+        int index_;     // position in current_->data_
+        friend UnrolledLinkedList;
+    public:
+        Iterator() : current_(nullptr), index_(0) {};
+        Iterator& operator++();
+        ElementType& operator*();
+        bool operator!=(const Iterator& other);
+    };
+
+    Iterator begin() const;
+    Iterator end() const;
+};
+
+template<typename ElementType, typename Allocator>
+std::ostream& operator<<(std::ostream& os, const UnrolledLinkedList<ElementType, Allocator>& list);
+
+// needed for template instantiation
+#include "unrolled_ll.cpp"
+
+} // namespace snakelinkedlist
+#endif //UNROLLED_LL_H
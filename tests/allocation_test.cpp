@@ -0,0 +1,56 @@
+#include <cstdint>
+#include <vector>
+#include "profiler.h"
+#include "simulation.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const long long kgame_ticks = 200000; // Ticks played, over many games restarted in place
+static const int kboard_width = 640;
+static const int kboard_height = 480;
+
+// Heads for the food along one axis at a time, so games last long enough for the snake to grow
+static SnakeDirection towardsFood(Cell head, Cell food) {
+	if (food.x != head.x) {
+		return food.x > head.x ? RIGHT : LEFT;
+	}
+	return food.y > head.y ? DOWN : UP;
+}
+
+/*
+One Simulation playing game after game and restarting in place, the way the app runs for weeks. The first pass
+warms up (the first game on a board reserves its memory), the second has to make no allocation at all in tick()
+or reset(). The tests are built with profiling compiled in, otherwise nothing would be counted
+*/
+static void steadyStateDoesNotAllocate() {
+	if (!SNAKE_CHECK(Profiler::enabled())) {
+		return;
+	}
+	Simulation game(kboard_width, kboard_height, 1);
+	for (int pass = 0; pass < 2; pass++) {
+		game.reset(1);
+		uint32_t next_seed = 2;
+		int games = 1;
+		uint64_t allocations = Profiler::getThreadAllocations();
+		for (long long t = 0; t < kgame_ticks; t++) {
+			game.queueTurn(towardsFood(game.getSnake().getHeadCell(), game.getFood().getCell()));
+			if (game.tick()) {
+				game.reset(next_seed++);
+				games++;
+			}
+		}
+		if (pass == 1) {
+			SNAKE_CHECK(Profiler::getThreadAllocations() - allocations == 0);
+			SNAKE_CHECK(games > 1); // Restarts have to be part of what was checked
+		}
+	}
+}
+
+void registerAllocationTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"allocation/steady_state", steadyStateDoesNotAllocate});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <vector>
+#include "autopilot.h"
+#include "batch_simulation.h"
+#include "random.h"
+#include "simulation.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int kgames = 4;
+static const int kwindow_width = 500; // kcolumns squares across, a square is 10 pixels
+static const int kcolumns = 50;
+static const int kwindow_height = 400; // A 50x40 board
+static const int kside_by_side_games = 16;
+static const int kticks = 3000; // Enough for most games to grow long and end
+static const int krandom_turn_odds = 32; // One turn in this many is random rather than the autopilot's, so games end
+
+// Whether game i of the batch is the Simulation down to every segment and the food
+static bool sameGame(const BatchSimulation& batch, int i, const Simulation& game) {
+	const RingBuffer<Cell>& body = game.getSnake().getBody();
+	if (batch.isAlive(i) != (game.getState() == IN_PROGRESS)) {
+		return false;
+	}
+	if (!batch.isAlive(i)) {
+		return true; // The games ended on the same tick, what is left of them no longer matters
+	}
+	if (!(batch.getHead(i) == game.getSnake().getHeadCell()) || batch.getLength(i) != static_cast<int>(body.size()) ||
+		batch.getScore(i) != game.getSnake().getFoodEaten() || batch.getDirection(i) != game.getSnake().getDirection() ||
+		!(batch.getFood(i) == game.getFood().getCell())) {
+		return false;
+	}
+	for (size_t segment = 0; segment < body.size(); segment++) {
+		if (!(batch.getSegment(i, static_cast<int>(segment)) == body[segment])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+Game i of a batch seeded s plays exactly like a Simulation seeded s + i given the same turns. Every game is steered
+by an autopilot with a random turn now and then, each turn given to both, and after every tick each game is
+compared in full with its Simulation: whether it is alive, head, length, score, direction, every segment and food
+*/
+static void matchesSimulation() {
+	const uint32_t seed = 7;
+	BatchSimulation batch(kside_by_side_games, kwindow_width, kwindow_height, seed);
+	std::vector<Simulation> games;
+	std::vector<Autopilot> autopilots(kside_by_side_games);
+	for (int i = 0; i < kside_by_side_games; i++) {
+		games.push_back(Simulation(kwindow_width, kwindow_height, seed + static_cast<uint32_t>(i)));
+	}
+	if (!SNAKE_CHECK(batch.getGameCount() == kside_by_side_games)) {
+		return;
+	}
+
+	Random random(1);
+	int longest = 0;
+	for (int tick = 0; tick < kticks && batch.getAliveCount() > 0; tick++) {
+		for (int i = 0; i < kside_by_side_games; i++) {
+			if (!batch.isAlive(i)) {
+				continue;
+			}
+			SnakeDirection turn = autopilots[i].plan(games[i]);
+			if (random.below(krandom_turn_odds) == 0) {
+				turn = static_cast<SnakeDirection>(random.below(4));
+			}
+			batch.queueTurn(i, turn);
+			games[i].queueTurn(turn);
+		}
+		batch.tick();
+		for (int i = 0; i < kside_by_side_games; i++) {
+			games[i].tick();
+			if (!SNAKE_CHECK(sameGame(batch, i, games[i]))) {
+				return;
+			}
+			longest = std::max(longest, batch.getLength(i));
+		}
+	}
+	SNAKE_CHECK(longest > 50); // The bodies and food placement were really exercised
+}
+
+/*
+The largest and smallest boards a batch plays on get every game, one row more or one row less gets none, and a
+batch with no games ticks without doing anything
+*/
+static void rejectsUnsupportedBoards() {
+	int largest_rows = BatchSimulation::kmax_squares / kcolumns;
+	int heights[4] = {largest_rows * 10, (largest_rows + 1) * 10, 30, 20};
+	int expected[4] = {kgames, 0, kgames, 0};
+	for (int i = 0; i < 4; i++) {
+		BatchSimulation batch(kgames, kwindow_width, heights[i], 1);
+		BoardSize board = boardForWindow(kwindow_width, heights[i]);
+		if (!SNAKE_CHECK(batch.getGameCount() == expected[i]) ||
+			!SNAKE_CHECK(BatchSimulation::fitsBoard(board) == (expected[i] > 0)) ||
+			!SNAKE_CHECK(batch.getAliveCount() == expected[i])) {
+			return;
+		}
+		for (int t = 0; t < 10; t++) {
+			batch.tick();
+		}
+		if (expected[i] > 0 && !SNAKE_CHECK(batch.getHead(0).y == 2)) {
+			return;
+		}
+	}
+}
+
+void registerBatchTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"batch/rejects_unsupported_boards", rejectsUnsupportedBoards});
+	tests.push_back(Test{"batch/matches_simulation", matchesSimulation});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
@@ -0,0 +1,120 @@
+#include <vector>
+#include "board.h"
+#include "random.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int kboards = 200; // Random boards per size
+static const int kfills = 20; // Flood fills per board
+static const int kfill_percent = 30; // Share of the squares taken
+static const int kmax_release = 40; // Taken squares free up after 1 to this many steps in the releasing fill
+
+/*
+Breadth first search that counts the squares a fill from start reaches, stopping once limit squares are reached.
+A square can be entered from the step release[square] on (0 when it is empty, never when it is -1), and only from
+a square the step before reached, the way the releasing Board::reachableArea() is meant to work
+*/
+static int searchArea(BoardSize board, const std::vector<int>& release, Cell start, int limit) {
+	auto enterable = [&](Cell cell, int steps) {
+		if (cell.x < 0 || cell.y < 0 || cell.x >= board.columns || cell.y >= board.rows) {
+			return false;
+		}
+		int square = release[cell.y * board.columns + cell.x];
+		return square >= 0 && square <= steps;
+	};
+	if (!enterable(start, 0)) {
+		return 0;
+	}
+	std::vector<bool> reached(release.size(), false);
+	std::vector<Cell> last = {start};
+	reached[start.y * board.columns + start.x] = true;
+	int area = 1;
+	for (int steps = 1; area < limit && !last.empty(); steps++) {
+		std::vector<Cell> added;
+		for (Cell cell : last) {
+			for (int direction = 0; direction < 4; direction++) {
+				Cell next = neighbour(cell, static_cast<SnakeDirection>(direction));
+				if (enterable(next, steps) && !reached[next.y * board.columns + next.x]) {
+					reached[next.y * board.columns + next.x] = true;
+					added.push_back(next);
+				}
+			}
+		}
+		area += static_cast<int>(added.size());
+		last = added;
+	}
+	return area < limit ? area : limit;
+}
+
+/*
+Random boards of one size: every fill, static or releasing, from a random square (taken ones too) with a random
+limit, has to agree with searchArea(). Static fills see every taken square as taken for good (release -1)
+*/
+template<typename BoardType>
+static void compareFills(BoardType& board, Random& random) {
+	BoardSize size = {board.getColumns(), board.getRows()};
+	int squares = size.columns * size.rows;
+	for (int b = 0; b < kboards; b++) {
+		std::vector<int> release(squares, 0); // 0 empty, otherwise the step the square frees up on
+		for (int i = 0; i < squares; i++) {
+			if (random.below(100) < kfill_percent) {
+				release[i] = 1 + random.below(kmax_release);
+			}
+		}
+		std::vector<int> forever(release);
+		for (int& square : forever) {
+			square = square > 0 ? -1 : 0;
+		}
+
+		for (int f = 0; f < kfills; f++) {
+			Cell start = {random.below(size.columns), random.below(size.rows)};
+			int limit = 1 + random.below(squares);
+
+			board.clearAll();
+			for (int i = 0; i < squares; i++) {
+				if (release[i] > 0) {
+					board.set(Cell{i % size.columns, i / size.columns});
+				}
+			}
+			if (!SNAKE_CHECK(board.reachableArea(start) == searchArea(size, forever, start, squares)) ||
+				!SNAKE_CHECK(board.reachableArea(start, limit) == searchArea(size, forever, start, limit))) {
+				return;
+			}
+
+			int area = board.reachableArea(start, limit, [&](int steps) {
+				for (int i = 0; i < squares; i++) {
+					if (release[i] == steps) {
+						board.clear(Cell{i % size.columns, i / size.columns});
+					}
+				}
+			});
+			if (!SNAKE_CHECK(area == searchArea(size, release, start, limit))) {
+				return;
+			}
+		}
+	}
+}
+
+// The tournament sizes, which get their own Board types, and runtime sized boards whose rows don't fill whole words
+static void fillsMatchSearch() {
+	Random random(4);
+	Board<16, 16> board16;
+	compareFills(board16, random);
+	Board<32, 32> board32;
+	compareFills(board32, random);
+	Board<64, 64> board64;
+	compareFills(board64, random);
+	RuntimeBoard app(BoardSize{50, 40});
+	compareFills(app, random);
+	RuntimeBoard odd(BoardSize{7, 5});
+	compareFills(odd, random);
+}
+
+void registerBoardTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"board/fills_match_search", fillsMatchSearch});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <vector>
+#include "body_mesh.h"
+#include "random.h"
+#include "snake.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const BoardSize kboard = {20, 15};
+static const int kgames = 50;
+static const int kmax_ticks = 2000;
+static const int kfood_interval = 5; // The snake eats every this many ticks
+
+/*
+What the GPU would hold: the renderer uploads both buffers whole when the mesh asks for it and otherwise only the
+dirty quads and color entries, then clears them
+*/
+struct UploadedMesh {
+	std::vector<float> vertices;
+	std::vector<float> colors;
+	size_t uploaded_slots = 0; // Quads uploaded by the last upload() that wasn't a full one
+	size_t uploaded_colors = 0;
+
+	void upload(BodyMesh& mesh) {
+		const size_t quad_floats = BodyMesh::kvertices_per_quad * BodyMesh::kfloats_per_vertex;
+		const size_t color_floats = BodyMesh::kvertices_per_quad * BodyMesh::kfloats_per_color;
+		uploaded_slots = uploaded_colors = 0;
+		if (mesh.needsFullUpload()) {
+			vertices = mesh.getVertices();
+			colors = mesh.getColors();
+		} else {
+			for (size_t slot : mesh.getDirtySlots()) {
+				std::copy(mesh.getVertices().begin() + slot * quad_floats,
+					mesh.getVertices().begin() + (slot + 1) * quad_floats, vertices.begin() + slot * quad_floats);
+			}
+			for (size_t entry : mesh.getDirtyColors()) {
+				std::copy(mesh.getColors().begin() + entry * color_floats,
+					mesh.getColors().begin() + (entry + 1) * color_floats, colors.begin() + entry * color_floats);
+			}
+			uploaded_slots = mesh.getDirtySlots().size();
+			uploaded_colors = mesh.getDirtyColors().size();
+		}
+		mesh.clearDirty();
+	}
+};
+
+// Turns now and then onto a free square, so games last and the body winds around the board
+static void steer(Snake& snake, Random& random) {
+	if (random.below(4) != 0) {
+		Cell ahead = neighbour(snake.getHeadCell(), snake.getDirection());
+		if (snake.getOccupancy().inBounds(ahead) && snake.getOccupancy().count(ahead) == 0) {
+			return;
+		}
+	}
+	for (int i = 0; i < 4; i++) {
+		SnakeDirection direction = static_cast<SnakeDirection>((random.below(4) + i) % 4);
+		Cell next = neighbour(snake.getHeadCell(), direction);
+		if (direction != kopposite[snake.getDirection()] && snake.getOccupancy().inBounds(next) &&
+			snake.getOccupancy().count(next) == 0) {
+			snake.setDirection(direction);
+			return;
+		}
+	}
+}
+
+/*
+After a sync at alpha 1 and an upload, what the GPU draws is the body: at most two ranges covering the body and the
+vacated tail slot from the head's slot on, each body slot's quad on its segment's square and, through the color
+offset, in its segment's color. The uploads have to leave the GPU copy equal to the mesh
+*/
+static bool checkDrawn(const Snake& snake, const BodyMesh& mesh, const UploadedMesh& gpu) {
+	const RingBuffer<Cell>& body = snake.getBody();
+	const std::vector<Color>& colors = snake.getBodyColors();
+	if (!SNAKE_CHECK(gpu.vertices == mesh.getVertices()) || !SNAKE_CHECK(gpu.colors == mesh.getColors()) ||
+		!SNAKE_CHECK(mesh.getDrawRangeCount() >= 1 && mesh.getDrawRangeCount() <= 2)) {
+		return false;
+	}
+	size_t drawn = 0;
+	for (size_t i = 0; i < mesh.getDrawRangeCount(); i++) {
+		drawn += mesh.getDrawRange(i).count;
+	}
+	if (!SNAKE_CHECK(mesh.getDrawRange(0).first == body.slotOf(0)) || !SNAKE_CHECK(drawn == body.size() + 1)) {
+		return false;
+	}
+
+	const size_t quad_floats = BodyMesh::kvertices_per_quad * BodyMesh::kfloats_per_vertex;
+	const size_t color_floats = BodyMesh::kvertices_per_quad * BodyMesh::kfloats_per_color;
+	for (size_t i = 0; i < body.size(); i++) {
+		size_t slot = body.slotOf(i);
+		const float* quad = &gpu.vertices[slot * quad_floats];
+		const float* color = &gpu.colors[(slot + mesh.getColorOffset()) * color_floats];
+		if (!SNAKE_CHECK(quad[0] == body[i].x && quad[1] == body[i].y) ||
+			!SNAKE_CHECK(color[0] == colors[i].r / 255.0f && color[1] == colors[i].g / 255.0f &&
+				color[2] == colors[i].b / 255.0f)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+Seeded random games synced twice a tick (half way and at the end), as the renderer does between ticks. A tick the
+snake neither ate nor started over on uploads only the head, the square behind it and the vacated tail, and no colors
+*/
+static void uploadsMatchBody() {
+	Random random(5);
+	Snake snake(kboard);
+	BodyMesh mesh;
+	UploadedMesh gpu;
+	int full_uploads = 0;
+	int wrapped = 0;
+	for (int game = 0; game < kgames; game++) {
+		snake.reset(kboard);
+		for (int tick = 0; tick < kmax_ticks && !snake.isDead(); tick++) {
+			steer(snake, random);
+			bool eats = tick % kfood_interval == 0;
+			if (eats) {
+				snake.eatFood(Color(random.below(256), random.below(256), random.below(256)));
+			}
+			snake.update();
+			mesh.sync(snake, 0.5f);
+			bool full = mesh.needsFullUpload();
+			full_uploads += full;
+			gpu.upload(mesh);
+			if (!full && !eats && tick > 0) {
+				if (!SNAKE_CHECK(gpu.uploaded_slots <= 3) || !SNAKE_CHECK(gpu.uploaded_colors == 0)) {
+					return;
+				}
+			}
+			mesh.sync(snake, 1.0f);
+			gpu.upload(mesh);
+			if (!SNAKE_CHECK(gpu.uploaded_slots <= 2) || !checkDrawn(snake, mesh, gpu)) {
+				return;
+			}
+			wrapped += mesh.getDrawRangeCount() == 2;
+		}
+	}
+	// Every game starts with a full upload, and the ring has to have wrapped for the two ranges to be tested
+	SNAKE_CHECK(full_uploads >= kgames);
+	SNAKE_CHECK(wrapped > 0);
+}
+
+void registerBodyMeshTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"body_mesh/uploads_match_body", uploadsMatchBody});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
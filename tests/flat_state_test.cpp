@@ -0,0 +1,154 @@
+#include <vector>
+#include "autopilot.h"
+#include "binary_io.h"
+#include "flat_state.h"
+#include "simulation.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int kwindow_width = 1000; // A 50x40 board
+static const int kwindow_height = 800;
+static const int kticks = 300; // Long enough for the snake to eat a few times
+
+// A game the autopilot has played for a while, so the snake has grown and the board is partly covered
+static Simulation playedGame(uint32_t seed) {
+	Simulation game(kwindow_width, kwindow_height, seed);
+	Autopilot autopilot;
+	for (int tick = 0; tick < kticks && game.getState() == IN_PROGRESS; tick++) {
+		game.queueTurn(autopilot.plan(game));
+		game.tick();
+	}
+	return game;
+}
+
+static std::vector<uint8_t> flatSaveOf(const Simulation& game) {
+	FlatWriter out;
+	game.writeFlat(out);
+	std::vector<uint8_t> bytes;
+	out.copyTo(bytes);
+	return bytes;
+}
+
+static std::vector<uint8_t> stateOf(const Simulation& game) {
+	std::vector<uint8_t> bytes;
+	BinaryWriter out(bytes);
+	game.writeState(out);
+	return bytes;
+}
+
+// Writable pointer to a section of a save, for damaging it
+template<typename T>
+static T* sectionOf(std::vector<uint8_t>& bytes, const FlatSection& section) {
+	return reinterpret_cast<T*>(bytes.data() + section.offset);
+}
+
+// An intact save restores the game exactly, down to the order food is drawn from the empty squares
+static void restoresGame() {
+	Simulation saved = playedGame(1);
+	std::vector<uint8_t> bytes = flatSaveOf(saved);
+	FlatGameView view;
+	SNAKE_CHECK(view.view(bytes.data(), bytes.size()));
+	SNAKE_CHECK(view.validate());
+
+	Simulation game(kwindow_width, kwindow_height, 2);
+	game.readFlat(view);
+	SNAKE_CHECK(stateOf(game) == stateOf(saved));
+
+	// writeState() doesn't save the grid, it rebuilds it from the body, so the counts are compared here
+	const OccupancyGrid& restored = game.getSnake().getOccupancy();
+	const OccupancyGrid& original = saved.getSnake().getOccupancy();
+	for (int y = 0; y < original.getRows(); y++) {
+		for (int x = 0; x < original.getColumns(); x++) {
+			SNAKE_CHECK(restored.count(Cell{x, y}) == original.count(Cell{x, y}));
+		}
+	}
+	SNAKE_CHECK(restored.getFreeCount() == original.getFreeCount());
+	for (int i = 0; i < original.getFreeCount() && i < restored.getFreeCount(); i++) {
+		SNAKE_CHECK(restored.getFree(i) == original.getFree(i));
+	}
+}
+
+/*
+A game that ended by running into a wall is FINISHED with its head off the board, and its save restores like any other.
+The same head off the board in a game still in progress is damage
+*/
+static void restoresGameEndedAtWall() {
+	Simulation saved(kwindow_width, kwindow_height, 4);
+	for (int tick = 0; tick < kticks && saved.getState() == IN_PROGRESS; tick++) {
+		saved.tick(); // The snake starts moving right and never turns
+	}
+	Cell head = saved.getSnake().getHeadCell();
+	if (!SNAKE_CHECK(saved.getState() == FINISHED) || !SNAKE_CHECK(!saved.getSnake().getOccupancy().inBounds(head))) {
+		return;
+	}
+	std::vector<uint8_t> bytes = flatSaveOf(saved);
+	FlatGameView view;
+	SNAKE_CHECK(view.view(bytes.data(), bytes.size()));
+	SNAKE_CHECK(view.validate());
+	Simulation game(kwindow_width, kwindow_height, 5);
+	game.readFlat(view);
+	SNAKE_CHECK(stateOf(game) == stateOf(saved));
+	SNAKE_CHECK(game.getSnake().getOccupancy().getFreeCount() == saved.getSnake().getOccupancy().getFreeCount());
+
+	reinterpret_cast<FlatGameHeader*>(bytes.data())->state = IN_PROGRESS;
+	SNAKE_CHECK(view.view(bytes.data(), bytes.size()));
+	SNAKE_CHECK(!view.validate());
+}
+
+// Saves whose header checks out but whose body, segment counts and empty squares disagree: validate() rejects each
+static void rejectsDamagedSave() {
+	Simulation saved = playedGame(1);
+	const std::vector<uint8_t> intact = flatSaveOf(saved);
+	const FlatGameHeader& header = *reinterpret_cast<const FlatGameHeader*>(intact.data());
+	if (!SNAKE_CHECK(header.body_length > 1 && header.free_count > 1)) {
+		return;
+	}
+	int columns = header.columns;
+
+	std::vector<std::vector<uint8_t>> damaged;
+	// A body square off the board, to the left and below
+	damaged.push_back(intact);
+	sectionOf<Cell>(damaged.back(), header.body)[1].x = -1;
+	damaged.push_back(intact);
+	sectionOf<Cell>(damaged.back(), header.body)[header.body_length - 1].y = header.rows;
+	// An empty square off the board
+	damaged.push_back(intact);
+	sectionOf<int32_t>(damaged.back(), header.free_squares)[0] = columns * header.rows;
+	// An empty square listed twice, so another is missing
+	damaged.push_back(intact);
+	int32_t* free_squares = sectionOf<int32_t>(damaged.back(), header.free_squares);
+	free_squares[1] = free_squares[0];
+	// A body square listed as empty
+	damaged.push_back(intact);
+	Cell head = sectionOf<Cell>(damaged.back(), header.body)[0];
+	sectionOf<int32_t>(damaged.back(), header.free_squares)[0] = head.y * columns + head.x;
+	// A body square moved onto another, so the square it left is neither covered nor listed as empty
+	damaged.push_back(intact);
+	Cell* body = sectionOf<Cell>(damaged.back(), header.body);
+	body[header.body_length - 1] = body[0];
+	// A segment count the body doesn't make, on an empty square and on the head's
+	damaged.push_back(intact);
+	int32_t empty = sectionOf<int32_t>(damaged.back(), header.free_squares)[0];
+	sectionOf<uint16_t>(damaged.back(), header.counts)[empty] = 1;
+	damaged.push_back(intact);
+	sectionOf<uint16_t>(damaged.back(), header.counts)[head.y * columns + head.x]++;
+
+	for (std::vector<uint8_t>& bytes : damaged) {
+		FlatGameView view;
+		SNAKE_CHECK(view.view(bytes.data(), bytes.size()));
+		SNAKE_CHECK(!view.validate());
+	}
+	FlatGameView view;
+	SNAKE_CHECK(view.view(intact.data(), intact.size()) && view.validate());
+}
+
+void registerFlatStateTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"flat_state/restores_game", restoresGame});
+	tests.push_back(Test{"flat_state/rejects_damaged_save", rejectsDamagedSave});
+	tests.push_back(Test{"flat_state/restores_game_ended_at_wall", restoresGameEndedAtWall});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
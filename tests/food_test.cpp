@@ -0,0 +1,107 @@
+#include <cstdint>
+#include <vector>
+#include "autopilot.h"
+#include "occupancy_grid.h"
+#include "random.h"
+#include "simulation.h"
+#include "SnakeFood.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int kwindow_width = 500; // A 50x20 board, small enough for the autopilot to fill much of it
+static const int kwindow_height = 200;
+static const int kgames = 30;
+static const long long kmax_ticks = 50000;
+static const int kgrid_columns = 12;
+static const int kgrid_rows = 10;
+static const int kpicks_per_square = 200; // Rebases per empty square, each square is picked this often on average
+
+/*
+Autopilot games fill the board far more than random ones, so the food is placed with few empty squares left too.
+The food has to sit on an empty square except when the head has just reached it, and where it was eaten the new
+food can't be on the snake, not even on the square the head just entered
+*/
+static void neverOnSnake() {
+	int rebases = 0;
+	for (int g = 0; g < kgames; g++) {
+		Simulation game(kwindow_width, kwindow_height, static_cast<uint32_t>(g + 1));
+		Autopilot autopilot;
+		for (long long t = 0; t < kmax_ticks && game.getState() == IN_PROGRESS; t++) {
+			Cell food = game.getFood().getCell();
+			bool eats = game.getSnake().getHeadCell() == food;
+			game.queueTurn(autopilot.plan(game));
+			game.tick();
+
+			const Snake& snake = game.getSnake();
+			Cell now = game.getFood().getCell();
+			if (eats && snake.getOccupancy().getFreeCount() > 0) {
+				rebases++;
+				if (!SNAKE_CHECK(snake.getOccupancy().count(now) == 0)) {
+					return;
+				}
+			} else if (!SNAKE_CHECK(snake.getOccupancy().count(now) == 0 || now == snake.getHeadCell())) {
+				return;
+			}
+		}
+	}
+	SNAKE_CHECK(rebases > kgames * 100); // The games have to have eaten enough to mean something
+}
+
+/*
+Covers a grid at random (some squares twice), then rebases the food many times: it may only land on empty squares
+and every empty square has to come up about as often as the others. The cover is then changed, which reorders the
+empty squares, and checked again
+*/
+static void picksEveryFreeSquare() {
+	Random random(12);
+	OccupancyGrid occupancy;
+	occupancy.reset(kgrid_columns, kgrid_rows);
+	std::vector<Cell> covered;
+	SnakeFood food(occupancy, 13);
+	for (int round = 0; round < 4; round++) {
+		for (int i = 0; i < kgrid_columns * kgrid_rows / 3; i++) {
+			Cell cell = Cell{random.below(kgrid_columns), random.below(kgrid_rows)};
+			occupancy.add(cell);
+			covered.push_back(cell);
+		}
+		for (int i = 0; i < kgrid_columns * kgrid_rows / 6 && !covered.empty(); i++) {
+			int j = random.below(static_cast<int>(covered.size()));
+			occupancy.remove(covered[j]);
+			covered[j] = covered.back();
+			covered.pop_back();
+		}
+
+		int free_count = occupancy.getFreeCount();
+		if (!SNAKE_CHECK(free_count > 0)) {
+			return;
+		}
+		std::vector<int> picks(kgrid_columns * kgrid_rows, 0);
+		for (int i = 0; i < free_count * kpicks_per_square; i++) {
+			food.rebase(occupancy);
+			Cell cell = food.getCell();
+			if (!SNAKE_CHECK(occupancy.inBounds(cell)) || !SNAKE_CHECK(occupancy.count(cell) == 0)) {
+				return;
+			}
+			picks[cell.y * kgrid_columns + cell.x]++;
+		}
+		for (int y = 0; y < kgrid_rows; y++) {
+			for (int x = 0; x < kgrid_columns; x++) {
+				int count = picks[y * kgrid_columns + x];
+				bool free = occupancy.count(Cell{x, y}) == 0;
+				if (!SNAKE_CHECK(free ? (count > kpicks_per_square / 2 && count < kpicks_per_square * 2) : count == 0)) {
+					return;
+				}
+			}
+		}
+	}
+}
+
+void registerFoodTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"food/never_on_snake", neverOnSnake});
+	tests.push_back(Test{"food/picks_every_free_square", picksEveryFreeSquare});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
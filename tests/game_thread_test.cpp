@@ -0,0 +1,133 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "game_thread.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int kboard_width = 640;
+static const int kboard_height = 480;
+static const double kticks_per_second = 1000;
+static const int kposts_per_round = 64; // Commands posted between looking at the snapshot, enough to fill the queue
+static const std::chrono::milliseconds kload_run(200); // How long the input is hammered
+static const std::chrono::milliseconds kmax_wait(2000); // Longest to wait for the thread to catch up before failing
+// A tick can be due up to the FixedTimestep catch up of 4 ticks before it runs, plus the OS sleep granularity. The
+// worst tick is allowed far more, for a loaded machine preempting the thread, but not an unbounded backlog
+static const double kmax_mean_lateness_us = 5000;
+static const double kmax_lateness_us = 100000;
+
+static SnakeDirection towardsFood(Cell head, Cell food) {
+	if (food.x != head.x) {
+		return food.x > head.x ? RIGHT : LEFT;
+	}
+	return food.y > head.y ? DOWN : UP;
+}
+
+/*
+The window thread floods the game with turns, resizes and restarts while it plays at 1000 ticks per second. Every
+command post() accepted has to be applied: each resize comes back as a WINDOW_RESIZED event with the size that was
+sent, in order, and each restart as a GAME_STARTED event. A command post() refused is sent again. Ticks have to keep
+running on time meanwhile
+*/
+static void inputUnderLoad() {
+	GameThread game(kboard_width, kboard_height, kticks_per_second);
+	uint32_t seed = 1;
+	game.start(seed);
+
+	int resizes_posted = 0; // The nth resize is to a window kboard_height + n pixels high
+	int resizes_seen = 0;
+	int restarts_posted = 0;
+	int restarts_seen = -1; // start() sends a GAME_STARTED too
+	bool ordered = true;
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + kload_run;
+	std::chrono::steady_clock::time_point give_up = end + kmax_wait;
+	while (std::chrono::steady_clock::now() < give_up) {
+		GameEvent event;
+		while (game.pollEvent(event)) {
+			if (event.kind == WINDOW_RESIZED) {
+				ordered = ordered && event.width == kboard_width && event.height == kboard_height + resizes_seen;
+				resizes_seen++;
+			} else if (event.kind == GAME_STARTED) {
+				restarts_seen++;
+			}
+		}
+		bool loading = std::chrono::steady_clock::now() < end;
+		if (!loading && resizes_seen == resizes_posted && restarts_seen == restarts_posted) {
+			break;
+		}
+		if (!loading) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		game.updateSnapshot();
+		const Simulation& snapshot = game.getSnapshot().game;
+		GameCommand turn = {QUEUE_TURN, towardsFood(snapshot.getSnake().getHeadCell(), snapshot.getFood().getCell()), 0, 0, 0};
+		bool restart = snapshot.getState() == FINISHED;
+		for (int i = 0; i < kposts_per_round; i++) {
+			GameCommand command = turn;
+			if (restart) {
+				command = GameCommand{RESET_GAME, RIGHT, seed + 1, 0, 0};
+			} else if (i % 2 == 1) {
+				command = GameCommand{RESIZE_WINDOW, RIGHT, 0, kboard_width, kboard_height + resizes_posted};
+			}
+			if (!game.post(command)) {
+				std::this_thread::yield();
+				break;
+			}
+			resizes_posted += command.kind == RESIZE_WINDOW ? 1 : 0;
+			if (restart) {
+				seed++;
+				restarts_posted++;
+				restart = false;
+			}
+		}
+	}
+	game.stop();
+
+	SNAKE_CHECK(resizes_posted > 0);
+	SNAKE_CHECK(ordered);
+	SNAKE_CHECK(resizes_seen == resizes_posted);
+	SNAKE_CHECK(restarts_seen == restarts_posted);
+	TickStats stats = game.getTickStats();
+	SNAKE_CHECK(stats.ticks > 0);
+	SNAKE_CHECK(stats.mean_lateness_us >= 0 && stats.mean_lateness_us < kmax_mean_lateness_us);
+	SNAKE_CHECK(stats.max_lateness_us < kmax_lateness_us);
+}
+
+// Steps that come due after the game is over run nothing, so the ticks counted stop where the game did
+static void countsOnlyTicksRun() {
+	GameThread game(kboard_width, kboard_height, kticks_per_second);
+	game.start(1);
+	long long finished_tick = -1;
+	std::chrono::steady_clock::time_point give_up = std::chrono::steady_clock::now() + kmax_wait;
+	while (finished_tick < 0 && std::chrono::steady_clock::now() < give_up) {
+		GameEvent event;
+		while (game.pollEvent(event)) {
+			if (event.kind == GAME_FINISHED) {
+				finished_tick = event.tick; // The snake starts moving right and runs into the wall
+			}
+		}
+		std::this_thread::yield();
+	}
+	if (!SNAKE_CHECK(finished_tick > 0)) {
+		return;
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(50)); // About 50 more steps come due
+	game.stop();
+
+	TickStats stats = game.getTickStats();
+	SNAKE_CHECK(stats.ticks == finished_tick);
+	SNAKE_CHECK(stats.mean_lateness_us >= 0 && stats.mean_lateness_us < kmax_mean_lateness_us);
+	SNAKE_CHECK(stats.max_lateness_us < kmax_lateness_us);
+}
+
+void registerGameThreadTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"game_thread/input_under_load", inputUnderLoad});
+	tests.push_back(Test{"game_thread/counts_only_ticks_run", countsOnlyTicksRun});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
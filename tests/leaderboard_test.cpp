@@ -0,0 +1,128 @@
+#include <climits>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "binary_io.h"
+#include "leaderboard.h"
+#include "random.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int kgames = 200;
+static const char* klog_path = "snake_test_leaderboard.log"; // In the working directory, removed when the test ends
+
+// Removes the log when the test ends, however it ends
+struct TemporaryLog {
+	TemporaryLog() { std::remove(klog_path); }
+	~TemporaryLog() { std::remove(klog_path); }
+};
+
+static long long fileSize() {
+	std::FILE* file = std::fopen(klog_path, "rb");
+	if (file == nullptr) {
+		return -1;
+	}
+	std::fseek(file, 0, SEEK_END);
+	long long size = std::ftell(file);
+	std::fclose(file);
+	return size;
+}
+
+// Appends bytes to the log the way a crash or a damaged disk would leave them
+static void append(const std::vector<uint8_t>& bytes) {
+	std::FILE* file = std::fopen(klog_path, "ab");
+	std::fwrite(bytes.data(), 1, bytes.size(), file);
+	std::fclose(file);
+}
+
+// A record as add() writes it, with any score
+static std::vector<uint8_t> record(int32_t score, const std::string& player) {
+	std::vector<uint8_t> bytes;
+	BinaryWriter out(bytes);
+	out.write(score);
+	out.write(static_cast<uint32_t>(1));
+	out.write(static_cast<int64_t>(2));
+	out.write(static_cast<int64_t>(3));
+	out.write(static_cast<uint8_t>(player.size()));
+	out.writeBytes(player.data(), player.size());
+	return bytes;
+}
+
+static bool sameTop(const std::vector<ScoreEntry>& a, const std::vector<ScoreEntry>& b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); i++) {
+		if (a[i].score != b[i].score || a[i].player != b[i].player || a[i].seed != b[i].seed) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+A log of random games with each kind of bad tail added in turn: a record cut short, a record with a negative score
+and one with a score no game can reach, each followed by a good record that comes too late to count. Every time the
+log has to open with the games from before the tail ranked as they were, be cut back to them, and take new games
+after them
+*/
+static void survivesBadTails() {
+	TemporaryLog log;
+	Random random(14);
+	std::vector<ScoreEntry> top;
+	long long valid_size = 0;
+	{
+		Leaderboard leaderboard;
+		if (!SNAKE_CHECK(leaderboard.open(klog_path))) {
+			return;
+		}
+		for (int i = 0; i < kgames; i++) {
+			ScoreEntry entry;
+			entry.score = random.below(500);
+			entry.player = "player" + std::to_string(random.below(10));
+			entry.seed = static_cast<uint32_t>(i);
+			leaderboard.add(entry);
+		}
+		top = leaderboard.getTop(kgames);
+	}
+	valid_size = fileSize();
+
+	std::vector<uint8_t> torn = record(7, "torn");
+	torn.resize(torn.size() - 3);
+	std::vector<std::vector<uint8_t>> tails = {torn, record(-5, "negative"), record(INT_MAX, "huge"),
+		record(Leaderboard::kmax_score + 1, "too_high")};
+	for (size_t i = 0; i < tails.size(); i++) {
+		append(tails[i]);
+		if (i > 0) {
+			append(record(9, "late"));
+		}
+		Leaderboard leaderboard;
+		if (!SNAKE_CHECK(leaderboard.open(klog_path)) || !SNAKE_CHECK(leaderboard.size() == static_cast<size_t>(kgames)) ||
+			!SNAKE_CHECK(sameTop(leaderboard.getTop(kgames), top)) || !SNAKE_CHECK(fileSize() == valid_size)) {
+			return;
+		}
+	}
+
+	{
+		Leaderboard leaderboard;
+		leaderboard.open(klog_path);
+		ScoreEntry entry;
+		entry.score = INT_MAX; // Clamped rather than sizing the indexes for it
+		entry.player = "cheater";
+		SNAKE_CHECK(leaderboard.add(entry));
+		SNAKE_CHECK(leaderboard.getTop(1)[0].score == Leaderboard::kmax_score);
+	}
+	Leaderboard leaderboard;
+	SNAKE_CHECK(leaderboard.open(klog_path));
+	SNAKE_CHECK(leaderboard.size() == static_cast<size_t>(kgames) + 1);
+	SNAKE_CHECK(leaderboard.getTop(1)[0].player == "cheater");
+}
+
+void registerLeaderboardTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"leaderboard/survives_bad_tails", survivesBadTails});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
@@ -0,0 +1,105 @@
+#include <iterator>
+#include <list>
+#include <vector>
+#include "pool_allocator.h"
+#include "random.h"
+#include "ref_ll.h"
+#include "test.h"
+#include "unrolled_ll.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int koperations = 200000; // Random operations per list type
+static const int kmax_size = 300; // Lists grow towards this size and then shrink, so both ends of RemoveNth get tested
+
+// Everything the list reports about its contents has to match the std::list
+template<typename List>
+static bool sameContents(List& list, const std::list<int>& expected) {
+	std::vector<int> values(expected.begin(), expected.end());
+	std::vector<int> iterated;
+	for (typename List::Iterator it = list.begin(); it != list.end(); ++it) {
+		iterated.push_back(*it);
+	}
+	return SNAKE_CHECK(list.size() == static_cast<int>(expected.size())) &&
+		SNAKE_CHECK(list.empty() == expected.empty()) &&
+		SNAKE_CHECK(list.front() == (expected.empty() ? 0 : expected.front())) &&
+		SNAKE_CHECK(list.back() == (expected.empty() ? 0 : expected.back())) &&
+		SNAKE_CHECK(list.GetVector() == values) &&
+		SNAKE_CHECK(iterated == values);
+}
+
+/*
+Seeded random pushes, pops and RemoveNth() calls on both ends, applied to the list and a std::list, with the contents
+compared after every one. Pops on an empty list and RemoveNth() out of range must do nothing, like the std::list
+calls are skipped. Now and then the list is cleared, copied or moved, and the copy carries on instead
+*/
+template<typename List>
+static void matchesStdList(uint32_t seed) {
+	Random random(seed);
+	List list;
+	std::list<int> expected;
+	bool growing = true;
+	for (int i = 0; i < koperations; i++) {
+		int size = static_cast<int>(expected.size());
+		if (size >= kmax_size) {
+			growing = false;
+		} else if (size == 0) {
+			growing = true;
+		}
+		int operation = random.below(100);
+		int value = random.below(1000000);
+		if (operation < (growing ? 30 : 15)) {
+			list.push_back(value);
+			expected.push_back(value);
+		} else if (operation < (growing ? 60 : 30)) {
+			list.push_front(value);
+			expected.push_front(value);
+		} else if (operation < 70) {
+			list.pop_back();
+			if (!expected.empty()) {
+				expected.pop_back();
+			}
+		} else if (operation < 80) {
+			list.pop_front();
+			if (!expected.empty()) {
+				expected.pop_front();
+			}
+		} else if (operation < 97) {
+			int n = random.below(size + 4) - 2;
+			list.RemoveNth(n);
+			if (n >= 0 && n < size) {
+				expected.erase(std::next(expected.begin(), n));
+			}
+		} else if (operation < 98) {
+			list.clear();
+			expected.clear();
+		} else if (operation < 99) {
+			List copy(list);
+			list = copy;
+			if (!sameContents(copy, expected)) {
+				return;
+			}
+		} else {
+			List moved(std::move(list));
+			list = std::move(moved);
+		}
+		if (!sameContents(list, expected)) {
+			return;
+		}
+	}
+}
+
+void registerLinkedListTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"linked_list/matches_std_list", [] { matchesStdList<LinkedList<int>>(6); }});
+	tests.push_back(Test{"linked_list/pool_matches_std_list", [] {
+		matchesStdList<LinkedList<int, PoolAllocator<int>>>(7);
+	}});
+	tests.push_back(Test{"linked_list/unrolled_matches_std_list", [] { matchesStdList<UnrolledLinkedList<int>>(8); }});
+	tests.push_back(Test{"linked_list/unrolled_pool_matches_std_list", [] {
+		matchesStdList<UnrolledLinkedList<int, PoolAllocator<int>>>(9);
+	}});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
@@ -0,0 +1,112 @@
+#include <memory>
+#include <vector>
+#include "game_client.h"
+#include "game_server.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int kclients = 5;
+static const int klate_client_tick = 500; // The last client connects this far in, so it starts from a snapshot mid game
+static const long long kserver_ticks = 5000;
+static const int kmax_polls = 200; // A mirror that hasn't caught up after this many 10ms polls has lost a frame
+
+// Heads for the food along one axis at a time, running into itself often enough for restarts to be covered too
+static SnakeDirection towardsFood(Cell head, Cell food) {
+	if (food.x != head.x) {
+		return food.x > head.x ? RIGHT : LEFT;
+	}
+	return food.y > head.y ? DOWN : UP;
+}
+
+static bool sameColor(Color a, Color b) {
+	return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+// Everything a mirror holds against the server's game
+static bool sameGame(const GameMirror& mirror, const Simulation& game) {
+	const Snake& snake = game.getSnake();
+	const RingBuffer<Cell>& body = snake.getBody();
+	BoardSize board = game.getBoardSize();
+	if (!mirror.isSynced() || mirror.getBoardSize().columns != board.columns || mirror.getBoardSize().rows != board.rows ||
+		mirror.getState() != game.getState() || mirror.getTickCount() != game.getTickCount() ||
+		mirror.getScore() != snake.getFoodEaten() || !(mirror.getFood() == game.getFood().getCell()) ||
+		!sameColor(mirror.getFoodColor(), game.getFood().getColor()) || mirror.getBody().size() != body.size() ||
+		mirror.getBodyColors().size() != snake.getBodyColors().size()) {
+		return false;
+	}
+	for (size_t i = 0; i < body.size(); i++) {
+		if (!(mirror.getBody()[i] == body[i])) {
+			return false;
+		}
+	}
+	for (size_t i = 0; i < snake.getBodyColors().size(); i++) {
+		if (!sameColor(mirror.getBodyColors()[i], snake.getBodyColors()[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+A server on a loopback port with five clients, one of them playing (turning and restarting through the protocol)
+and one joining part way through the first game. After every tick each client polls until its mirror has caught up,
+and the mirror then has to equal the server's game in full. Polling without catching up means a frame went missing
+or was applied wrongly
+*/
+static void mirrorsMatchServer() {
+	GameServer server(640, 480, 1);
+	if (!SNAKE_CHECK(server.listen(0))) {
+		return;
+	}
+	std::vector<std::unique_ptr<GameClient>> clients;
+	int games = 1;
+	for (long long t = 0; t < kserver_ticks; t++) {
+		if (t == 0 || t == klate_client_tick) {
+			int connect = (t == 0) ? kclients - 1 : 1;
+			for (int i = 0; i < connect; i++) {
+				clients.emplace_back(new GameClient());
+				if (!SNAKE_CHECK(clients.back()->connect(server.getPort()))) {
+					return;
+				}
+			}
+			for (int polls = 0; server.getClientCount() < static_cast<int>(clients.size()) && polls < kmax_polls; polls++) {
+				server.poll(10);
+			}
+			if (!SNAKE_CHECK(server.getClientCount() == static_cast<int>(clients.size()))) {
+				return;
+			}
+		}
+
+		GameClient& player = *clients.front();
+		const GameMirror& seen = player.getGame();
+		if (seen.getState() == FINISHED) {
+			player.sendRestart();
+			games++;
+		} else {
+			player.sendTurn(towardsFood(seen.getBody().front(), seen.getFood()));
+		}
+		server.poll(0);
+		server.tick();
+
+		for (std::unique_ptr<GameClient>& client : clients) {
+			int polls = 0;
+			while (!sameGame(client->getGame(), server.getGame()) && polls < kmax_polls && client->poll(10) >= 0) {
+				polls++;
+			}
+			if (!SNAKE_CHECK(sameGame(client->getGame(), server.getGame()))) {
+				return;
+			}
+		}
+	}
+	SNAKE_CHECK(games > 2); // Restarts have to be part of what was checked
+	SNAKE_CHECK(server.getClientCount() == kclients);
+}
+
+void registerLoopbackTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"loopback/mirrors_match_server", mirrorsMatchServer});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
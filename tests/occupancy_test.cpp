@@ -0,0 +1,99 @@
+#include <vector>
+#include "game_types.h"
+#include "random.h"
+#include "snake.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const BoardSize kboard = {50, 40}; // The board of a 1000x800 window
+static const float ksquare_pixels = 20; // Square size of a 1000 pixel wide window
+static const int kgames = 2000;
+static const int kmax_ticks = 20000; // Ticks a game may last, long enough for the snake to fill much of the board
+static const int kfood_interval = 7; // The snake eats every this many ticks
+static const int krandom_turn_odds = 10; // The snake turns at random once every this many ticks on average
+
+/*
+Snake::isDead() as it was before the occupancy grid: the head is off the screen or its rectangle overlaps the
+rectangle of any other segment (ofRectangle::intersects(), which doesn't count touching edges), in pixels
+*/
+static bool rectangleScanIsDead(const Snake& snake) {
+	const RingBuffer<Cell>& body = snake.getBody();
+	float head_x = body[0].x * ksquare_pixels;
+	float head_y = body[0].y * ksquare_pixels;
+	if (head_x < 0 || head_y < 0 ||
+		head_x > kboard.columns * ksquare_pixels - ksquare_pixels ||
+		head_y > kboard.rows * ksquare_pixels - ksquare_pixels) {
+		return true;
+	}
+	for (size_t i = 1; i < body.size(); i++) {
+		float x = body[i].x * ksquare_pixels;
+		float y = body[i].y * ksquare_pixels;
+		if (head_x < x + ksquare_pixels && head_x + ksquare_pixels > x &&
+			head_y < y + ksquare_pixels && head_y + ksquare_pixels > y) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Turns away from whatever is ahead and now and then onto a free square at random, so games go on until the snake
+// boxes itself in and ends up running into a wall or into itself
+static void steer(Snake& snake, Random& random) {
+	SnakeDirection direction = snake.getDirection();
+	SnakeDirection sides[2] = {direction < 2 ? RIGHT : UP, direction < 2 ? LEFT : DOWN};
+	const OccupancyGrid& occupancy = snake.getOccupancy();
+	Cell ahead = neighbour(snake.getHeadCell(), direction);
+	if (occupancy.inBounds(ahead) && occupancy.count(ahead) == 0 && random.below(krandom_turn_odds) != 0) {
+		return;
+	}
+	int first = random.below(2);
+	for (int i = 0; i < 2; i++) {
+		Cell side = neighbour(snake.getHeadCell(), sides[(first + i) % 2]);
+		if (occupancy.inBounds(side) && occupancy.count(side) == 0) {
+			snake.setDirection(sides[(first + i) % 2]);
+			return;
+		}
+	}
+}
+
+// Long seeded random games, the grid and the rectangle scan have to agree on every tick
+static void matchesRectangleScan() {
+	Random random(2);
+	Snake snake(kboard);
+	int off_board = 0;
+	int ran_into_itself = 0;
+	for (int game = 0; game < kgames; game++) {
+		snake.reset(kboard);
+		for (int tick = 0; tick < kmax_ticks; tick++) {
+			steer(snake, random);
+			if (tick % kfood_interval == 0) {
+				snake.eatFood(Color(255, 0, 0));
+			}
+			snake.update();
+			bool dead = snake.isDead();
+			if (!SNAKE_CHECK(dead == rectangleScanIsDead(snake))) {
+				return;
+			}
+			if (dead) {
+				if (snake.getOccupancy().inBounds(snake.getHeadCell())) {
+					ran_into_itself++;
+				} else {
+					off_board++;
+				}
+				break;
+			}
+		}
+	}
+	// Both ways of dying have to come up for the comparison to mean anything
+	SNAKE_CHECK(off_board > 0);
+	SNAKE_CHECK(ran_into_itself > 0);
+}
+
+void registerOccupancyTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"occupancy/matches_rectangle_scan", matchesRectangleScan});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
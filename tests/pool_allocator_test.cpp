@@ -0,0 +1,131 @@
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "pool_allocator.h"
+#include "profiler.h"
+#include "random.h"
+#include "ref_ll.h"
+#include "test.h"
+#include "unrolled_ll.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+static const int kpool_objects = 3 * PoolAllocator<int>::kslab_objects + 5; // Spills into a fourth slab
+static const int klist_size = 1000;
+
+static std::vector<int> randomValues(Random& random, int count) {
+	std::vector<int> values;
+	for (int i = 0; i < count; i++) {
+		values.push_back(random.below(1000000));
+	}
+	return values;
+}
+
+/*
+A freed object is the next one handed out, recycle() hands out the same memory again in the same order without
+asking the heap for any, and release() gives the slabs back so the next allocation needs a new one
+*/
+static void recyclesAndReleases() {
+	if (!SNAKE_CHECK(Profiler::enabled())) {
+		return;
+	}
+	PoolAllocator<int> pool;
+	std::vector<int*> first;
+	for (int i = 0; i < kpool_objects; i++) {
+		first.push_back(pool.allocate(1));
+		*first.back() = i;
+	}
+	for (int i = 0; i < kpool_objects; i++) {
+		if (!SNAKE_CHECK(*first[i] == i)) {
+			return; // Two objects share memory
+		}
+	}
+
+	pool.deallocate(first[7], 1);
+	pool.deallocate(first[300], 1);
+	if (!SNAKE_CHECK(pool.allocate(1) == first[300]) || !SNAKE_CHECK(pool.allocate(1) == first[7])) {
+		return;
+	}
+
+	uint64_t allocations = Profiler::getThreadAllocations();
+	pool.recycle();
+	for (int i = 0; i < kpool_objects; i++) {
+		if (!SNAKE_CHECK(pool.allocate(1) == first[i])) {
+			return;
+		}
+	}
+	SNAKE_CHECK(Profiler::getThreadAllocations() - allocations == 0);
+
+	pool.release();
+	allocations = Profiler::getThreadAllocations();
+	pool.allocate(1);
+	SNAKE_CHECK(Profiler::getThreadAllocations() - allocations == 1);
+}
+
+/*
+Copies of a pooled list get a pool of their own, so clearing and refilling the source (which recycles its pool)
+must leave the copy as it was. Moves take the pool along with the nodes and leave an empty list that can be
+filled again. Once warmed up, clearing and refilling a list makes no allocation
+*/
+template<typename List>
+static void copiesAndMoves(uint32_t seed) {
+	if (!SNAKE_CHECK(Profiler::enabled())) {
+		return;
+	}
+	Random random(seed);
+	std::vector<int> values = randomValues(random, klist_size);
+	List source(values);
+
+	List copied(source);
+	List assigned;
+	assigned.push_back(1);
+	assigned = source;
+	std::vector<int> refill = randomValues(random, klist_size);
+	source.clear();
+	for (int value : refill) {
+		source.push_back(value);
+	}
+	if (!SNAKE_CHECK(copied.GetVector() == values) || !SNAKE_CHECK(assigned.GetVector() == values) ||
+		!SNAKE_CHECK(source.GetVector() == refill)) {
+		return;
+	}
+
+	List moved(std::move(copied));
+	List move_assigned;
+	move_assigned.push_back(1);
+	move_assigned = std::move(assigned);
+	if (!SNAKE_CHECK(moved.GetVector() == values) || !SNAKE_CHECK(move_assigned.GetVector() == values) ||
+		!SNAKE_CHECK(copied.empty()) || !SNAKE_CHECK(assigned.empty())) {
+		return;
+	}
+	copied.push_back(5);
+	assigned = moved;
+	moved.clear();
+	moved.push_back(6);
+	if (!SNAKE_CHECK(copied.GetVector() == std::vector<int>(1, 5)) || !SNAKE_CHECK(assigned.GetVector() == values) ||
+		!SNAKE_CHECK(moved.GetVector() == std::vector<int>(1, 6)) || !SNAKE_CHECK(move_assigned.GetVector() == values)) {
+		return;
+	}
+
+	uint64_t allocations = Profiler::getThreadAllocations();
+	for (int pass = 0; pass < 3; pass++) {
+		source.clear();
+		for (int value : values) {
+			source.push_back(value);
+		}
+	}
+	SNAKE_CHECK(Profiler::getThreadAllocations() - allocations == 0);
+	SNAKE_CHECK(source.GetVector() == values);
+}
+
+void registerPoolAllocatorTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"pool_allocator/recycle_and_release", recyclesAndReleases});
+	tests.push_back(Test{"pool_allocator/list_copy_move", [] { copiesAndMoves<LinkedList<int, PoolAllocator<int>>>(10); }});
+	tests.push_back(Test{"pool_allocator/unrolled_list_copy_move", [] {
+		copiesAndMoves<UnrolledLinkedList<int, PoolAllocator<int>>>(11);
+	}});
+}
+
+} // namespace test
+} // namespace snakelinkedlist
@@ -0,0 +1,39 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace snakelinkedlist {
+namespace test {
+
+/*
+Minimal test harness, laid out like the benchmarks. A test is a function that checks what it is testing with
+SNAKE_CHECK, a failed check is reported with its file and line and the test carries on, so one run shows every
+failure. Tests are grouped by the code they exercise and each group adds itself to the list.
+*/
+struct Test {
+	std::string name; // group/behaviour, e.g. occupancy/matches_rectangle_scan
+	std::function<void()> body;
+};
+
+// Reports a failed check and counts it against the running test, returns passed so loops can stop early
+bool check(bool passed, const char* expression, const char* file, int line);
+
+#define SNAKE_CHECK(expression) ::snakelinkedlist::test::check((expression), #expression, __FILE__, __LINE__)
+
+void registerOccupancyTests(std::vector<Test>& tests);
+void registerAllocationTests(std::vector<Test>& tests);
+void registerFlatStateTests(std::vector<Test>& tests);
+void registerBoardTests(std::vector<Test>& tests);
+void registerWindowTests(std::vector<Test>& tests);
+void registerBodyMeshTests(std::vector<Test>& tests);
+void registerLinkedListTests(std::vector<Test>& tests);
+void registerPoolAllocatorTests(std::vector<Test>& tests);
+void registerFoodTests(std::vector<Test>& tests);
+void registerLoopbackTests(std::vector<Test>& tests);
+void registerBatchTests(std::vector<Test>& tests);
+void registerLeaderboardTests(std::vector<Test>& tests);
+void registerGameThreadTests(std::vector<Test>& tests);
+
+} // namespace test
+} // namespace snakelinkedlist
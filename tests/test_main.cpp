@@ -0,0 +1,82 @@
+/*
+Snake tests
+
+Build and run on Linux (see Makefile):
+	make -C tests check
+
+Options:
+	--filter=TEXT       Only run tests whose name contains TEXT
+*/
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "test.h"
+
+using namespace snakelinkedlist::test;
+
+static const int kmax_reported = 10; // Failed checks printed per test, the rest are only counted
+static int failures = 0; // Failed checks in the running test
+
+namespace snakelinkedlist {
+namespace test {
+
+bool check(bool passed, const char* expression, const char* file, int line) {
+	if (!passed) {
+		if (failures < kmax_reported) {
+			printf("  %s:%d: check failed: %s\n", file, line, expression);
+		}
+		failures++;
+	}
+	return passed;
+}
+
+} // namespace test
+} // namespace snakelinkedlist
+
+int main(int argc, char** argv) {
+	std::string filter;
+	for (int i = 1; i < argc; i++) {
+		if (strncmp(argv[i], "--filter=", 9) == 0) {
+			filter = argv[i] + 9;
+		} else {
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	std::vector<Test> tests;
+	registerOccupancyTests(tests);
+	registerAllocationTests(tests);
+	registerFlatStateTests(tests);
+	registerBoardTests(tests);
+	registerWindowTests(tests);
+	registerBodyMeshTests(tests);
+	registerLinkedListTests(tests);
+	registerPoolAllocatorTests(tests);
+	registerFoodTests(tests);
+	registerLoopbackTests(tests);
+	registerBatchTests(tests);
+	registerLeaderboardTests(tests);
+	registerGameThreadTests(tests);
+
+	int run = 0;
+	int failed = 0;
+	for (const Test& test : tests) {
+		if (!filter.empty() && test.name.find(filter) == std::string::npos) {
+			continue;
+		}
+		failures = 0;
+		test.body();
+		printf("%s %s", failures == 0 ? "PASS" : "FAIL", test.name.c_str());
+		if (failures > 0) {
+			printf(" (%d failed checks)", failures);
+			failed++;
+		}
+		printf("\n");
+		fflush(stdout);
+		run++;
+	}
+	printf("%d of %d tests passed\n", run - failed, run);
+	return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#include <vector>
+#include "game_types.h"
+#include "simulation.h"
+#include "test.h"
+
+namespace snakelinkedlist {
+namespace test {
+
+// Sizes a window can report while it is minimised or being dragged, none may give an empty board
+static void boardNeverEmpty() {
+	const int sizes[][2] = {{0, 0}, {0, 800}, {1000, 0}, {-1, -1}, {1, 1}, {1000, 10}};
+	for (const int* size : sizes) {
+		BoardSize board = boardForWindow(size[0], size[1]);
+		SNAKE_CHECK(board.columns >= 1);
+		SNAKE_CHECK(board.rows >= 1);
+	}
+	BoardSize board = boardForWindow(1000, 800);
+	SNAKE_CHECK(board.columns == 50 && board.rows == 40);
+}
+
+// A game started after the window was minimised plays on the board of the window it had before
+static void minimisedWindowKeepsBoard() {
+	Simulation game(1000, 800, 1);
+	game.resize(0, 0);
+	game.reset(2);
+	SNAKE_CHECK(game.getBoardWidth() == 1000 && game.getBoardHeight() == 800);
+	SNAKE_CHECK(game.getBoardSize().columns == 50 && game.getBoardSize().rows == 40);
+}
+
+void registerWindowTests(std::vector<Test>& tests) {
+	tests.push_back(Test{"window/board_never_empty", boardNeverEmpty});
+	tests.push_back(Test{"window/minimised_window_keeps_board", minimisedWindowKeepsBoard});
+}
+
+} // namespace test
+} // namespace snakelinkedlist